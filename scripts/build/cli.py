@@ -5,6 +5,7 @@ from cli_deploy import deploy
 from cli_build import build
 from cli_test import test
 from cli_reset import reset
+from cli_load import load
 import argparse
 import os
 import sys
@@ -110,6 +111,30 @@ deploy_parser.add_argument("--vnc",
                             action="store_true")
 deploy_parser.set_defaults(fn=deploy)
 
+load_parser = subparsers.add_parser("load", help=f"run a master with simulated clients on the local host for hardware-free benchmarking")
+load_parser.add_argument("filename",
+                         help="source file to execute",
+                         nargs="?",
+                         default="main.blu")
+load_parser.add_argument("master_args",
+                         help="master program arguments",
+                         nargs="*",
+                         default=[])
+load_parser.add_argument("-n", "--num-clients",
+                         help="number of simulated clients to create",
+                         default=env.NUM_CLIENTS)
+load_parser.add_argument("-d", "--duration",
+                         help="seconds to run before stopping every process (runs until the master exits if unset)",
+                         type=float,
+                         default=None)
+load_parser.add_argument("-v", "--verbose",
+                         help="show client output",
+                         action="store_true")
+load_parser.add_argument("-t", "--trace",
+                         help="trace event latencies and dump per stage histograms from the master and clients (client dumps need -v)",
+                         action="store_true")
+load_parser.set_defaults(fn=load)
+
 build_parser = subparsers.add_parser("build", help=f"build {env.PROJECT_NAME} binaries or deployment images")
 build_parser.add_argument("make",
                           help="makefile arguments",
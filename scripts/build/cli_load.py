@@ -0,0 +1,43 @@
+import env
+from util import *
+import atexit
+import subprocess
+import sys
+from pathlib import Path
+from time import sleep
+
+def stop_processes(processes):
+    for process in processes:
+        if process.poll() is None:
+            process.terminate()
+    for process in processes:
+        try:
+            process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            process.kill()
+
+def load(args):
+    target_path = Path(".", get_target_dir(), env.RUNTIME_OUTPUT_DIRECTORY)
+    master_binary = Path(target_path, "master")
+    client_binary = Path(target_path, "client")
+    source = Path("samples", "src", args.filename)
+    output = None if args.verbose else subprocess.DEVNULL
+    trace = ["--trace"] if args.trace else []
+
+    processes = []
+    atexit.register(stop_processes, processes)
+
+    # clients must be listening before the master broadcasts for them (names match the deployment hostnames)
+    for i in range(int(args.num_clients)):
+        processes.append(subprocess.Popen([client_binary, f"blueshift-client-{i + 1}", "--simulate", *trace],
+                                          stdout=output, stderr=output))
+    sleep(.5)
+    master = subprocess.Popen([master_binary, source, *args.master_args, *trace])
+    processes.append(master)
+
+    try:
+        master.wait(timeout=args.duration)
+    except subprocess.TimeoutExpired:
+        pass
+    except KeyboardInterrupt:
+        sys.exit(0)
@@ -5,6 +5,7 @@
 #include "DynamicMessage.hpp"
 #include <memory>
 #include "FN_JOYSTICK.hpp"
+#include <pigpio.h>
 
 
 using namespace Device;
@@ -29,6 +30,9 @@ void FN_JOYSTICK::init(std::unordered_map<std::string, std::string> &config){
         throw std::invalid_argument("Device Init failed!");
     }
 
+    this->addADCChannel(this->xaxis_adc);
+    this->addADCChannel(this->yaxis_adc);
+
     gpioSetMode(this->zaxis_pin, PI_INPUT);
     gpioSetPullUpDown(this->zaxis_pin, PI_PUD_UP);
 }
@@ -37,7 +41,8 @@ void FN_JOYSTICK::init(std::unordered_map<std::string, std::string> &config){
 void FN_JOYSTICK::transmitStates(DynamicMessage &dmsg){
     states.x = this->adc->readByte(this->xaxis_adc);
     states.y = this->adc->readByte(this->yaxis_adc);
-    states.z = this->adc->readByte(this->zaxis_pin);
+    // The button is a pulled up gpio, pressing it grounds the pin
+    states.z = gpioRead(this->zaxis_pin) == 0;
 
     dmsg.packStates(states);
 }
@@ -5,6 +5,7 @@
 #include "DynamicMessage.hpp"
 #include <memory>
 #include "POTENTIOMETER.hpp"
+#include <pigpio.h>
 
 
 using namespace Device;
@@ -31,6 +32,8 @@ void POTENTIOMETER::init(std::unordered_map<std::string, std::string> &config){
         std::cout<<"INVALID ADC "<<std::endl;
         throw std::invalid_argument("Device Init failed!");
     }
+
+    this->addADCChannel(this->ADC_CHANNEL);
 }
 
 
@@ -5,6 +5,7 @@
 #include "DynamicMessage.hpp"
 #include <memory>
 #include "THERMISTOR.hpp"
+#include <pigpio.h>
 
 
 using namespace Device;
@@ -27,6 +28,8 @@ void THERMISTOR::init(std::unordered_map<std::string, std::string> &config){
         std::cout<<"INVALID ADC "<<std::endl;
         throw std::invalid_argument("Device Init failed!");
     }
+
+    this->addADCChannel(this->ADC_CHANNEL);
 }
 
 
@@ -1,9 +1,11 @@
 #include "Client.hpp"
 #include "Serialization.hpp"
+#include "LatencyTrace.hpp"
 #include "DeviceUtil.hpp"
 #include "ADC.hpp"
 #include "Connection.hpp"
 #include "Protocol.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <exception>
@@ -11,10 +13,17 @@
 #include <ostream>
 #include <stdexcept>
 #include <unordered_map>
-
-Client::Client(std::string c_name): bc_socket(client_ctx, udp::endpoint(udp::v4(), BROADCAST_PORT)), client_socket(client_ctx), threadPool(std::thread::hardware_concurrency()){
+#ifdef __RPI64__
+#include <pigpio.h>
+#endif
+
+Client::Client(std::string c_name, bool simulate): bc_socket(client_ctx), client_socket(client_ctx), threadPool(std::thread::hardware_concurrency()), simulate(simulate){
+    // Several clients may listen for the broadcast on one host (simulated load runs)
+    this->bc_socket.open(udp::v4()); 
+    this->bc_socket.set_option(boost::asio::socket_base::reuse_address(true)); 
+    this->bc_socket.bind(udp::endpoint(udp::v4(), BROADCAST_PORT)); 
     this->client_name = c_name; 
-    std::cout<<"Client Created: " << c_name <<std::endl; 
+    std::cout<<"Client Created: " << c_name << (simulate ? " (simulated)" : "") <<std::endl; 
 }
 
 void Client::start(){
@@ -140,10 +149,18 @@ void Client::listener(std::stop_token stoken){
         
             this->adc = std::make_shared<ADS7830>();
 
+            // The master grants the leases again after the configuration
+            for(auto& [alias, managed] : this->deviceList){
+                if(managed.leased){
+                    managed.leased = false; 
+                    managed.pendingRequests.currOwned = false; 
+                }
+            }
+
             for(int i = 0; i < size; i++){
                 try{      
                     std::cout<<"Emplacing: "<<device_alias[i]<<std::endl;
-                    deviceList.try_emplace(device_alias[i], device_types[i], srcs[i], this->adc);
+                    deviceList.try_emplace(device_alias[i], device_types[i], srcs[i], this->adc, this->simulate);
                     std::cout<<"Emplace device: "<<device_alias[i]<<std::endl;
                 }
                 catch(BlsExceptionClass& bec){
@@ -163,6 +180,9 @@ void Client::listener(std::stop_token stoken){
             std::cout<<"Client side handshake complete!"<<std::endl; 
 
         }
+        else if(ptype == Protocol::LOAD_PROGRAM){
+            this->loadProgram(dmsg); 
+        }
         else if(ptype == Protocol::STATE_CHANGE){
         
             if(this->curr_state == ClientState::IN_OPERATION){
@@ -180,10 +200,11 @@ void Client::listener(std::stop_token stoken){
                         std::cout<<"Tried to access a preowned device"<<std::endl; 
                         continue; 
                     }
-                    std::cout<<"Valid owner"<<std::endl; 
                 }
 
                 task_int task_id = inMsg.header.task_id;
+                auto trace = inMsg.header.trace; 
+                LatencyTracer::instance().record(trace, TraceStage::NETWORK_TO_CLIENT); 
 
                 if (deviceData.device.getDeviceKind() == DeviceKind::CURSOR) {
                     auto& cursorStrands = cursorViewStrands.at(dev_index);
@@ -192,12 +213,13 @@ void Client::listener(std::stop_token stoken){
                     }
                     auto& viewStrand = cursorStrands.at(task_id);
 
-                    boost::asio::post(viewStrand,  [task_id, dev_index, dmsg = std::move(dmsg), stoken, this](){
+                    boost::asio::post(viewStrand,  [task_id, dev_index, dmsg = std::move(dmsg), trace, this]() mutable {
                         try{   
                             auto& device = this->deviceList.at(dev_index).device;
                             cursors.at(dev_index).addQueryHandler(task_id);
                             device.processStates(dmsg);
-                            cursors.at(dev_index).awaitQueryCompletion(stoken);
+                            cursors.at(dev_index).completeQuery();
+                            LatencyTracer::instance().finish(trace, TraceStage::CLIENT_WRITE); 
                             this->sendMessage(dev_index, Protocol::DEVICE_CALLBACK, false, task_id);
                         }
                         catch(std::exception e){
@@ -209,10 +231,11 @@ void Client::listener(std::stop_token stoken){
                 else {
                     auto& deviceStrand = deviceStrands.at(dev_index);
     
-                    boost::asio::post(deviceStrand,  [task_id, dev_index, dmsg = std::move(dmsg), stoken, this](){
+                    boost::asio::post(deviceStrand,  [task_id, dev_index, dmsg = std::move(dmsg), stoken, trace, this]() mutable {
                         try{   
                             auto& device = this->deviceList.at(dev_index).device;
                             device.processStates(dmsg);
+                            LatencyTracer::instance().finish(trace, TraceStage::CLIENT_WRITE); 
                             this->sendMessage(dev_index, Protocol::DEVICE_CALLBACK, false, task_id);
                         }
                         catch(std::exception e){
@@ -246,16 +269,42 @@ void Client::listener(std::stop_token stoken){
             dmsg.unpack("__TICKER_UPDATE__", tickerUpdate); 
 
             for(Timer &new_timer : tickerUpdate){
-                if(!new_timer.const_poll){
-                    if(this->client_ticker.find(new_timer.id) == this->client_ticker.end()){
-                        std::cout<<"UH OH: "<<new_timer.id<<std::endl; 
+                auto poller = this->client_ticker.find(new_timer.id); 
+                if(poller != this->client_ticker.end()){
+                    if(!new_timer.const_poll){
+                        poller->second.get().setPeriod(new_timer.id, new_timer.period);
                     }
-                    this->client_ticker.at(new_timer.id).get().setPeriod(new_timer.id, new_timer.period);
+                    else{
+                        std::cerr<<"Constant poll not supposed to be sent by update protocol"<<std::endl; 
+                    }
+                    continue; 
+                }
+
+                // Timers the master added on a reload, set up like the initial ones
+                if(this->curr_state == ClientState::SHUTDOWN){
+                    continue; 
                 }
-                else{
-                    std::cerr<<"Constant poll not supposed to be sent by update protocol"<<std::endl; 
+                if(this->curr_state != ClientState::IN_OPERATION){
+                    start_timers[new_timer.device_num].push_back(new_timer);
+                    continue; 
                 }
 
+                auto deviceData = this->deviceList.find(new_timer.device_num); 
+                if(deviceData == this->deviceList.end()){
+                    continue; 
+                }
+                auto& device = deviceData->second.device;
+                if (!new_timer.const_poll && device.getDeviceKind() != DeviceKind::POLLING) {
+                    continue; // dont setup a dynamic polling timer if device is not a polling device
+                }
+
+                auto devPoller = std::ranges::find(pollers, static_cast<int>(new_timer.device_num), &DevicePoller::getDeviceCode);
+                if (devPoller == pollers.end()) {
+                    devPoller = pollers.emplace(pollers.end(), pollingWheel, device, client_connection, controller_alias, new_timer.device_num);
+                }
+                devPoller->createTimer(new_timer.id, new_timer.period);
+                this->client_ticker.emplace(new_timer.id, *devPoller);
+                devPoller->startTimers();
             }
 
         }
@@ -269,9 +318,9 @@ void Client::listener(std::stop_token stoken){
                 auto& device = this->deviceList.at(deviceNum).device;
                 auto deviceKind = device.getDeviceKind();
 
-                auto& poller = pollers.emplace_back(client_ctx, device, client_connection, controller_alias, deviceNum);
+                auto& poller = pollers.emplace_back(pollingWheel, device, client_connection, controller_alias, deviceNum);
                 for (auto&& timer : timerList) {
-                    if (timer.period == -1 && deviceKind != DeviceKind::POLLING) { // change condition to !isConst once dynamic polling subsystem is enabled
+                    if (!timer.const_poll && deviceKind != DeviceKind::POLLING) {
                         continue; // dont setup a dynamic polling timer if device is not a polling device
                     }
                     poller.createTimer(timer.id, timer.period);
@@ -290,7 +339,7 @@ void Client::listener(std::stop_token stoken){
                         deviceStrands.emplace(dev_id, boost::asio::make_strand(threadPool));
                     break;
                     case DeviceKind::INTERRUPT:
-                        this->interruptors.emplace_back(this->client_ctx, device, this->client_connection, this->controller_alias, dev_id);
+                        this->interruptors.emplace_back(this->client_ctx, this->interruptReactor, device, this->client_connection, this->controller_alias, dev_id);
                         deviceStrands.emplace(dev_id, boost::asio::make_strand(threadPool));
                     break;
                     case DeviceKind::CURSOR:
@@ -309,10 +358,7 @@ void Client::listener(std::stop_token stoken){
                 poller.startTimers();
             }
             for (auto&& interruptor : this->interruptors) {
-                interruptor.setupThreads();
-            }
-            for (auto&& [_, cursor] : this->cursors) {
-                cursor.initialize();
+                interruptor.setupWatchers();
             }
 
             #ifdef SDL_ENABLED
@@ -405,6 +451,13 @@ void Client::listener(std::stop_token stoken){
                 devPendStruct.currOwned = false; 
             }
         }
+        else if(ptype == Protocol::OWNER_LEASE){
+            // Devices with a single writer are owned for the lifetime of the program
+            auto& leasedDevice = this->deviceList.at(inMsg.header.device_code); 
+            leasedDevice.pendingRequests.currOwned = true; 
+            leasedDevice.leased = true; 
+            leasedDevice.owner = {inMsg.header.ctl_code, inMsg.header.task_id}; 
+        }
         else if(ptype == Protocol::PULL_REQUEST){
             int dev_index = inMsg.header.device_code; 
             int taskId = inMsg.header.task_id; 
@@ -419,6 +472,70 @@ void Client::listener(std::stop_token stoken){
     
 }
 
+void Client::loadProgram(DynamicMessage &dmsg){
+    std::string taskJson; 
+    std::vector<task_int> taskIds; 
+    std::string program; 
+    std::vector<std::string> devNames; 
+    std::vector<dev_int> devCodes; 
+    std::vector<dev_int> masterDevices; 
+
+    dmsg.unpack("__TASK_DESCS__", taskJson); 
+    dmsg.unpack("__TASK_IDS__", taskIds); 
+    dmsg.unpack("__BYTECODE__", program); 
+    dmsg.unpack("__DEV_NAMES__", devNames); 
+    dmsg.unpack("__DEV_CODES__", devCodes); 
+    if(dmsg.hasField("__MASTER_DEVICES__")){
+        dmsg.unpack("__MASTER_DEVICES__", masterDevices); 
+    }
+
+    if(devNames.size() != devCodes.size()){
+        throw std::invalid_argument("Program device vectors of different sizes"); 
+    }
+
+    auto localTasks = boost::json::value_to<std::vector<TaskDescriptor>>(boost::json::parse(taskJson)); 
+    std::vector<char> bytecode(program.begin(), program.end()); 
+    std::unordered_map<DeviceID, int> deviceMap; 
+    for(size_t i = 0; i < devNames.size(); i++){
+        deviceMap[devNames[i]] = devCodes[i]; 
+    }
+
+    // A repeated LOAD_PROGRAM replaces the running program, so nothing may still use the old router or EM
+    this->client_connection->setOutboundFilter(nullptr); 
+    if(this->clientEMThread.joinable()){
+        this->clientEMThread.request_stop(); 
+        this->clientEMThread.join(); 
+    }
+    this->loopbackQueue.clearQueue(); 
+
+    this->clientRouter = std::make_unique<ClientRouter>(this->loopbackQueue); 
+    for(auto& task : localTasks){
+        for(auto& dev : task.binded_devices){
+            this->clientRouter->addLocalRoute(deviceMap.at(dev.device_name)); 
+        }
+    }
+    for(auto dev : masterDevices){
+        this->clientRouter->addMasterRoute(dev); 
+    }
+
+    // Local writes go through the same path as the state changes sent by the master
+    this->clientEM = std::make_unique<ClientEM>(localTasks, taskIds, bytecode, this->loopbackQueue, [this](SentMessage sm){
+        OwnedSentMessage osm; 
+        osm.sm = std::move(sm); 
+        osm.connection = nullptr; 
+        this->in_queue.write(osm); 
+    }, deviceMap, this->controller_alias); 
+
+    this->client_connection->setOutboundFilter([this](const SentMessage& sm){
+        return this->clientRouter->route(sm); 
+    }); 
+    this->clientEMThread = std::jthread([this](std::stop_token stoken){
+        this->clientEM->run(stoken); 
+    }); 
+
+    std::cout<<"CLIENT: running "<<localTasks.size()<<" local tasks"<<std::endl; 
+}
+
 void Client::broadcastListen(){
     while(true){
         std::cout<<"CLIENT: waiting for client connection"<<std::endl; 
@@ -489,7 +606,7 @@ bool Client::disconnect(){
     std::cout<<"Socket Closed"<<std::endl;
 
 
-    // Kills the device interruptor and timer threads
+    // Unregisters the interrupt watchers and kills the timer threads
     interruptors.clear();
     std::cout<<"Interruptors killed"<<std::endl; 
 
@@ -498,11 +615,12 @@ bool Client::disconnect(){
     std::cout<<"Pollers killed"<<std::endl; 
 
     cursors.clear();
-    std::cout << "Cursor threads killed" << std::endl;
+    std::cout << "Cursors cleared" << std::endl;
     
     this->client_ctx.stop();
     this->threadPool.stop();
     this->listenerThread.request_stop();
+    this->clientEMThread.request_stop();
 
     std::cout<<"Context and client listener killed"<<std::endl;
 
@@ -3,6 +3,7 @@
 #include "Serialization.hpp"
 #include "DeviceUtil.hpp"
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -12,6 +13,8 @@
 #include "ADC.hpp"
 #include "Protocol.hpp"
 #include "Connection.hpp"
+#include "ClientGateway.hpp"
+#include "ClientRouter.hpp"
 #include <set> 
 #include <vector>
 
@@ -57,8 +60,10 @@ struct ManagedDevice {
     DeviceHandle device;
     ControllerQueue<ClientSideReq, ClientSideReqComp> pendingRequests;
     std::pair<cont_int, task_int> owner;  
-    ManagedDevice(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> targADC)
-                        : device(dtype, config, targADC) {}
+    // Owned by its sole writer until the master configures the client again
+    bool leased = false; 
+    ManagedDevice(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> targADC, bool simulate)
+                        : device(dtype, config, targADC, simulate) {}
 }; 
 
 class Client{
@@ -103,6 +108,8 @@ class Client{
 
         // client name used to identify controller
         std::string client_name; 
+        // Replaces every driver with a simulated device
+        bool simulate; 
         // Listens for incoming message and places it into the spot
         std::jthread listenerThread; 
         // use to keep track of the state 
@@ -126,15 +133,32 @@ class Client{
         /*
             State management information
         */
-        std::vector<DevicePoller> pollers;
+        // Declared before the pollers and interruptors, which unregister from them on destruction
+        // Runs every polling timer on client_ctx
+        PollingWheel pollingWheel{client_ctx, [this](std::vector<SentMessage> batch) { this->client_connection->sendBatch(std::move(batch)); }};
+        // Runs every interrupt watcher on client_ctx
+        InterruptReactor interruptReactor{client_ctx};
+        // Timers added on a reload create pollers while the others run, so they must not move
+        std::deque<DevicePoller> pollers;
         std::vector<DeviceInterruptor> interruptors;
         std::unordered_map<uint16_t, DeviceCursor> cursors;
         std::shared_ptr<ADS7830> adc;
 
+        /*
+            Tasks distributed to this controller
+        */
+        // States of local devices looped back to the local tasks
+        TSQ<SentMessage> loopbackQueue; 
+        std::unique_ptr<ClientRouter> clientRouter; 
+        std::unique_ptr<ClientEM> clientEM; 
+        std::jthread clientEMThread; 
+        // Starts the local tasks sent by the master
+        void loadProgram(DynamicMessage &dmsg); 
+
 
     public: 
         // Client constructor
-        Client(std::string name); 
+        Client(std::string name, bool simulate = false); 
         // Start the client (broadcast protocol + others)
         void start(); 
 
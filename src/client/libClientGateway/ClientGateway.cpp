@@ -1,31 +1,22 @@
 #include "ClientGateway.hpp"
 #include "Serialization.hpp"
 #include "DynamicMessage.hpp"
-#include "Scheduler.hpp"
 #include "Protocol.hpp"
 #include "bls_types.hpp"
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 #include <variant>
 #include <vector>
 
 
-ClientEM::ClientEM(std::vector<TaskDescriptor> &descList, TSQ<SentMessage> &readLine,
-    TSQ<SentMessage> &writeLine,std::unordered_map<DeviceID, int> data, int ctlCode)
-:   clientScheduler(descList, [](HeapMasterMessage){}), 
-    clientReadLine(readLine),
-    clientWriteLine(writeLine)
+ClientEM::ClientEM(std::vector<TaskDescriptor> &descList, std::vector<task_int> &taskIds, std::vector<char> &bytecode, 
+    TSQ<SentMessage> &readLine, ApplyState applyState, std::unordered_map<DeviceID, int> data, int ctlCode)
+:   clientReadLine(readLine),
+    applyState(std::move(applyState))
 {
-    int i = 0; 
-    for(auto& taskDesc : descList){
-        // Populate the in list: 
-        for(auto& dev : taskDesc.inDevices){
-            this->devToTaskMap[dev.device_name].push_back(taskDesc.name); 
-        }
-
-        this->ident_data.taskMap[taskDesc.name] = i; 
-        this->clientMap.emplace(taskDesc.name ,std::make_unique<ClientEU>(taskDesc, this->clientScheduler, writeLine, this->ident_data));
-        i++;  
+    if(descList.size() != taskIds.size()){
+        throw std::invalid_argument("Each client task requires a task id"); 
     }
 
     this->ctlCode = ctlCode; 
@@ -33,6 +24,18 @@ ClientEM::ClientEM(std::vector<TaskDescriptor> &descList, TSQ<SentMessage> &read
     for(auto& pair : this->ident_data.deviceMap){
         this->ident_data.intToDev[pair.second] = pair.first; 
     }
+
+    for(size_t i = 0; i < descList.size(); i++){
+        auto& taskDesc = descList.at(i); 
+        // Populate the device list: 
+        for(auto& dev : taskDesc.binded_devices){
+            this->devToTaskMap[dev.device_name].push_back(taskDesc.name); 
+        }
+
+        this->ident_data.taskMap[taskDesc.name] = taskIds.at(i); 
+        this->ident_data.intToTask[taskIds.at(i)] = taskDesc.name; 
+        this->clientMap.emplace(taskDesc.name, std::make_unique<ClientEU>(taskDesc, bytecode, this->applyState, this->ident_data, ctlCode));
+    }
 } 
 
 // Convert the sentMessage to a 
@@ -41,8 +44,11 @@ HeapMasterMessage ClientEM::getHMM(SentMessage &toConvert, PROTOCOLS pcol){
     DynamicMessage dm; 
     dm.Capture(toConvert.body); 
     hmm.heapTree = dm.toTree(); 
-    hmm.info.controller = toConvert.header.ctl_code; 
     hmm.info.device = this->ident_data.intToDev[toConvert.header.device_code]; 
+    if(this->ident_data.intToTask.contains(toConvert.header.task_id)){
+        hmm.info.task = this->ident_data.intToTask.at(toConvert.header.task_id); 
+    }
+    hmm.isInterrupt = toConvert.header.fromInterrupt; 
     hmm.protocol = pcol; 
 
     return hmm; 
@@ -51,51 +57,45 @@ HeapMasterMessage ClientEM::getHMM(SentMessage &toConvert, PROTOCOLS pcol){
 
 
 // Run the Exec Manager and Units
-void ClientEM::run(){
-    while(true){
-        auto message = this->clientReadLine.read();
+void ClientEM::run(std::stop_token stoken){
+    while(!stoken.stop_requested()){
+        auto readResult = this->clientReadLine.read(stoken);
+        if(!readResult.has_value()) return; 
+
+        auto& message = *readResult; 
+        PROTOCOLS pcol; 
         switch(message.header.prot){
-            case Protocol::SEND_STATE:{
-                // forward packet 
-                this->clientWriteLine.write(message); 
-                break; 
-            }
-            case Protocol::SEND_ARGUMENT: {
-                HeapMasterMessage hmm = getHMM(message, PROTOCOLS::SENDSTATES);
-                auto& transferList = this->devToTaskMap[hmm.info.device];
-                for(auto& task : transferList){
-                    this->clientMap[task]->insertDevice(hmm); 
-                }
+            case Protocol::SEND_STATE_INIT:
+            case Protocol::SEND_STATE: {
+                pcol = PROTOCOLS::SENDSTATES; 
                 break; 
             }
-            case Protocol::OWNER_GRANT : {
-                HeapMasterMessage hmm = getHMM(message, PROTOCOLS::OWNER_GRANT);
-                this->clientScheduler.receive(hmm); 
-                break; 
-            }
-            case Protocol::OWNER_CONFIRM_OK : {
-                HeapMasterMessage hmm = getHMM(message, PROTOCOLS::OWNER_CONFIRM_OK);
-                this->clientScheduler.receive(hmm);
+            case Protocol::DEVICE_CALLBACK: {
+                pcol = PROTOCOLS::CALLBACKRECIEVED; 
                 break; 
             }
             default: {
-                // Forward Packet
-                this->clientWriteLine.write(message); 
-                break; 
+                continue; 
             }
         }
+
+        HeapMasterMessage hmm = getHMM(message, pcol);
+        auto transferList = this->devToTaskMap.find(hmm.info.device); 
+        if(transferList == this->devToTaskMap.end()){
+            continue; 
+        }
+        for(auto& task : transferList->second){
+            this->clientMap.at(task)->insertDevice(hmm); 
+        }
     }
 }
 
 
-ClientEU::ClientEU(TaskDescriptor &taskDesc, DeviceScheduler &devSche, TSQ<SentMessage> &mainLine, IdentData &data)
-:EuCache(false, false, taskDesc.name, taskDesc), scheObj(devSche), clientMainLine(mainLine),
-idMaps(data)
+ClientEU::ClientEU(TaskDescriptor &taskDesc, std::vector<char> &bytecode, ApplyState &applyState, IdentData &data, int ctlCode)
+: taskInfo(taskDesc), triggerMan(taskDesc), applyState(applyState), idMaps(data), ctlCode(ctlCode)
 {   
-    virtualMachine.loadBytecode("PLACEHOLDER");
-    this->bytecodeOffset = taskDesc.bytecode_offset; 
-    this->name = taskDesc.name; 
-    this->taskInfo = taskDesc; 
+    this->virtualMachine.loadBytecode(bytecode);
+    this->virtualMachine.setTaskOffset(taskDesc.bytecode_offset); 
 
     int i = 0; 
     for(auto& devPos : taskDesc.binded_devices){
@@ -106,14 +106,17 @@ idMaps(data)
 
 
 void ClientEU::insertDevice(HeapMasterMessage hmm){
-    this->EuCache.insertState(hmm, this->reciever); 
-}
+    auto& devName = hmm.info.device; 
+    auto& devDesc = this->taskInfo.binded_devices.at(this->devPosMap.at(devName)); 
+    if(hmm.protocol == PROTOCOLS::CALLBACKRECIEVED && hmm.info.task == this->taskInfo.name && devDesc.ignoreWriteBacks){
+        return; 
+    }
 
-void ClientEU::replaceCache(std::unordered_map<DeviceID, HeapMasterMessage> &currArgs){
-    for(auto& pair:  currArgs){
-        if(this->replacementCache.contains(pair.first)){ 
-            currArgs[pair.first] = this->replacementCache.get(pair.first).value(); 
-        }
+    this->latestStates[devName] = hmm.heapTree; 
+
+    int triggerId; 
+    if(this->triggerMan.processDevice(devName, triggerId)){
+        this->execute(); 
     }
 }
 
@@ -122,8 +125,8 @@ SentMessage ClientEU::createSentMessage(BlsType &newData, DeviceDescriptor &devD
     SentMessage sm; 
     sm.header.ctl_code = this->ctlCode; 
     // We need to add the conversion factors
-    sm.header.device_code = this->idMaps.deviceMap[devDesc.device_name]; 
-    sm.header.task_id = this->idMaps.taskMap[this->taskInfo.name]; 
+    sm.header.device_code = this->idMaps.deviceMap.at(devDesc.device_name); 
+    sm.header.task_id = this->idMaps.taskMap.at(this->taskInfo.name); 
     sm.header.prot = pcode; 
     sm.header.body_size = 0;
 
@@ -138,45 +141,29 @@ SentMessage ClientEU::createSentMessage(BlsType &newData, DeviceDescriptor &devD
 }
 
 
-void ClientEU::run(){
-    while(true){
-        auto obj =this->reciever.read(); 
-        
-        // Make HMM map: 
-        std::unordered_map<DeviceID, HeapMasterMessage> heapMap; 
-        for(auto& hmm : obj.dmm_list){
-            heapMap[hmm.info.device] = hmm; 
-        }
-
-        // Open and close the packet flow-through valve while waiting for confirm_oks
-        this->EuCache.forwardPackets = true; 
-        this->scheObj.request(this->name, obj.priority);
-        this->EuCache.forwardPackets = false; 
-
-        this->replaceCache(heapMap); 
-
-        std::vector<BlsType> transformStates; 
-
-        for(auto& devDesc : this->taskInfo.binded_devices){
-            if(heapMap.contains(devDesc.device_name)){
-                transformStates.push_back((heapMap.at(devDesc.device_name).heapTree)); 
-            }
-            else{
-                transformStates.push_back(devDesc.initialValue); 
-            } 
+void ClientEU::execute(){
+    std::vector<BlsType> transformStates; 
+    int i = 0; 
+    for(auto& devDesc : this->taskInfo.binded_devices){
+        auto state = this->latestStates.contains(devDesc.device_name) ? this->latestStates.at(devDesc.device_name) : devDesc.initialValue; 
+        if(std::holds_alternative<std::shared_ptr<HeapDescriptor>>(state)){
+            // Stored states are reused by later runs, so the task works on a copy
+            auto desc = std::get<std::shared_ptr<HeapDescriptor>>(state)->clone();
+            desc->modified = false;
+            desc->index = i; 
+            state = std::move(desc);
         }
+        transformStates.push_back(state); 
+        i++; 
+    }
 
-        // Transformed object:
-        this->virtualMachine.setTaskOffset(this->bytecodeOffset);
-        auto transformedStates = this->virtualMachine.transform(transformStates);
-
-        // Transformed the object: 
-        for(auto& dev : this->taskInfo.outDevices){
-            this->clientMainLine.write(
-                createSentMessage(transformStates.at(this->devPosMap[dev.device_name]), dev, Protocol::SEND_STATE)  
-            ); 
-        }  
+    transformStates = this->virtualMachine.transform(transformStates);
+    auto& modifiedStates = this->virtualMachine.getModifiedStates(); 
 
-        this->scheObj.release(this->taskInfo.name); 
-    }
+    // Only the written devices are changed
+    for(auto& dev : this->taskInfo.outDevices){
+        size_t pos = this->devPosMap.at(dev.device_name); 
+        if(!modifiedStates.at(pos)) continue; 
+        this->applyState(createSentMessage(transformStates.at(pos), dev, Protocol::STATE_CHANGE)); 
+    }  
 }
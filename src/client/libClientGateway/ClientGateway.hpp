@@ -1,59 +1,62 @@
+#pragma once
+#include <functional>
 #include <memory>
+#include <stop_token>
 #include <unordered_map>
 #include <vector>
 #include "Serialization.hpp"
-#include "Scheduler.hpp"
 #include "TSQ.hpp"
-#include "Processing.hpp"
+#include "TriggerManager.hpp"
 #include "Protocol.hpp"
 #include "virtual_machine.hpp"
 #include "bls_types.hpp"
-#include "TSM.hpp"
+
+using task_int = uint16_t; 
 
 struct IdentData{
     std::unordered_map<TaskID, int> taskMap; 
+    std::unordered_map<int, TaskID> intToTask; 
     std::unordered_map<DeviceID, int> deviceMap; 
     std::unordered_map<int, DeviceID> intToDev; 
 }; 
 
-// Client side EU
+// Writes a state change to a device on this controller
+using ApplyState = std::function<void(SentMessage)>; 
+
+/*
+    Client side EU. Tasks are only distributed when they are the sole writers of their devices,
+    so they run without device ownership and their writes are applied directly to the devices.
+*/
 class ClientEU{
     private: 
         BlsLang::VirtualMachine virtualMachine; 
-        int bytecodeOffset; 
-        ReaderBox EuCache; 
-        TSQ<EMStateMessage> reciever; 
-        DeviceScheduler &scheObj; 
-        TaskID name; 
         TaskDescriptor taskInfo; 
-        TSM<DeviceID, HeapMasterMessage> replacementCache; 
-        TSQ<SentMessage> &clientMainLine; 
-        int ctlCode; 
+        TriggerManager triggerMan; 
+        // Latest state received from each binded device
+        std::unordered_map<DeviceID, BlsType> latestStates; 
         std::unordered_map<DeviceID, int> devPosMap; 
+        ApplyState &applyState; 
         IdentData &idMaps; 
-        
-        void replaceCache(std::unordered_map<DeviceID, HeapMasterMessage> &currentLoad); 
+        int ctlCode; 
+
+        void execute(); 
         
     public: 
-        ClientEU(TaskDescriptor &taskDesc, DeviceScheduler &scheObj, TSQ<SentMessage> &clientMainLine, 
-        IdentData &idData);
+        ClientEU(TaskDescriptor &taskDesc, std::vector<char> &bytecode, ApplyState &applyState, 
+        IdentData &idData, int ctlCode);
 
         void insertDevice(HeapMasterMessage heapDesc);
-        void run(); 
         SentMessage createSentMessage(BlsType &hdesc, DeviceDescriptor &devDesc, Protocol pcode);
 }; 
 
 class ClientEM{
     private: 
-        // Device to task list (using the in devices)
+        // Device to task list (using the binded devices)
         std::unordered_map<DeviceID, std::vector<TaskID>> devToTaskMap; 
 
-        // Add a loopback queue that is a heap descriptor by default
-        DeviceScheduler clientScheduler; 
+        // Loopback of the states sent by the devices on this controller
         TSQ<SentMessage> &clientReadLine; 
-        
-        // The connection outLine
-        TSQ<SentMessage> &clientWriteLine; 
+        ApplyState applyState; 
     
         int ctlCode; 
         std::unordered_map<TaskID, std::unique_ptr<ClientEU>> clientMap; 
@@ -64,13 +67,12 @@ class ClientEM{
     
     public: 
         ClientEM(std::vector<TaskDescriptor> &descList, 
+             std::vector<task_int> &taskIds, 
+             std::vector<char> &bytecode, 
              TSQ<SentMessage> &readLine, 
-             TSQ<SentMessage> &writeLine, 
+             ApplyState applyState, 
              std::unordered_map<DeviceID, int> deviceMap, 
              int ctlCode); 
 
-        void run(); 
+        void run(std::stop_token stoken); 
 }; 
-
-
-        
\ No newline at end of file
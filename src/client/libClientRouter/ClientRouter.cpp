@@ -20,3 +20,27 @@ void ClientRouter::createRoute(uint16_t device, std::vector<ControllerID>& contI
     this->pathing[device] = contID; 
 }
 
+void ClientRouter::addLocalRoute(dev_int device){
+    this->localRoutes.insert(device); 
+}
+
+void ClientRouter::addMasterRoute(dev_int device){
+    this->masterRoutes.insert(device); 
+}
+
+bool ClientRouter::route(const SentMessage& sm){
+    switch(sm.header.prot){
+        case Protocol::SEND_STATE_INIT:
+        case Protocol::SEND_STATE:
+        case Protocol::DEVICE_CALLBACK: {
+            dev_int device = sm.header.device_code; 
+            if(this->localRoutes.contains(device)){
+                this->loopbackQueue.write(sm); 
+            }
+            return this->masterRoutes.contains(device); 
+        }
+        default: {
+            return true; 
+        }
+    }
+}
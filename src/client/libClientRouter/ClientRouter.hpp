@@ -1,7 +1,9 @@
+#pragma once
 #include "Serialization.hpp"
 # include "Connection.hpp"
 #include "Protocol.hpp"
 #include <unordered_map>
+#include <unordered_set>
 
 using cont_int = uint16_t; 
 using dev_int = uint16_t; 
@@ -14,9 +16,16 @@ class ClientRouter{
         std::unordered_map<ControllerID, std::shared_ptr<Connection>> connectionMap; 
         TSQ<SentMessage> &loopbackQueue; 
         std::unordered_map<uint16_t, std::vector<ControllerID>> pathing; 
+        // Devices read by tasks running on this controller
+        std::unordered_set<dev_int> localRoutes; 
+        // Devices read by tasks running on the master
+        std::unordered_set<dev_int> masterRoutes; 
     public: 
         ClientRouter(TSQ<SentMessage> &loopBack); 
         void setConnection(ControllerID& targCont, std::shared_ptr<Connection> conObj);  
         void createRoute(uint16_t device, std::vector<ControllerID> &ctlGroup); 
-        void sendStates(uint16_t deviceCode, Protocol type, bool fromInt = false, task_int taskId = 0);
-}; 
\ No newline at end of file
+        void addLocalRoute(dev_int device); 
+        void addMasterRoute(dev_int device); 
+        // Loops device states back to local tasks and returns whether the master still needs the message
+        bool route(const SentMessage& sm); 
+}; 
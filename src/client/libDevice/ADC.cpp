@@ -0,0 +1,131 @@
+#include "ADC.hpp"
+#include <algorithm>
+#include <iostream>
+
+ADS7830::ADS7830() : ADS7830(nullptr) {
+    #ifdef __RPI64__
+    this->bus = std::make_unique<PigpioI2CBus>(1, 0x4B);
+    if(!isValid()){
+        std::cerr<<"Could not find ADC device on RPI 64!"<<std::endl;
+    }
+    #endif
+}
+
+ADS7830::ADS7830(std::unique_ptr<I2CBus> bus, std::chrono::microseconds conversionDelay, std::chrono::milliseconds sweepPeriod)
+    : bus(std::move(bus)), conversionDelay(conversionDelay), sweepPeriod(sweepPeriod) {}
+
+ADS7830::~ADS7830() {
+    stopSweeper();
+}
+
+uint8_t ADS7830::getCommand(int channel) {
+    return channels[channel];
+}
+
+int ADS7830::convert(int channel) {
+    if (this->bus->writeByte(channels[channel]) < 0) {
+        return this->readings[channel].load();
+    }
+    std::this_thread::sleep_for(this->conversionDelay);
+    int value = this->bus->readByte();
+    return value < 0 ? this->readings[channel].load() : value;
+}
+
+void ADS7830::sweep(std::stop_token stoken) {
+    auto next = std::chrono::steady_clock::now();
+    while (!stoken.stop_requested()) {
+        {
+            std::scoped_lock lk(this->busMutex);
+            uint8_t swept = this->sweptChannels.load();
+            for (int channel = 0; channel < ADC_CHANNELS && !stoken.stop_requested(); channel++) {
+                if (swept & (1 << channel)) {
+                    this->readings[channel].store(convert(channel));
+                }
+            }
+        }
+        this->sweeps.fetch_add(1);
+
+        // A sweep longer than the period starts the next one right away
+        std::unique_lock lk(this->periodMutex);
+        auto period = currentSweepPeriod();
+        next = std::max(next + period, std::chrono::steady_clock::now());
+        // A device that starts polling faster cuts the wait short
+        if (this->sweepCv.wait_until(lk, stoken, next, [this, period] { return currentSweepPeriod() < period; })) {
+            next = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+std::chrono::milliseconds ADS7830::currentSweepPeriod() {
+    std::chrono::milliseconds period = std::chrono::milliseconds::zero();
+    uint8_t swept = this->sweptChannels.load();
+    for (int channel = 0; channel < ADC_CHANNELS; channel++) {
+        auto channelPeriod = this->channelPeriods[channel];
+        if ((swept & (1 << channel)) && channelPeriod > std::chrono::milliseconds::zero()
+         && (period == std::chrono::milliseconds::zero() || channelPeriod < period)) {
+            period = channelPeriod;
+        }
+    }
+    return period == std::chrono::milliseconds::zero() ? this->sweepPeriod : period;
+}
+
+void ADS7830::addChannel(int channel) {
+    if (!isValid() || channel < 0 || channel >= ADC_CHANNELS) return;
+
+    if (this->sweptChannels.load() & (1 << channel)) return;
+    {
+        // First reading so the channel never reports a value it was not swept for
+        std::scoped_lock lk(this->busMutex);
+        if (this->sweptChannels.load() & (1 << channel)) return;
+        this->readings[channel].store(convert(channel));
+        this->sweptChannels.fetch_or(1 << channel);
+    }
+
+    std::scoped_lock lk(this->sweeperMutex);
+    if (!this->sweeper.joinable()) {
+        this->sweeper = std::jthread([this](std::stop_token stoken) { sweep(stoken); });
+    }
+}
+
+void ADS7830::setChannelPeriod(int channel, std::chrono::milliseconds period) {
+    if (channel < 0 || channel >= ADC_CHANNELS) return;
+    {
+        std::scoped_lock lk(this->periodMutex);
+        this->channelPeriods[channel] = std::max(period, std::chrono::milliseconds::zero());
+    }
+    this->sweepCv.notify_all();
+}
+
+std::chrono::milliseconds ADS7830::getSweepPeriod() {
+    std::scoped_lock lk(this->periodMutex);
+    return currentSweepPeriod();
+}
+
+int ADS7830::readByte(int fromChannel) {
+    if (!isValid() || fromChannel < 0 || fromChannel >= ADC_CHANNELS) return 0;
+    addChannel(fromChannel);
+    return this->readings[fromChannel].load();
+}
+
+uint64_t ADS7830::getSweepCount() {
+    return this->sweeps.load();
+}
+
+void ADS7830::stopSweeper() {
+    std::scoped_lock lk(this->sweeperMutex);
+    if (this->sweeper.joinable()) {
+        this->sweeper.request_stop();
+        this->sweeper.join();
+    }
+}
+
+void ADS7830::close() {
+    if (!isValid()) return;
+    stopSweeper();
+    std::scoped_lock lk(this->busMutex);
+    this->bus->close();
+}
+
+bool ADS7830::isValid() {
+    return this->bus && this->bus->isOpen();
+}
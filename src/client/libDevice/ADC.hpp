@@ -1,57 +1,80 @@
 #pragma once
 
-#ifdef __RPI64__
-#include <pigpio.h>
-#endif
-
+#include "I2CBus.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
-#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
 
+#define ADC_CHANNELS 8
+// Settle time between selecting a channel and reading the conversion
+#define ADC_CONVERSION_DELAY_US 1000
+// Sweep period while none of the swept channels is read by a polled device
+#define ADC_SWEEP_PERIOD_MS 10
 
 /* 
     Currently blueshift only supports the ADS7830 as an 
     ADC adaptor. More ADS will come soon with a virtual class
+
+    All analog devices of a controller share one ADC. Instead of every read going out
+    on the bus, a sweeper thread converts the channels the drivers registered in one
+    pass per sweep period and caches the readings, so reads return without touching
+    the bus and transactions of different devices never interleave. The sweep period
+    follows the fastest polling period of the devices reading the swept channels.
 */
 
 class ADS7830{
     private: 
-        int handle;
-        static constexpr uint8_t channels[8] = {  0x84, 0xC4, 0x94, 0xD4, 0xA4, 0xE4, 0xB4, 0xF4};
+        static constexpr uint8_t channels[ADC_CHANNELS] = {  0x84, 0xC4, 0x94, 0xD4, 0xA4, 0xE4, 0xB4, 0xF4};
+
+        std::unique_ptr<I2CBus> bus;
+        std::chrono::microseconds conversionDelay;
+        std::chrono::milliseconds sweepPeriod;
+        // Polling period of the device reading each channel, zero when it is not polled
+        std::array<std::chrono::milliseconds, ADC_CHANNELS> channelPeriods{};
+        // Guards the channel periods, the sweeper waits on it for a faster period
+        std::mutex periodMutex;
+        // Serializes bus transactions between the sweeper and first reads
+        std::mutex busMutex;
+        std::array<std::atomic<int>, ADC_CHANNELS> readings{};
+        // Bitmask of the channels in the sweep
+        std::atomic<uint8_t> sweptChannels = 0;
+        std::atomic<uint64_t> sweeps = 0;
+        // Guards starting and stopping the sweeper
+        std::mutex sweeperMutex;
+        std::condition_variable_any sweepCv;
+        std::jthread sweeper;
+
+        // Selects the channel and reads its conversion (called with busMutex held)
+        int convert(int channel);
+        void sweep(std::stop_token stoken);
+        // Shortest period of the swept channels (called with periodMutex held)
+        std::chrono::milliseconds currentSweepPeriod();
+        void stopSweeper();
     
     public:
-        ADS7830(){
-            this->handle = -1;
-            #ifdef __RPI64__
-            if(gpioInitialise() < 0){
-                std::cout<<"Failed to initialse GPIO for ADC detection"<<std::endl;
-            }
-
-            this->handle = i2cOpen(1, 0x4B, 0);
-            if(this->handle < 0){
-                std::cerr<<"Could not find ADC device on RPI 64!"<<std::endl;
-            }
-            #endif
-        }
-
-        int readByte(int fromChannel [[ maybe_unused ]]){
-            #ifdef __RPI64__
-            if(this->handle  != -1){
-                i2cWriteByte(this->handle, channels[fromChannel]);
-                gpioDelay(1000);
-                return i2cReadByte(this->handle);
-            }
-            #endif
-            return 0;
-        } 
-
-        void close(){
-            if (!isValid()) return;
-            #ifdef __RPI64__
-            i2cClose(this->handle);
-            #endif
-        }
-
-        bool isValid(){
-            return this->handle >= 0;
-        }
+        ADS7830();
+        // Used with a FakeI2CBus where there is no ADC
+        ADS7830(std::unique_ptr<I2CBus> bus, 
+            std::chrono::microseconds conversionDelay = std::chrono::microseconds(ADC_CONVERSION_DELAY_US), 
+            std::chrono::milliseconds sweepPeriod = std::chrono::milliseconds(ADC_SWEEP_PERIOD_MS));
+        ~ADS7830();
+
+        // Adds the channel to the sweep, drivers call this from init
+        void addChannel(int channel);
+        // Set by the poller of the device reading the channel, zero once it stops polling
+        void setChannelPeriod(int channel, std::chrono::milliseconds period);
+        std::chrono::milliseconds getSweepPeriod();
+        // Latest swept reading, only the first read of a channel that is not swept yet waits on the bus
+        int readByte(int fromChannel);
+        uint64_t getSweepCount();
+        static uint8_t getCommand(int channel);
+
+        void close();
+        bool isValid();
 }; 
@@ -0,0 +1,25 @@
+#include "AttributeVolatility.hpp"
+#include <algorithm>
+#include <cmath>
+
+AttributeVolatility::AttributeVolatility(size_t window)
+                                       : window(std::max<size_t>(window, 1))
+                                       , alpha(2.0 / (this->window + 1)) {}
+
+void AttributeVolatility::addSample(double value) {
+    count++;
+    double delta = value - mean;
+    if (count <= window) {
+        mean += delta / count;
+        variance += (delta * (value - mean) - variance) / count;
+    }
+    else {
+        double increment = alpha * delta;
+        mean += increment;
+        variance = (1 - alpha) * (variance + delta * increment);
+    }
+}
+
+double AttributeVolatility::getStd() const {
+    return std::sqrt(std::max(variance, 0.0));
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+    Streaming standard deviation of one numeric attribute, updated in O(1) per sample.
+    The first window samples are combined exactly with Welford's algorithm; after that
+    the mean and variance decay exponentially (alpha = 2 / (window + 1)) so the
+    volatility follows the recent behaviour of the device instead of its whole history.
+*/
+class AttributeVolatility {
+    public:
+        AttributeVolatility(size_t window);
+
+        void addSample(double value);
+        double getStd() const;
+        size_t getSampleCount() const { return count; }
+
+    private:
+        size_t window;
+        double alpha;
+        size_t count = 0;
+        double mean = 0;
+        double variance = 0;
+};
@@ -42,6 +42,17 @@ std::shared_ptr<HttpListener> DeviceCore<T>::addEndpointIWatch(std::string ep, s
     return king; 
 }
 
+template<Driveable T>
+void DeviceCore<T>::addSimulatedIWatch(std::function<std::chrono::milliseconds()> nextEvent, std::function<bool()> handler) {
+    this->Idesc_list.push_back(SimulatedInterruptor{nextEvent, handler});
+}
+
+template<Driveable T>
+void DeviceCore<T>::addADCChannel(int channel) {
+    this->adcChannels.push_back(channel);
+    this->adc->addChannel(channel);
+}
+
 template<Driveable T>
 void DeviceCore<T>::writeQueryResult(T& states) {
     std::pair<std::thread::id, T> queryResult = {std::this_thread::get_id(), states};
@@ -4,6 +4,7 @@
 #include "TSQ.hpp"
 #include "HttpListener.hpp"
 #include "typedefs.hpp"
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <functional>
@@ -41,11 +42,18 @@ struct HttpInterruptor{
     std::function<bool(int, std::string, std::string)> interruptCallback;  
 }; 
 
+// Fires after each delay returned by nextEvent, used by simulated devices
+struct SimulatedInterruptor {
+    std::function<std::chrono::milliseconds()> nextEvent;
+    std::function<bool()> interruptCallback;
+};
+
 
 using InterruptDescriptor = std::variant<
       UnixFileInterruptor
     , GpioInterruptor
     , HttpInterruptor
+    , SimulatedInterruptor
     #ifdef SDL_ENABLED
     , SdlIoInterruptor
     #endif
@@ -59,11 +67,27 @@ using InterruptDescriptor = std::variant<
 template<typename T>
 concept Driveable = TypeDef::DEVTYPE<T>;
 
+/*
+    What a driver's processStates must be kept apart from. Drivers declare a lighter
+    level by shadowing DeviceCore::processExclusion:
+        ALL         pause the device's watchers and timers and exclude transmitStates while the message is processed,
+                    so the device never reports its own writes (default)
+        TRANSMIT    only exclude the driver's transmitStates, watchers and timers keep running
+        NONE        the driver synchronizes its own states
+*/
+enum class ProcessExclusion : uint8_t {
+    ALL,
+    TRANSMIT,
+    NONE
+};
+
 template <Driveable T>
 class DeviceCore {
     private:
         std::vector<InterruptDescriptor> Idesc_list;
         TSQ<std::pair<std::thread::id, T>> queryQueue;
+        // ADC channels the driver reads, their sweep follows the device's polling period
+        std::vector<int> adcChannels;
     
     protected:
         T states;
@@ -76,9 +100,15 @@ class DeviceCore {
         void addSDLIWatch(std::function<bool(SDL_Event* event)> handler);
         #endif
         std::shared_ptr<HttpListener> addEndpointIWatch(std::string endpoint, std::function<bool(int, std::string, std::string)> omar); 
+        void addSimulatedIWatch(std::function<std::chrono::milliseconds()> nextEvent, std::function<bool()> handler);
+        // Adds the channel to the ADC sweep, drivers call this from init
+        void addADCChannel(int channel);
+        // Cursor drivers must write their result before processStates returns
         void writeQueryResult(T& states);
         T getLastQueryResult();
 
+        static constexpr ProcessExclusion processExclusion = ProcessExclusion::ALL;
+
 
         friend class DeviceHandle;
 }; 
\ No newline at end of file
@@ -1,14 +1,18 @@
 #include "DeviceUtil.hpp"
 #include "DeviceCore.hpp"
 #include "ADC.hpp"
+#include "LatencyTrace.hpp"
 #include "DynamicMessage.hpp"
 #include "Connection.hpp"
 #include "Protocol.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <iostream>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -29,15 +33,22 @@
 template<class... Ts>
 struct overloads : Ts... { using Ts::operator()...; };
 
-DeviceHandle::DeviceHandle(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> usingADC) 
+DeviceHandle::DeviceHandle(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> usingADC, bool simulate) 
 {
     switch(dtype){
-        #define DEVTYPE_BEGIN(name, ...) \
+        #define DEVTYPE_BEGIN(name, kind) \
         case TYPE::name: { \
-            this->device.emplace<Device::name>(); \
+            if (simulate) { \
+                this->device.emplace<SimulatedDevice<TypeDef::name>>(DeviceKind::kind); \
+            } \
+            else { \
+                this->device.emplace<Device::name>(); \
+                exclusion = Device::name::processExclusion; \
+            } \
             if (config.contains("cooldown")) { \
                 cooldown = std::stoul(config.at("cooldown")); \
             } \
+            sendPolicy = SendPolicy(config); \
             this->init(config, usingADC); \
             break; \
         }
@@ -66,11 +77,32 @@ void DeviceHandle::processStates(DynamicMessage dmsg) {
         return;
     }
 
+    switch (exclusion) {
+        case ProcessExclusion::NONE:
+            processStatesImpl(dmsg);
+            return;
+        case ProcessExclusion::TRANSMIT: {
+            std::scoped_lock lk(transmitMutex);
+            processStatesImpl(dmsg);
+            return;
+        }
+        case ProcessExclusion::ALL:
+        break;
+    }
+
     // notify watchers and timers that message processing is about to begin
     {
         std::unique_lock lk(m);
         cv.wait(lk, [this]{ return !processing; }); // wait for previous message to process completely
         processing = true;
+        if (setWatchersPaused) {
+            setWatchersPaused(true);
+            watchersPaused = true;
+        }
+        if (setTimersPaused) {
+            setTimersPaused(true);
+            timersPaused = true;
+        }
     }
     cv.notify_all();
 
@@ -78,8 +110,20 @@ void DeviceHandle::processStates(DynamicMessage dmsg) {
     {
         std::unique_lock lk(m);
         cv.wait(lk, [this]{ return watchersPaused && timersPaused; });
-        processStatesImpl(dmsg);
+        {
+            // signals posted before the pause may still be transmitting
+            std::scoped_lock tlk(transmitMutex);
+            processStatesImpl(dmsg);
+        }
         processing = false;
+        if (setWatchersPaused) {
+            setWatchersPaused(false);
+            watchersPaused = false;
+        }
+        if (setTimersPaused) {
+            setTimersPaused(false);
+            timersPaused = false;
+        }
     }
     cv.notify_all(); // notify all watchers and timers to re-enable
 }
@@ -97,12 +141,28 @@ void DeviceHandle::init(std::unordered_map<std::string, std::string> &config, st
 }
 
 void DeviceHandle::transmitStates(DynamicMessage &dmsg) {
+    std::unique_lock lk(transmitMutex, std::defer_lock);
+    if (exclusion != ProcessExclusion::NONE) {
+        lk.lock();
+    }
     std::visit(overloads {
         [](std::monostate&) {},
         [&dmsg](auto& dev) { dev.transmitStates(dmsg); }
     }, device);
 }
 
+void DeviceHandle::setPollPeriod(std::chrono::milliseconds period) {
+    std::visit(overloads {
+        [](std::monostate&) {},
+        [period](auto& dev) {
+            if (!dev.adc) return;
+            for (int channel : dev.adcChannels) {
+                dev.adc->setChannelPeriod(channel, period);
+            }
+        }
+    }, device);
+}
+
 void DeviceHandle::transmitDefaultStates(DynamicMessage &dmsg) {
     std::visit(overloads {
         [](std::monostate&) -> void { throw std::runtime_error("Attempt to access device kind for null device."); },
@@ -110,6 +170,10 @@ void DeviceHandle::transmitDefaultStates(DynamicMessage &dmsg) {
         [&dmsg](Device::name& dev [[ maybe_unused ]]) -> void { \
             auto fallback = TypeDef::name(); \
             dmsg.packStates(fallback); \
+        }, \
+        [&dmsg](SimulatedDevice<TypeDef::name>& dev [[ maybe_unused ]]) -> void { \
+            auto fallback = TypeDef::name(); \
+            dmsg.packStates(fallback); \
         },
         #define ATTRIBUTE(...)
         #define DEVTYPE_END
@@ -126,6 +190,9 @@ DeviceKind DeviceHandle::getDeviceKind() {
         #define DEVTYPE_BEGIN(name, kind) \
         [](Device::name& dev [[ maybe_unused ]]) -> DeviceKind { \
             return DeviceKind::kind; \
+        }, \
+        [](SimulatedDevice<TypeDef::name>& dev) -> DeviceKind { \
+            return dev.getKind(); \
         },
         #define ATTRIBUTE(...)
         #define DEVTYPE_END
@@ -143,15 +210,16 @@ std::vector<InterruptDescriptor>& DeviceHandle::getIdescList() {
     }, device);
 }
 
-std::optional<std::thread::id> DeviceHandle::getLatestCompletedHandlerId(std::stop_token stoken) {
+std::optional<std::thread::id> DeviceHandle::transmitQueryResult(DynamicMessage &dmsg) {
     return std::visit(overloads {
-        [](std::monostate&) -> std::optional<std::thread::id> { throw std::runtime_error("Attempt to access Idesc List for null device."); },
-        [&stoken](auto& dev) -> std::optional<std::thread::id> {
-            auto lastQueryResult = dev.queryQueue.peek(stoken);
-            if (lastQueryResult.has_value()) {
-                return lastQueryResult.value().first;
+        [](std::monostate&) -> std::optional<std::thread::id> { throw std::runtime_error("Attempt to access query results for null device."); },
+        [&dmsg](auto& dev) -> std::optional<std::thread::id> {
+            auto queryResult = dev.queryQueue.pop();
+            if (!queryResult.has_value()) {
+                return std::nullopt;
             }
-            return std::nullopt;
+            dmsg.packStates(queryResult.value().second);
+            return queryResult.value().first;
         }
     }, device);
 }
@@ -164,91 +232,34 @@ template class DeviceControlInterface<DevicePoller>;
 template class DeviceControlInterface<DeviceInterruptor>;
 template class DeviceControlInterface<DeviceCursor>;
 
-DevicePoller::DeviceTimer::DeviceTimer(uint16_t id, int period, boost::asio::io_context& ctx, DevicePoller& manager)
-                                     : id(id), poll_period(period), timer(ctx), manager(manager) {}
-
-std::chrono::milliseconds DevicePoller::DeviceTimer::getRemainingTime() {
-    auto now_time = std::chrono::steady_clock::now(); 
-    auto timer_exp = timer.expires_at();
-
-    if(now_time < timer_exp){
-        auto difference = timer_exp - now_time; 
-        return std::chrono::duration_cast<std::chrono::milliseconds>(difference);
-    }   
-    return std::chrono::milliseconds(0); 
-}
-
-float DevicePoller::DeviceTimer::calculateStd(std::deque<float> &data) {
-    // Calculate the sum first: 
-    float sum = 0; 
-    float std = 0; 
-    int size = data.size(); 
-
-    for(auto& i : data){
-        sum += i; 
-    }
-    float mean = sum/size; 
+DevicePoller::DeviceTimer::DeviceTimer(uint16_t id, int period)
+                                     : id(id), poll_period(period) {}
 
-    for(auto& i : data){
-        // Can never be negative as the difference is squared
-        std += pow(i - mean, 2); 
+void DevicePoller::DeviceTimer::addSamples(DynamicMessage &dmsg) {
+    std::unordered_map<std::string, double> numeric;
+    dmsg.getNumericFields(numeric);
+    for (auto&& [attr, value] : numeric) {
+        this->attr_volatility.try_emplace(attr, VOLATILITY_LIST_SIZE).first->second.addSample(value);
     }
-
-    return sqrt(std/size); 
 }
 
-void DevicePoller::DeviceTimer::calcVolMap() {
-    for(auto &pair : this->attr_history){
-        this->vol_map[pair.first] = calculateStd(pair.second);
-    }
-}
-
-void DevicePoller::DeviceTimer::timerCallback() {
-    this->timer.expires_after(this->period_time); 
-
-    this->timer.async_wait([this](const boost::system::error_code &ec){
-        if(!ec){
-            manager.sendMessage(*this); 
-            timerCallback(); 
+std::unordered_map<std::string, float> DevicePoller::DeviceTimer::getVolatilityUpdate() {
+    std::unordered_map<std::string, float> update;
+    for (auto&& [attr, volatility] : this->attr_volatility) {
+        float std = volatility.getStd();
+        auto reported = this->vol_map.find(attr);
+        if (reported == this->vol_map.end()
+         || std::abs(std - reported->second) > std::max<float>(VOLATILITY_REPORT_CHANGE * reported->second, VOLATILITY_REPORT_MIN)) {
+            this->vol_map[attr] = std;
+            update[attr] = std;
         }
-    }); 
-}
-
-void DevicePoller::DeviceTimer::setPeriod(int newPeriod) {
-    auto remTime = getRemainingTime();
-    this->period_time = std::chrono::milliseconds(newPeriod);
-
-    // If new intialization or if the newtime is less than the remaining time
-    if(this->period_time < remTime || this->poll_period == -1){
-
-        this->timer.cancel();
-
-        timerCallback();
-        
-        this->poll_period = newPeriod;
     }
-
-}
-
-void DevicePoller::DeviceTimer::start() {
-    this->period_time = std::chrono::milliseconds(this->poll_period);
-    this->timer.cancel();
-    timerCallback();
+    return update;
 }
 
-void DevicePoller::DeviceTimer::pause() {
-    this->period_time = getRemainingTime();
-    this->timer.cancel();
-}
-
-void DevicePoller::DeviceTimer::resume() {
-    timerCallback();
-    this->period_time = std::chrono::milliseconds(this->poll_period);
-}
-
-DevicePoller::DevicePoller(boost::asio::io_context &in_ctx, DeviceHandle& device, std::shared_ptr<Connection> cc, int ctl, int dev)
+DevicePoller::DevicePoller(PollingWheel& wheel, DeviceHandle& device, std::shared_ptr<Connection> cc, int ctl, int dev)
                          : DeviceControlInterface(device, cc, ctl, dev)
-                         , ctx(in_ctx) {}
+                         , wheel(wheel) {}
 
 DevicePoller::DevicePoller(DevicePoller&& other)
                          :
@@ -256,104 +267,129 @@ DevicePoller::DevicePoller(DevicePoller&& other)
                          , other.clientConnection
                          , other.ctl_code
                          , other.device_code)
-                         , ctx(other.ctx)
+                         , wheel(other.wheel)
 
 {
+    bool running = other.sourceId >= 0;
+    other.stopTimers();
     for (auto&& [id, timer] : other.timers) {
-        createTimer(id, timer.poll_period); // recreate timers other's timers to include reference to this
+        createTimer(id, timer.poll_period);
     }
-    if (other.timerManagerThread.joinable()) { // restart timers
+    if (running) { // move the wheel registration over to this poller
         startTimers();
     }
 }
 
 DevicePoller::~DevicePoller() {
-    if (timerManagerThread.joinable()) {
-        timerManagerThread.request_stop();
-        timerManagerThread.join();
-    }
+    this->stopTimers();
     this->timers.clear();
 }
 
-void DevicePoller::pauseTimers() {
-    for (auto&& [_, timer] : timers) {
-        timer.pause();
+void DevicePoller::setTimersPaused(bool paused) {
+    std::vector<uint16_t> missed;
+    {
+        std::scoped_lock lk(timerMutex);
+        this->paused = paused;
+        if (!paused) {
+            missed.assign(missedTimers.begin(), missedTimers.end());
+            missedTimers.clear();
+        }
+    }
+    if (!missed.empty()) {
+        this->wheel.signal(this->sourceId, std::move(missed));
     }
 }
 
-void DevicePoller::resumeTimers() {
-    for (auto&& [_, timer] : timers) {
-        timer.resume();
+void DevicePoller::onTimers(const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch) {
+    std::scoped_lock lk(timerMutex);
+    if (paused) {
+        missedTimers.insert(timerIds.begin(), timerIds.end());
+        return;
     }
+    this->createMessages(timerIds, batch);
 }
 
-void DevicePoller::manageTimers(std::stop_token stoken) {
-    auto& m = this->device.m;
-    auto& cv = this->device.cv;
-    auto& processing = this->device.processing;
-    auto& timersPaused = this->device.timersPaused;
-    timersPaused = false;
-    while (!stoken.stop_requested()) {
-        // wait for device to receive a new message to process then disable timers
-        {
-            std::shared_lock lk(m);
-            if (!cv.wait(lk, stoken, [&processing] { return processing; })) {
-                break; // break early to avoid unnecessary lock aquisition overhead
-            }
-            pauseTimers();
-            timersPaused = true;
-        }
-        cv.notify_all();
+void DevicePoller::createMessages(const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch) {
+    DynamicMessage states; 
+    auto trace = LatencyTracer::instance().begin(); 
+    this->device.transmitStates(states); 
+    LatencyTracer::instance().record(trace, TraceStage::CLIENT_READ); 
+    auto now = std::chrono::steady_clock::now(); 
 
-        // wait for message to process then re-enable timers
-        {
-            std::shared_lock lk(m);
-            if (!cv.wait(lk, stoken, [&processing] { return !processing; })) {
-                break; // break early to avoid unnecessary re-enabling
-            }
-            resumeTimers();
-            timersPaused = false;
+    for(auto timerId : timerIds){
+        auto found = this->timers.find(timerId); 
+        if(found == this->timers.end()){
+            continue; 
         }
-    }
-    pauseTimers();
-}
+        auto& timer = found->second; 
+        SentMessage smsg; 
+        DynamicMessage dmsg = states; 
 
-void DevicePoller::sendMessage(DeviceTimer& timer) {
-    SentMessage smsg; 
+        // Extract numerical data out the fields and add to the src: 
+        timer.addSamples(dmsg); 
 
-    DynamicMessage dmsg; 
-    this->device.transmitStates(dmsg); 
-
-    // Extract numerical data out the fields and add to the src: 
-    dmsg.getFieldVolatility(timer.attr_history); 
+        // Unchanged states are still sampled for volatility, only the send is skipped
+        if(!this->device.sendPolicy.shouldSend(dmsg, timer.lastSent, now)){
+            continue; 
+        }
 
-    if(timer.attr_history.size() > 0){
-        timer.calcVolMap(); 
-        dmsg.createField("__DEV_ATTR_VOLATILITY__", timer.vol_map); 
-    }
+        // The master keeps the last volatility of every attribute, so only the ones that moved are sent
+        auto volUpdate = timer.getVolatilityUpdate(); 
+        if(volUpdate.size() > 0){
+            dmsg.createField("__DEV_ATTR_VOLATILITY__", volUpdate); 
+        }
 
-    // Do some kind of data transformation here
-    smsg.body = dmsg.Serialize(); 
+        // Do some kind of data transformation here
+        smsg.body = dmsg.Serialize(); 
 
-    smsg.header.ctl_code = this->ctl_code; 
-    smsg.header.device_code = this->device_code; 
-    smsg.header.timer_id = timer.id; 
-    smsg.header.prot = Protocol::SEND_STATE; 
-    smsg.header.body_size = smsg.body.size(); 
-    smsg.header.fromInterrupt = false; 
-    smsg.header.kind = device.getDeviceKind(); 
+        smsg.header.ctl_code = this->ctl_code; 
+        smsg.header.device_code = this->device_code; 
+        smsg.header.timer_id = timer.id; 
+        smsg.header.prot = Protocol::SEND_STATE; 
+        smsg.header.body_size = smsg.body.size(); 
+        smsg.header.fromInterrupt = false; 
+        smsg.header.kind = device.getDeviceKind(); 
+        smsg.header.trace = trace; 
 
-    this->clientConnection->send(smsg);
+        batch.push_back(std::move(smsg)); 
+    }
 }
 
 void DevicePoller::setPeriod(uint16_t timerId, int newPeriod) {
     newPeriod = (newPeriod < 0) ? 1000 : newPeriod; // change all negative periods to 1000ms
-    timers.at(timerId).setPeriod(newPeriod);
+    {
+        std::scoped_lock lk(timerMutex);
+        timers.at(timerId).poll_period = newPeriod;
+    }
+    if (sourceId >= 0) {
+        wheel.setPeriod(sourceId, timerId, std::chrono::milliseconds(newPeriod));
+        updatePollPeriod();
+    }
+}
+
+void DevicePoller::updatePollPeriod() {
+    int period = -1;
+    {
+        std::scoped_lock lk(timerMutex);
+        for (auto&& [id, timer] : timers) {
+            if (period < 0 || timer.poll_period < period) {
+                period = timer.poll_period;
+            }
+        }
+    }
+    this->device.setPollPeriod(std::chrono::milliseconds(std::max(period, 0)));
 }
 
 void DevicePoller::createTimer(uint16_t timerId, int period) {
     period = (period < 0) ? 1000 : period; // change all negative periods to 1000ms
-    timers.try_emplace(timerId, timerId, period, ctx, *this);
+    {
+        std::scoped_lock lk(timerMutex);
+        timers.try_emplace(timerId, timerId, period);
+    }
+    if (sourceId >= 0) {
+        wheel.schedule(sourceId, timerId, std::chrono::milliseconds(period));
+        updatePollPeriod();
+    }
 }
 
 std::vector<uint16_t> DevicePoller::getTimerIds() {
@@ -361,15 +397,50 @@ std::vector<uint16_t> DevicePoller::getTimerIds() {
     return {ids.begin(), ids.end()};
 }
 
+int DevicePoller::getDeviceCode() const {
+    return this->device_code;
+}
+
 void DevicePoller::startTimers() {
-    timerManagerThread = std::jthread(std::bind(&DevicePoller::manageTimers, std::ref(*this), std::placeholders::_1));
-    for (auto&& [_, timer] : timers) {
-        timer.start();
+    if (sourceId >= 0) return;
+    sourceId = wheel.addSource([this](const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch) {
+        this->onTimers(timerIds, batch);
+    });
+
+    // Message processing pauses the timers so the device is not read while it is being written
+    {
+        std::unique_lock lk(this->device.m);
+        this->device.setTimersPaused = [this](bool paused) { this->setTimersPaused(paused); };
+        this->device.timersPaused = this->device.processing;
+        this->setTimersPaused(this->device.processing);
+    }
+    this->device.cv.notify_all();
+
+    for (auto&& [id, timer] : timers) {
+        wheel.schedule(sourceId, id, std::chrono::milliseconds(timer.poll_period));
     }
+    updatePollPeriod();
 }
 
-DeviceInterruptor::DeviceInterruptor(boost::asio::io_context &in_ctx, DeviceHandle& targDev, std::shared_ptr<Connection> conex, int ctl, int dd)
+void DevicePoller::stopTimers() {
+    if (sourceId < 0) return;
+    {
+        std::unique_lock lk(this->device.m);
+        this->device.cv.wait(lk, [this]{ return !this->device.processing; });
+        this->device.setTimersPaused = nullptr;
+        this->device.timersPaused = true;
+    }
+    this->device.cv.notify_all();
+
+    wheel.removeSource(sourceId);
+    sourceId = -1;
+    missedTimers.clear();
+    this->device.setPollPeriod(std::chrono::milliseconds::zero());
+}
+
+DeviceInterruptor::DeviceInterruptor(boost::asio::io_context &in_ctx, InterruptReactor& reactor, DeviceHandle& targDev, std::shared_ptr<Connection> conex, int ctl, int dd)
                                     : DeviceControlInterface(targDev, conex, ctl, dd)
+                                    , reactor(reactor)
                                     , cooldownTimer(in_ctx) {}
 
 DeviceInterruptor::DeviceInterruptor(DeviceInterruptor&& other)
@@ -378,16 +449,17 @@ DeviceInterruptor::DeviceInterruptor(DeviceInterruptor&& other)
                                     , other.clientConnection
                                     , other.ctl_code
                                     , other.device_code)
+                                    , reactor(other.reactor)
                                     , cooldownTimer(std::move(other.cooldownTimer))
 {
-    running = other.watcherManagerThread.joinable();
-    if (running) { // restart threads
-        this->setupThreads();
+    if (other.running) { // move the registrations over to this interruptor
+        other.stopWatchers();
+        this->setupWatchers();
     }
 }
 
 DeviceInterruptor::~DeviceInterruptor() {
-    this->stopThreads();
+    this->stopWatchers();
 }
 
 void DeviceInterruptor::restartCooldown() {
@@ -419,22 +491,28 @@ void DeviceInterruptor::sendMessage() {
     sm.header.volatility = 0; 
 
     DynamicMessage dmsg; 
+    sm.header.trace = LatencyTracer::instance().begin(); 
     this->device.transmitStates(dmsg); 
     sm.body = dmsg.Serialize(); 
+    LatencyTracer::instance().record(sm.header.trace, TraceStage::CLIENT_READ); 
 
     sm.header.body_size = sm.body.size() ; 
 
     this->clientConnection->send(sm); 
 }
 
+void DeviceInterruptor::onInterrupt() {
+    if (!inCooldown()) {
+        restartCooldown();
+        this->sendMessage();
+    }
+}
+
 void DeviceInterruptor::disableWatchers() {
     for (auto&& descriptor : watchDescriptors) {
         std::visit(overloads {
-            [](FileWatchDescriptor& desc) {
-                auto&& [fd, wd, filename] = desc;
-                #ifdef __linux__
-                inotify_rm_watch(fd, wd);
-                #endif
+            [this](FileWatchDescriptor& desc) {
+                this->reactor.pauseFileWatch(desc.sourceId);
             },
             [](GpioWatchDescriptor& desc [[ maybe_unused ]]) {
                 #ifdef __RPI64__
@@ -451,6 +529,10 @@ void DeviceInterruptor::disableWatchers() {
             [](HttpWatchDescriptor& desc){
                 auto&& [server, callback, endpoint] = desc;
                 server->removeHttpWatch(endpoint); 
+            },
+            [](SimulatedWatchDescriptor& desc) {
+                std::scoped_lock lk(desc.watch->m);
+                desc.watch->paused = true;
             }
         }, descriptor);
     }
@@ -459,15 +541,8 @@ void DeviceInterruptor::disableWatchers() {
 void DeviceInterruptor::enableWatchers() {
     for (auto&& descriptor : watchDescriptors) {
         std::visit(overloads {
-            [](FileWatchDescriptor& desc) {
-                auto&& [fd, wd, filename] = desc;
-                #ifdef __linux__
-                wd = inotify_add_watch(fd, filename.c_str(), IN_CLOSE_WRITE);
-                #endif
-                if(wd < 0){
-                    std::cerr<<"Could not add watcher"<<std::endl; 
-                    close(fd);
-                }
+            [this](FileWatchDescriptor& desc) {
+                this->reactor.resumeFileWatch(desc.sourceId);
             },
             [](GpioWatchDescriptor& desc [[ maybe_unused ]]) {
                 #ifdef __RPI64__
@@ -484,236 +559,182 @@ void DeviceInterruptor::enableWatchers() {
             [](HttpWatchDescriptor&desc){
                 auto&& [server, callback, endpoint] = desc; 
                 server->addHttpWatch(endpoint, callback);
+            },
+            [](SimulatedWatchDescriptor& desc) {
+                std::scoped_lock lk(desc.watch->m);
+                desc.watch->paused = false;
             }
 
         }, descriptor);
     }
 }
 
-void DeviceInterruptor::manageWatchers(std::stop_token stoken) {
-    auto& m = this->device.m;
-    auto& cv = this->device.cv;
-    auto& processing = this->device.processing;
-    auto& watchersPaused = this->device.watchersPaused;
-    watchersPaused = false;
-    while (!stoken.stop_requested()) {
-        // wait for device to receive a new message to process then disable watchers
-        {
-            std::shared_lock lk(m);
-            if (!cv.wait(lk, stoken, [&processing] { return processing; })) {
-                break; // break early to avoid unnecessary lock aquisition overhead
-            }
-            disableWatchers();
-            watchersPaused = true;
-        }
-        cv.notify_all();
-
-        // wait for message to process then re-enable watchers
-        {
-            std::shared_lock lk(m);
-            if (!cv.wait(lk, stoken, [&processing] { return !processing; })) {
-                break; // break early to avoid unnecessary re-enabling
-            }
-            enableWatchers();
-            watchersPaused = false;
-        }
-    }
-    disableWatchers();
-    running = false;
-    running.notify_all();
-}
-
-void DeviceInterruptor::IFileWatcher(std::stop_token stoken, std::string fname, std::function<bool()> handler){
-    // Check if the file exists relative to the deviceCore; 
-    #ifdef __linux__
-    int fd = inotify_init();
-
-    if(fd < 0){
-        std::cerr<<"Could not make Inotify object"<<std::endl; 
-        close(fd); 
-    }
-    // The IFileWatcher makes the call when the file is modified
-    int wd = inotify_add_watch(fd, fname.c_str(), IN_CLOSE_WRITE); 
-    if(wd < 0){
-        std::cerr<<"Could not perform an inotify event"<<std::endl; 
-        close(fd); 
-    }
-    watchDescriptors.push_back(FileWatchDescriptor{fd, wd, fname});
-
-    // For now we can bypass the metadata and store data for the filesize and stuff;
-    char event_buffer[sizeof(inotify_event) + 256]; 
-    while(!stoken.stop_requested()){
-        //std::cout<<"Waiting for event"<<std::endl;
-        int read_length [[ maybe_unused ]] = read(fd, event_buffer, sizeof(event_buffer)); 
-
-        auto* event = reinterpret_cast<struct inotify_event*>(event_buffer);
-        if (event->mask == IN_IGNORED) {
-            //std::cout << "drop removed watch event" << std::endl;
-            continue;
-        }
-         
-        if(handler() && !inCooldown()){
-            std::cerr<<"Sending message"<<std::endl;
-            restartCooldown();
-            this->sendMessage();  
+void DeviceInterruptor::IFileWatcher(std::string fname, std::function<bool()> handler){
+    // The reactor makes the call when the file is modified
+    int sourceId = this->reactor.addFileWatch(fname, [this, handler]() {
+        if (handler()) {
+            this->onInterrupt();
         }
+    });
+    if (sourceId < 0) {
+        return;
     }
-    running.wait(true); // terminate thread once watcher manager has shutdown
-    #endif
+    this->sourceIds.push_back(sourceId);
+    watchDescriptors.push_back(FileWatchDescriptor{sourceId});
 }
 
-void DeviceInterruptor::IGpioWatcher(std::stop_token stoken, int portNum, std::function<bool(int, int , uint32_t)> handler) {
-    std::condition_variable_any cv;
-    std::mutex m;
-    bool handlerSignal = false;
-    using callback_data = std::tuple<std::condition_variable_any&, std::mutex&, bool&, decltype(handler)&>;
-    callback_data callbackData = {cv, m, handlerSignal, handler};
+void DeviceInterruptor::IGpioWatcher(int portNum, std::function<bool(int, int , uint32_t)> handler) {
+    int sourceId = this->reactor.addSource([this]() { this->onInterrupt(); });
+    this->sourceIds.push_back(sourceId);
+    auto& callbackData = this->gpioCallbacks.emplace_back(
+        std::make_unique<CallbackData<decltype(handler)>>(this->reactor, sourceId, std::move(handler))
+    );
+    // Runs on the pigpio thread, only the state read happens there
     auto callback = [](int gpio, int level, unsigned int tick, void* callbackData) -> void {
-        auto& [cv, m, handlerSignal, handler] = *reinterpret_cast<callback_data*>(callbackData);
-        {
-            std::unique_lock lk(m);
-            cv.wait(lk, [&handlerSignal](){ return !handlerSignal; });
-            handlerSignal = handler(gpio, level, tick);
+        auto& [reactor, sourceId, handler] = *reinterpret_cast<CallbackData<std::function<bool(int, int, uint32_t)>>*>(callbackData);
+        if (handler(gpio, level, tick)) {
+            reactor.signal(sourceId);
         }
-        cv.notify_all();
     };
-    watchDescriptors.push_back(GpioWatchDescriptor{portNum, callback, &callbackData});
+    watchDescriptors.push_back(GpioWatchDescriptor{portNum, callback, callbackData.get()});
 
     #ifdef __RPI64__
-    gpioSetAlertFuncEx(portNum, callback, &callbackData);
+    gpioSetAlertFuncEx(portNum, callback, callbackData.get());
     #endif
-
-    while (!stoken.stop_requested()) {
-        std::unique_lock lk(m);
-        if (cv.wait(lk, stoken, [&handlerSignal] { return handlerSignal; })) {
-            if (!inCooldown()) {
-                restartCooldown();
-                this->sendMessage();
-            }
-            handlerSignal = false;
-        }
-        cv.notify_one();
-    }
-    running.wait(true); // terminate thread once watcher manager has shutdown
 }
 
 #ifdef SDL_ENABLED
-void DeviceInterruptor::ISdlWatcher(std::stop_token stoken, std::function<bool(SDL_Event*)> handler) {
-    std::condition_variable_any cv;
-    std::mutex m;
-    bool handlerSignal = false;
-    using callback_data = std::tuple<std::condition_variable_any&, std::mutex&, bool&, decltype(handler)&>;
-    callback_data callbackData = {cv, m, handlerSignal, handler};
+void DeviceInterruptor::ISdlWatcher(std::function<bool(SDL_Event*)> handler) {
+    int sourceId = this->reactor.addSource([this]() { this->onInterrupt(); });
+    this->sourceIds.push_back(sourceId);
+    auto& callbackData = this->sdlCallbacks.emplace_back(
+        std::make_unique<CallbackData<decltype(handler)>>(this->reactor, sourceId, std::move(handler))
+    );
     auto callback = [](void* callbackData, SDL_Event* event) -> bool {
-        auto& [cv, m, handlerSignal, handler] = *reinterpret_cast<callback_data*>(callbackData);
-        {
-            std::unique_lock lk(m);
-            cv.wait(lk, [&handlerSignal](){ return !handlerSignal; });
-            handlerSignal = handler(event);
+        auto& [reactor, sourceId, handler] = *reinterpret_cast<CallbackData<std::function<bool(SDL_Event*)>>*>(callbackData);
+        bool handlerSignal = handler(event);
+        if (handlerSignal) {
+            reactor.signal(sourceId);
         }
-        cv.notify_all();
         return handlerSignal;
     };
 
-    if (!SDL_AddEventWatch(callback, &callbackData)) {
+    if (!SDL_AddEventWatch(callback, callbackData.get())) {
         throw BlsExceptionClass("Failed to add SDL event watch: " + std::string(SDL_GetError()), ERROR_T::DEVICE_FAILURE);
     }
 
-    watchDescriptors.push_back(SdlWatchDescriptor{callback, &callbackData});
-    
-    while (!stoken.stop_requested()) {
-        std::unique_lock lk(m);
-        if (cv.wait(lk, stoken, [&handlerSignal] { return handlerSignal; })) {
-            if (!inCooldown()) {
-                restartCooldown();
-                this->sendMessage();
-            }
-            handlerSignal = false;
-        }
-        cv.notify_one();
-    }
-    running.wait(true); // terminate thread once watcher manager has shutdown
+    watchDescriptors.push_back(SdlWatchDescriptor{callback, callbackData.get()});
 }
 #endif
 
-void DeviceInterruptor::IHttpWatcher(std::stop_token stoken, std::shared_ptr<HttpListener> server, std::string endpoint, std::function<bool(int64_t, std::string, std::string)> handler){
-    std::condition_variable_any cv;  
-    std::mutex m; 
-    bool handlerSignal = false; 
-    int s_id = 0; 
-    auto callback = [&handlerSignal, &cv, &m, &handler, &s_id](int64_t sessionID, std::string ip, std::string json){
-        {
-            std::unique_lock lk(m);
-            cv.wait(lk, [&handlerSignal](){return !handlerSignal; }); 
-            s_id = sessionID; 
-            handlerSignal = handler(sessionID, ip, json); 
-
+void DeviceInterruptor::IHttpWatcher(std::shared_ptr<HttpListener> server, std::string endpoint, std::function<bool(int64_t, std::string, std::string)> handler){
+    int sourceId = this->reactor.addSource([this]() { this->onInterrupt(); });
+    this->sourceIds.push_back(sourceId);
+    auto callback = [&reactor = this->reactor, sourceId, handler](int64_t sessionID, std::string ip, std::string json){
+        bool handlerSignal = handler(sessionID, ip, json); 
+        if (handlerSignal) {
+            reactor.signal(sourceId);
         }
-
-        cv.notify_all(); 
         return handlerSignal;
     }; 
 
     server->addHttpWatch(endpoint, callback);
 
     watchDescriptors.push_back(HttpWatchDescriptor{.listener = server, .callback = callback, .endpoint = endpoint}); 
+}
 
-    while (!stoken.stop_requested()) {
-        std::unique_lock lk(m);
-        if (cv.wait(lk, stoken, [&handlerSignal] { return handlerSignal; })) {
-            if (!inCooldown()) {
-                restartCooldown();
-                this->sendMessage();
-            }
-            handlerSignal = false;
+void DeviceInterruptor::ISimulatedWatcher(std::function<std::chrono::milliseconds()> nextEvent, std::function<bool()> handler) {
+    auto watch = std::make_shared<SimulatedWatch>(boost::asio::steady_timer(this->cooldownTimer.get_executor()), std::move(nextEvent));
+    // Events run on the client context like the other watchers
+    watch->onEvent = [this, handler]() {
+        if (handler()) {
+            this->onInterrupt();
         }
-        cv.notify_one();
-    }
-    running.wait(true); // terminate thread once watcher manager has shutdown
+    };
+    std::scoped_lock lk(watch->m);
+    armSimulatedWatch(watch);
+    watchDescriptors.push_back(SimulatedWatchDescriptor{watch});
+}
+
+void DeviceInterruptor::armSimulatedWatch(std::shared_ptr<SimulatedWatch> watch) {
+    watch->timer.expires_after(watch->nextEvent());
+    watch->timer.async_wait([watch](const boost::system::error_code& ec) {
+        std::scoped_lock lk(watch->m);
+        if (ec || watch->stopped) {
+            return;
+        }
+        // events raised while paused are dropped
+        if (!watch->paused) {
+            watch->onEvent();
+        }
+        armSimulatedWatch(watch);
+    });
 }
 
     
-void DeviceInterruptor::setupThreads() {
+void DeviceInterruptor::setupWatchers() {
     for(auto& idesc : this->device.getIdescList()){
         std::visit(overloads {
             [this](UnixFileInterruptor& idesc) {
-                this->globalWatcherThreads.emplace_back(
-                    std::bind(&DeviceInterruptor::IFileWatcher, std::ref(*this), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-                    idesc.file, idesc.interruptCallback
-                );
+                this->IFileWatcher(idesc.file, idesc.interruptCallback);
             },
             [this](GpioInterruptor& idesc) {
-                this->globalWatcherThreads.emplace_back(
-                    std::bind(&DeviceInterruptor::IGpioWatcher, std::ref(*this), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-                    idesc.portNum, idesc.interruptCallback
-                );
+                this->IGpioWatcher(idesc.portNum, idesc.interruptCallback);
             },
             #ifdef SDL_ENABLED
             [this](SdlIoInterruptor& idesc) {
-                this->globalWatcherThreads.emplace_back(
-                    std::bind(&DeviceInterruptor::ISdlWatcher, std::ref(*this), std::placeholders::_1, std::placeholders::_2),
-                    idesc.interruptCallback
-                );
+                this->ISdlWatcher(idesc.interruptCallback);
             },
             #endif
             [this](HttpInterruptor &idesc){
-                this->globalWatcherThreads.emplace_back(
-                    std::bind(&DeviceInterruptor::IHttpWatcher, std::ref(*this), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
-                    idesc.server, idesc.endpoint, idesc.interruptCallback
-                );
+                this->IHttpWatcher(idesc.server, idesc.endpoint, idesc.interruptCallback);
+            },
+            [this](SimulatedInterruptor& idesc) {
+                this->ISimulatedWatcher(idesc.nextEvent, idesc.interruptCallback);
             }
             
         }, idesc);
     }
-    watcherManagerThread = std::jthread(std::bind(&DeviceInterruptor::manageWatchers, std::ref(*this), std::placeholders::_1));
+
+    // Message processing pauses the watchers so the device does not report its own writes
+    {
+        std::unique_lock lk(this->device.m);
+        this->device.setWatchersPaused = [this](bool paused) {
+            paused ? this->disableWatchers() : this->enableWatchers();
+        };
+        this->device.watchersPaused = false;
+    }
+    running = true;
 }
 
-void DeviceInterruptor::stopThreads() {
-    for (auto&& watcher : globalWatcherThreads) {
-        watcher.request_stop();
+void DeviceInterruptor::stopWatchers() {
+    if (!running) return;
+    {
+        std::unique_lock lk(this->device.m);
+        this->device.cv.wait(lk, [this]{ return !this->device.processing; });
+        this->device.setWatchersPaused = nullptr;
+        this->device.watchersPaused = true;
+    }
+    this->device.cv.notify_all();
+
+    disableWatchers();
+    for (auto&& descriptor : this->watchDescriptors) {
+        if (auto* desc = std::get_if<SimulatedWatchDescriptor>(&descriptor)) {
+            std::scoped_lock lk(desc->watch->m);
+            desc->watch->stopped = true;
+            desc->watch->timer.cancel();
+        }
     }
-    watcherManagerThread.request_stop();
-    globalWatcherThreads.clear();
+    for (int sourceId : this->sourceIds) {
+        this->reactor.removeSource(sourceId);
+    }
+    this->sourceIds.clear();
+    this->watchDescriptors.clear();
+    this->gpioCallbacks.clear();
+    #ifdef SDL_ENABLED
+    this->sdlCallbacks.clear();
+    #endif
+    running = false;
 }
 
 DeviceCursor::DeviceCursor(DeviceHandle& device, std::shared_ptr<Connection> clientConnection, int ctl_code, int device_code)
@@ -724,41 +745,24 @@ DeviceCursor::DeviceCursor(DeviceCursor&& other)
     DeviceControlInterface(other.device
                           , other.clientConnection
                           , other.ctl_code
-                          , other.device_code)
-{
-    bool wasRunning = other.queryWatcherThread.joinable();
-    other.queryWatcherThread.request_stop();
-    if (wasRunning) {
-        this->initialize();
-    }
-}
-
-DeviceCursor::~DeviceCursor() {
-    this->queryWatcherThread.request_stop();
-}
-
-void DeviceCursor::queryWatcher(std::stop_token stoken) {
-    while (!stoken.stop_requested()) {
-        auto lastCompletedHandler = device.getLatestCompletedHandlerId(stoken);
-        if (!lastCompletedHandler.has_value()) {
-            break; // stop requested, end watcher
+                          , other.device_code) {}
+
+// Concurrent queries may finish in any order, so each result goes to the task of the thread that produced it
+void DeviceCursor::collectResults() {
+    while (true) {
+        DynamicMessage dmsg;
+        auto handlerId = this->device.transmitQueryResult(dmsg);
+        if (!handlerId.has_value()) {
+            return;
+        }
+        auto query = pendingQueries.find(handlerId.value());
+        if (query != pendingQueries.end()) {
+            currentViews.insert(query->second, dmsg);
+            pendingQueries.erase(query);
         }
-        auto handlerId = lastCompletedHandler.value();
-        updateView(queryHandlers.get(handlerId).value());
-        queryHandlers.remove(handlerId); // signals query completion
     }
 }
 
-void DeviceCursor::updateView(uint16_t taskId) {
-    DynamicMessage dmsg;
-    this->device.transmitStates(dmsg);
-    currentViews.insert(taskId, dmsg);
-}
-
-void DeviceCursor::initialize() {
-    queryWatcherThread = std::jthread(std::bind(&DeviceCursor::queryWatcher, std::ref(*this), std::placeholders::_1));
-}
-
 DynamicMessage DeviceCursor::getLatestTaskView(uint16_t taskId) {
     auto dmsg = currentViews.get(taskId);
     if (!dmsg.has_value()) {
@@ -769,15 +773,19 @@ DynamicMessage DeviceCursor::getLatestTaskView(uint16_t taskId) {
 }
 
 void DeviceCursor::addQueryHandler(uint16_t taskId) {
-    auto handlerId = std::this_thread::get_id();
-    queryHandlers.insert(handlerId, taskId);
+    std::scoped_lock lk(queryMutex);
+    pendingQueries[std::this_thread::get_id()] = taskId;
 }
 
-void DeviceCursor::awaitQueryCompletion(std::stop_token stoken) {
-    auto handlerId = std::this_thread::get_id();
-    while (!stoken.stop_requested()) {
-        if (!queryHandlers.contains(handlerId)) {
-            return; // this function should not be waiting that long so its ok to busy wait
-        }
+bool DeviceCursor::completeQuery() {
+    std::scoped_lock lk(queryMutex);
+    collectResults();
+    // results are collected eagerly, so a query still pending here never wrote one
+    auto query = pendingQueries.find(std::this_thread::get_id());
+    if (query == pendingQueries.end()) {
+        return true;
     }
+    std::cerr << "Cursor query of task " << query->second << " returned without a result" << std::endl;
+    pendingQueries.erase(query);
+    return false;
 }
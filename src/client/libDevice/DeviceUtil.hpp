@@ -2,10 +2,15 @@
 
 #include "DynamicMessage.hpp"
 #include "ADC.hpp"
+#include "AttributeVolatility.hpp"
 #include "TSM.hpp"
 #include "Protocol.hpp"
 #include "Devices.hpp"
 #include "HttpListener.hpp"
+#include "InterruptReactor.hpp"
+#include "PollingWheel.hpp"
+#include "SendPolicy.hpp"
+#include "SimulatedDevice.hpp"
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -14,6 +19,9 @@
 #include <chrono> 
 #include "Connection.hpp"
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <shared_mutex>
 #include <stop_token>
 #include <tuple>
@@ -29,6 +37,10 @@
 
 
 #define VOLATILITY_LIST_SIZE 10
+// Relative change in a volatility before it is reported again
+#define VOLATILITY_REPORT_CHANGE 0.1
+// Changes below this are never reported
+#define VOLATILITY_REPORT_MIN 0.01
 
 /* 
     This file contains all the core device functions
@@ -50,7 +62,8 @@ class DeviceHandle {
         using device_t = std::variant<
         std::monostate
         #define DEVTYPE_BEGIN(name, ...) \
-        , Device::name
+        , Device::name \
+        , SimulatedDevice<TypeDef::name>
         #define ATTRIBUTE(...)
         #define DEVTYPE_END
         #include "DEVTYPES.LIST"
@@ -66,22 +79,36 @@ class DeviceHandle {
     public:
         uint16_t id;
         uint32_t cooldown = 0;
+        // Decides which polled states are sent
+        SendPolicy sendPolicy;
         bool isTrigger;
+        // Declared by the driver, see ProcessExclusion
+        ProcessExclusion exclusion = ProcessExclusion::ALL;
 
+        // Serializes transmitStates with processStates under ALL and TRANSMIT
+        std::mutex transmitMutex;
         std::shared_mutex m;
         std::condition_variable_any cv;
         bool processing = false;
         bool watchersPaused = true;
         bool timersPaused = true;
+        // Set by the interruptor so message processing pauses its watchers directly (called under m)
+        std::function<void(bool)> setWatchersPaused;
+        // Set by the poller so message processing pauses its timers directly (called under m)
+        std::function<void(bool)> setTimersPaused;
 
-        DeviceHandle(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> targetADC);
+        // Simulated devices replace the driver with a SimulatedDevice of the same type
+        DeviceHandle(TYPE dtype, std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> targetADC, bool simulate = false);
         void processStates(DynamicMessage input);
         void init(std::unordered_map<std::string, std::string> &config, std::shared_ptr<ADS7830> targetADC);
         void transmitStates(DynamicMessage &dmsg);
         void transmitDefaultStates(DynamicMessage &dmsg);
+        // Passes the fastest polling period to the ADC channels the driver reads, zero once polling stops
+        void setPollPeriod(std::chrono::milliseconds period);
         DeviceKind getDeviceKind();
         std::vector<InterruptDescriptor>& getIdescList();
-        std::optional<std::thread::id> getLatestCompletedHandlerId(std::stop_token stoken);
+        // Pops the oldest cursor query result into dmsg and returns the handler thread that produced it
+        std::optional<std::thread::id> transmitQueryResult(DynamicMessage &dmsg);
 
 };
 
@@ -106,41 +133,47 @@ class DevicePoller : public DeviceControlInterface<DevicePoller> {
         struct DeviceTimer {
             int id;
             int poll_period = -1;
-            std::chrono::milliseconds period_time;
-            std::unordered_map<std::string, std::deque<float>> attr_history;
+            std::unordered_map<std::string, AttributeVolatility> attr_volatility;
+            // Volatilities last reported to the master
             std::unordered_map<std::string, float> vol_map;
-            boost::asio::steady_timer timer;
-            DevicePoller& manager;
+            SendPolicy::LastSent lastSent;
         
-            DeviceTimer(uint16_t id, int period, boost::asio::io_context& ctx, DevicePoller& manager);
-            std::chrono::milliseconds getRemainingTime();
-            float calculateStd(std::deque<float> &data);
-            void calcVolMap();
-            void timerCallback();
-            void setPeriod(int newPeriod);
-            void start();
-            void pause();
-            void resume();
+            DeviceTimer(uint16_t id, int period);
+            void addSamples(DynamicMessage &dmsg);
+            // Volatilities that moved enough since they were last reported
+            std::unordered_map<std::string, float> getVolatilityUpdate();
         };
 
-        boost::asio::io_context& ctx;
+        PollingWheel& wheel;
+        int sourceId = -1;
+        // Orders timer sends against message processing pausing the timers
+        std::mutex timerMutex;
         std::unordered_map<uint16_t, DeviceTimer> timers;
-        std::jthread timerManagerThread;
+        // Timers that fell due while the device was processing a message
+        std::set<uint16_t> missedTimers;
+        bool paused = false;
 
-        void pauseTimers();
-        void resumeTimers();
-        void manageTimers(std::stop_token stoken);
+        void setTimersPaused(bool paused);
+        // Hands the fastest timer period to the device while the timers run
+        void updatePollPeriod();
+        // Runs on the wheel when timers of this device fall due
+        void onTimers(const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch);
 
     public: 
-        DevicePoller(boost::asio::io_context& ctx, DeviceHandle& device, std::shared_ptr<Connection> cc, int ctl, int dev);
+        DevicePoller(PollingWheel& wheel, DeviceHandle& device, std::shared_ptr<Connection> cc, int ctl, int dev);
         DevicePoller(DevicePoller&& other);
         ~DevicePoller();
 
-        void sendMessage(DeviceTimer& timer);
+        // Reads the device once and builds a message for every timer the send policy lets through
+        void createMessages(const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch);
         void setPeriod(uint16_t timerId, int newPeriod);
+        // Timers created once the timers run are scheduled right away
         void createTimer(uint16_t timerId, int period);
         std::vector<uint16_t> getTimerIds();
+        int getDeviceCode() const;
+        // Schedules the timers on the wheel
         void startTimers();
+        void stopTimers();
 }; 
 
 /* 
@@ -149,9 +182,7 @@ class DevicePoller : public DeviceControlInterface<DevicePoller> {
 class DeviceInterruptor : public DeviceControlInterface<DeviceInterruptor> {
     private:
         struct FileWatchDescriptor {
-            int fd;
-            int wd;
-            std::string filename;
+            int sourceId;
         };
 
         struct GpioWatchDescriptor {
@@ -173,6 +204,21 @@ class DeviceInterruptor : public DeviceControlInterface<DeviceInterruptor> {
             std::string endpoint;
         }; 
 
+        // Shared with the pending timer wait, which may outlive the interruptor
+        struct SimulatedWatch {
+            boost::asio::steady_timer timer;
+            std::function<std::chrono::milliseconds()> nextEvent;
+            std::function<void()> onEvent;
+            // Guards the timer and flags against pausing and stopping from other threads
+            std::mutex m;
+            bool paused = false;
+            bool stopped = false;
+        };
+
+        struct SimulatedWatchDescriptor {
+            std::shared_ptr<SimulatedWatch> watch;
+        };
+
         using WatchDescriptor = std::variant<
               FileWatchDescriptor
             , GpioWatchDescriptor
@@ -180,55 +226,72 @@ class DeviceInterruptor : public DeviceControlInterface<DeviceInterruptor> {
             , SdlWatchDescriptor
             #endif
             , HttpWatchDescriptor
+            , SimulatedWatchDescriptor
         >;
 
-        std::jthread watcherManagerThread;
-        std::vector<std::jthread> globalWatcherThreads;
+        // Handed to the driver callbacks, which signal the reactor when the handler reports a change
+        template<typename Handler>
+        struct CallbackData {
+            InterruptReactor& reactor;
+            int sourceId;
+            Handler handler;
+        };
+
+        InterruptReactor& reactor;
         std::vector<WatchDescriptor> watchDescriptors;
+        std::vector<int> sourceIds;
+        std::vector<std::unique_ptr<CallbackData<std::function<bool(int, int, uint32_t)>>>> gpioCallbacks;
+        #ifdef SDL_ENABLED
+        std::vector<std::unique_ptr<CallbackData<std::function<bool(SDL_Event*)>>>> sdlCallbacks;
+        #endif
         boost::asio::steady_timer cooldownTimer;
-        std::atomic_bool running = true;
+        bool running = false;
 
 
         void restartCooldown();
         bool inCooldown();
         void sendMessage();
+        // Runs on the reactor once a watcher reports a change
+        void onInterrupt();
         void disableWatchers();
         void enableWatchers();
-        void manageWatchers(std::stop_token stoken);
-        // Add Inotify thread blocking code here
-        void IFileWatcher(std::stop_token stoken, std::string fname, std::function<bool()> handler);
-        void IGpioWatcher(std::stop_token stoken, int portNum, std::function<bool(int, int , uint32_t)> handler);
+        void IFileWatcher(std::string fname, std::function<bool()> handler);
+        void IGpioWatcher(int portNum, std::function<bool(int, int , uint32_t)> handler);
         #ifdef SDL_ENABLED
-        void ISdlWatcher(std::stop_token stoken, std::function<bool(SDL_Event*)> handler);
+        void ISdlWatcher(std::function<bool(SDL_Event*)> handler);
         #endif
-        void IHttpWatcher(std::stop_token stoken, std::shared_ptr<HttpListener> server, std::string endpoint, std::function<bool(int64_t, std::string, std::string)> handler); 
+        void IHttpWatcher(std::shared_ptr<HttpListener> server, std::string endpoint, std::function<bool(int64_t, std::string, std::string)> handler); 
+        void ISimulatedWatcher(std::function<std::chrono::milliseconds()> nextEvent, std::function<bool()> handler);
+        // Waits for the next simulated event (called with watch->m held)
+        static void armSimulatedWatch(std::shared_ptr<SimulatedWatch> watch);
 
     public: 
-        DeviceInterruptor(boost::asio::io_context &in_ctx, DeviceHandle& targDev, std::shared_ptr<Connection> conex, int ctl, int dd);
+        DeviceInterruptor(boost::asio::io_context &in_ctx, InterruptReactor& reactor, DeviceHandle& targDev, std::shared_ptr<Connection> conex, int ctl, int dd);
         DeviceInterruptor(DeviceInterruptor&& other);
         ~DeviceInterruptor();
-        // Setup Watcher Thread
-        void setupThreads();
-        void stopThreads();
+        // Registers the device watchers with the reactor
+        void setupWatchers();
+        void stopWatchers();
 
 }; 
 
 class DeviceCursor : public DeviceControlInterface<DeviceCursor> {
     private:
-        std::jthread queryWatcherThread;
+        // Guards the pending queries and orders the collection of results from the device
+        std::mutex queryMutex;
         TSM<uint16_t, DynamicMessage> currentViews;
-        TSM<std::thread::id, uint16_t> queryHandlers;
+        // Task whose query is running on each handler thread
+        std::unordered_map<std::thread::id, uint16_t> pendingQueries;
 
-        void queryWatcher(std::stop_token stoken);
-        void updateView(uint16_t taskId);
+        void collectResults();
 
     public:
         DeviceCursor(DeviceHandle& device, std::shared_ptr<Connection> clientConnection, int ctl_code, int device_code);
         DeviceCursor(DeviceCursor&& other);
-        ~DeviceCursor();
-        void initialize();
         DynamicMessage getLatestTaskView(uint16_t taskId);
         void addQueryHandler(uint16_t taskId);
-        void awaitQueryCompletion(std::stop_token stoken);
+        // Publishes the view of the query run on this thread (drivers write their result before processStates returns),
+        // returns false when the driver broke that rule and the task keeps its previous view
+        bool completeQuery();
 
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "I2CBus.hpp"
+#ifdef __RPI64__
+#include <pigpio.h>
+#include <iostream>
+#endif
+
+#ifdef __RPI64__
+PigpioI2CBus::PigpioI2CBus(unsigned bus, unsigned address) {
+    if (gpioInitialise() < 0) {
+        std::cout<<"Failed to initialse GPIO for ADC detection"<<std::endl;
+    }
+    this->handle = i2cOpen(bus, address, 0);
+}
+
+bool PigpioI2CBus::isOpen() const {
+    return this->handle >= 0;
+}
+
+int PigpioI2CBus::writeByte(uint8_t value) {
+    return i2cWriteByte(this->handle, value);
+}
+
+int PigpioI2CBus::readByte() {
+    return i2cReadByte(this->handle);
+}
+
+void PigpioI2CBus::close() {
+    if (!isOpen()) return;
+    i2cClose(this->handle);
+    this->handle = -1;
+}
+#endif
+
+void FakeI2CBus::setValue(uint8_t command, int value) {
+    std::scoped_lock lk(m);
+    values[command] = value;
+}
+
+size_t FakeI2CBus::getReadCount() {
+    std::scoped_lock lk(m);
+    return reads;
+}
+
+size_t FakeI2CBus::getCollisionCount() {
+    std::scoped_lock lk(m);
+    return collisions;
+}
+
+bool FakeI2CBus::isOpen() const {
+    std::scoped_lock lk(m);
+    return open;
+}
+
+int FakeI2CBus::writeByte(uint8_t value) {
+    std::scoped_lock lk(m);
+    if (!open) return -1;
+    if (pending) {
+        collisions++;
+    }
+    selected = value;
+    pending = true;
+    return 0;
+}
+
+int FakeI2CBus::readByte() {
+    std::scoped_lock lk(m);
+    if (!open) return -1;
+    reads++;
+    pending = false;
+    auto value = values.find(selected);
+    return value == values.end() ? 0 : value->second;
+}
+
+void FakeI2CBus::close() {
+    std::scoped_lock lk(m);
+    open = false;
+}
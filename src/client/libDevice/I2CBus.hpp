@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+/*
+    Byte level access to one device on an I2C bus. Callers serialize transactions,
+    implementations only move the bytes.
+*/
+class I2CBus {
+    public:
+        virtual ~I2CBus() = default;
+        virtual bool isOpen() const = 0;
+        // Both return a negative value on failure
+        virtual int writeByte(uint8_t value) = 0;
+        virtual int readByte() = 0;
+        virtual void close() = 0;
+};
+
+#ifdef __RPI64__
+class PigpioI2CBus : public I2CBus {
+    private:
+        int handle = -1;
+
+    public:
+        PigpioI2CBus(unsigned bus, unsigned address);
+        bool isOpen() const override;
+        int writeByte(uint8_t value) override;
+        int readByte() override;
+        void close() override;
+};
+#endif
+
+/*
+    Bus of a simulated ADC for tests and hosts without I2C. Every written command selects
+    the value the next read returns. Commands written before the previous one was read
+    are counted as collisions, which a coordinated bus never produces.
+*/
+class FakeI2CBus : public I2CBus {
+    private:
+        mutable std::mutex m;
+        std::unordered_map<uint8_t, int> values;
+        uint8_t selected = 0;
+        bool pending = false;
+        bool open = true;
+        size_t reads = 0;
+        size_t collisions = 0;
+
+    public:
+        // Value read back after the command is written
+        void setValue(uint8_t command, int value);
+        size_t getReadCount();
+        size_t getCollisionCount();
+
+        bool isOpen() const override;
+        int writeByte(uint8_t value) override;
+        int readByte() override;
+        void close() override;
+};
@@ -0,0 +1,161 @@
+#include "InterruptReactor.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+InterruptReactor::InterruptReactor(boost::asio::io_context& ctx) : ctx(ctx) {
+    #ifdef __linux__
+    this->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->inotifyFd < 0) {
+        std::cerr << "Could not make Inotify object" << std::endl;
+        return;
+    }
+    this->inotifyStream = std::make_unique<boost::asio::posix::stream_descriptor>(ctx, this->inotifyFd);
+    this->waitForFileEvents();
+    #endif
+}
+
+InterruptReactor::~InterruptReactor() {
+    #ifdef __linux__
+    if (this->inotifyStream) {
+        // closes the inotify descriptor and drops every watch along with it
+        boost::system::error_code ec;
+        this->inotifyStream->close(ec);
+    }
+    #endif
+}
+
+int InterruptReactor::addFileWatch(const std::string& filename, std::function<void()> handler) {
+    std::scoped_lock lk(m);
+    int id = nextId++;
+    Source source{.handler = std::move(handler), .filename = filename};
+    if (!this->attachFile(id, source)) {
+        std::cerr << "Could not add watcher for " << filename << std::endl;
+        return -1;
+    }
+    this->sources.emplace(id, std::move(source));
+    return id;
+}
+
+int InterruptReactor::addSource(std::function<void()> handler) {
+    std::scoped_lock lk(m);
+    int id = nextId++;
+    this->sources.emplace(id, Source{.handler = std::move(handler)});
+    return id;
+}
+
+void InterruptReactor::removeSource(int id) {
+    std::scoped_lock lk(m);
+    auto source = this->sources.find(id);
+    if (source == this->sources.end()) {
+        return;
+    }
+    this->detachFile(id, source->second);
+    this->sources.erase(source);
+}
+
+void InterruptReactor::signal(int id) {
+    boost::asio::post(this->ctx, [this, id]() { this->dispatch(id); });
+}
+
+void InterruptReactor::pauseFileWatch(int id) {
+    std::scoped_lock lk(m);
+    if (auto source = this->sources.find(id); source != this->sources.end()) {
+        this->detachFile(id, source->second);
+    }
+}
+
+void InterruptReactor::resumeFileWatch(int id) {
+    std::scoped_lock lk(m);
+    if (auto source = this->sources.find(id); source != this->sources.end() && source->second.wd < 0) {
+        this->attachFile(id, source->second);
+    }
+}
+
+bool InterruptReactor::attachFile(int id, Source& source) {
+    #ifdef __linux__
+    if (this->inotifyFd < 0) {
+        return false;
+    }
+    int wd = inotify_add_watch(this->inotifyFd, source.filename.c_str(), IN_CLOSE_WRITE);
+    if (wd < 0) {
+        return false;
+    }
+    source.wd = wd;
+    this->wdSources[wd].push_back(id);
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+void InterruptReactor::detachFile(int id, Source& source) {
+    if (source.wd < 0) {
+        return;
+    }
+    auto& shared = this->wdSources[source.wd];
+    std::erase(shared, id);
+    if (shared.empty()) {
+        this->wdSources.erase(source.wd);
+        #ifdef __linux__
+        inotify_rm_watch(this->inotifyFd, source.wd);
+        #endif
+    }
+    source.wd = -1;
+}
+
+// Handlers run under the lock so a source cannot be removed while it executes
+void InterruptReactor::dispatch(int id) {
+    std::scoped_lock lk(m);
+    if (auto source = this->sources.find(id); source != this->sources.end()) {
+        source->second.handler();
+    }
+}
+
+#ifdef __linux__
+void InterruptReactor::waitForFileEvents() {
+    this->inotifyStream->async_wait(boost::asio::posix::stream_descriptor::wait_read, [this](boost::system::error_code ec) {
+        if (ec) {
+            return; // reactor closed
+        }
+        this->readFileEvents();
+        this->waitForFileEvents();
+    });
+}
+
+void InterruptReactor::readFileEvents() {
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(this->inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return; // drained (EAGAIN) or closed
+        }
+
+        std::vector<int> ready;
+        {
+            std::scoped_lock lk(m);
+            for (char* pos = buffer; pos < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(pos);
+                pos += sizeof(inotify_event) + event->len;
+                // removed watches report IN_IGNORED, and paused files no longer map to a source
+                if (!(event->mask & IN_CLOSE_WRITE)) {
+                    continue;
+                }
+                if (auto shared = this->wdSources.find(event->wd); shared != this->wdSources.end()) {
+                    ready.insert(ready.end(), shared->second.begin(), shared->second.end());
+                }
+            }
+        }
+
+        for (int id : ready) {
+            this->dispatch(id);
+        }
+    }
+}
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Client wide event loop for interrupt watchers. Every watched file shares one inotify
+    descriptor that is polled by the client io_context, and callbacks raised on driver
+    threads (GPIO, SDL, HTTP) are handed to the same context through signal(). Handlers
+    therefore always run on the context thread, regardless of the number of devices.
+*/
+class InterruptReactor {
+    private:
+        struct Source {
+            std::function<void()> handler;
+            // Only set for file watches
+            std::string filename;
+            int wd = -1;
+        };
+
+        boost::asio::io_context& ctx;
+        std::recursive_mutex m;
+        std::unordered_map<int, Source> sources;
+        // Inotify hands out one watch descriptor per file, which several sources may share
+        std::unordered_map<int, std::vector<int>> wdSources;
+        int nextId = 0;
+
+        #ifdef __linux__
+        int inotifyFd = -1;
+        std::unique_ptr<boost::asio::posix::stream_descriptor> inotifyStream;
+
+        void waitForFileEvents();
+        void readFileEvents();
+        #endif
+
+        bool attachFile(int id, Source& source);
+        void detachFile(int id, Source& source);
+        void dispatch(int id);
+
+    public:
+        InterruptReactor(boost::asio::io_context& ctx);
+        ~InterruptReactor();
+        InterruptReactor(const InterruptReactor&) = delete;
+        InterruptReactor& operator=(const InterruptReactor&) = delete;
+
+        // Runs the handler whenever a write to the file completes (returns -1 if the file cannot be watched)
+        int addFileWatch(const std::string& filename, std::function<void()> handler);
+        // Registers a handler that runs each time the source is signalled
+        int addSource(std::function<void()> handler);
+        void removeSource(int id);
+        // Safe to call from any thread, the handler runs on the context thread
+        void signal(int id);
+        // File events raised while paused are dropped
+        void pauseFileWatch(int id);
+        void resumeFileWatch(int id);
+};
@@ -0,0 +1,214 @@
+#include "PollingWheel.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+PollingWheel::PollingWheel(boost::asio::io_context& ctx, BatchSender sendBatch, std::chrono::milliseconds tick)
+                         : ctx(ctx)
+                         , sendBatch(std::move(sendBatch))
+                         , tickDuration(std::max(tick, std::chrono::milliseconds(1)))
+                         , epoch(std::chrono::steady_clock::now())
+                         , wakeTimer(ctx) {}
+
+PollingWheel::~PollingWheel() {
+    std::scoped_lock lk(m);
+    this->sources.clear();
+    this->timers.clear();
+    this->wakeTimer.cancel();
+}
+
+int PollingWheel::addSource(Handler handler) {
+    std::scoped_lock lk(m);
+    int id = nextId++;
+    this->sources.emplace(id, std::move(handler));
+    return id;
+}
+
+void PollingWheel::removeSource(int sourceId) {
+    std::scoped_lock lk(m);
+    this->sources.erase(sourceId);
+    std::erase_if(this->timers, [sourceId](auto& entry) { return entry.second.sourceId == sourceId; });
+}
+
+void PollingWheel::schedule(int sourceId, uint16_t timerId, std::chrono::milliseconds period) {
+    std::scoped_lock lk(m);
+    if (this->timers.empty()) {
+        // nothing was tracked while idle, so the wheel can jump to the present instead of replaying every tick
+        for (auto&& level : this->levels) {
+            for (auto&& slot : level) {
+                slot.clear();
+            }
+        }
+        this->currentTick = std::max(this->currentTick, this->nowTick());
+    }
+
+    auto ticks = this->toTicks(period);
+    auto now = std::max(this->nowTick(), this->currentTick);
+    auto key = makeKey(sourceId, timerId);
+    auto& timer = this->timers[key] = Timer{.sourceId = sourceId, .timerId = timerId, .period = ticks, .deadline = (now / ticks + 1) * ticks};
+    this->insert(key, timer.deadline);
+    this->requestArm();
+}
+
+void PollingWheel::setPeriod(int sourceId, uint16_t timerId, std::chrono::milliseconds period) {
+    std::scoped_lock lk(m);
+    auto key = makeKey(sourceId, timerId);
+    auto timer = this->timers.find(key);
+    if (timer == this->timers.end()) {
+        return;
+    }
+
+    auto ticks = this->toTicks(period);
+    auto now = std::max(this->nowTick(), this->currentTick);
+    auto deadline = (now / ticks + 1) * ticks;
+    timer->second.period = ticks;
+    if (deadline < timer->second.deadline) {
+        timer->second.deadline = deadline;
+        this->insert(key, deadline);
+        this->requestArm();
+    }
+}
+
+void PollingWheel::cancel(int sourceId, uint16_t timerId) {
+    std::scoped_lock lk(m);
+    this->timers.erase(makeKey(sourceId, timerId));
+}
+
+void PollingWheel::signal(int sourceId, std::vector<uint16_t> timerIds) {
+    boost::asio::post(this->ctx, [this, sourceId, timerIds = std::move(timerIds)]() {
+        std::scoped_lock lk(m);
+        std::unordered_map<int, std::vector<uint16_t>> due = {{sourceId, timerIds}};
+        this->dispatch(due);
+    });
+}
+
+uint64_t PollingWheel::makeKey(int sourceId, uint16_t timerId) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(sourceId)) << 16) | timerId;
+}
+
+uint64_t PollingWheel::nowTick() const {
+    return (std::chrono::steady_clock::now() - this->epoch) / this->tickDuration;
+}
+
+uint64_t PollingWheel::toTicks(std::chrono::milliseconds period) const {
+    auto ticks = (period + this->tickDuration / 2) / this->tickDuration;
+    return std::max<int64_t>(ticks, 1);
+}
+
+void PollingWheel::insert(uint64_t key, uint64_t deadline) {
+    uint64_t delta = deadline > this->currentTick ? deadline - this->currentTick : 1;
+    size_t level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t{1} << (LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
+    // deadlines past the top level wait in its furthest slot and are placed again when it cascades
+    uint64_t span = uint64_t{1} << (LEVEL_BITS * LEVELS);
+    uint64_t slotTick = std::min(this->currentTick + delta, this->currentTick + span - 1);
+    auto slot = (slotTick >> (LEVEL_BITS * level)) & (LEVEL_SLOTS - 1);
+    this->levels.at(level).at(slot).push_back(SlotEntry{.key = key, .deadline = deadline});
+}
+
+void PollingWheel::cascade(size_t level, uint64_t tick) {
+    auto& slot = this->levels.at(level).at((tick >> (LEVEL_BITS * level)) & (LEVEL_SLOTS - 1));
+    auto entries = std::exchange(slot, {});
+    for (auto&& entry : entries) {
+        auto timer = this->timers.find(entry.key);
+        if (timer != this->timers.end() && timer->second.deadline == entry.deadline) {
+            this->insert(entry.key, entry.deadline);
+        }
+    }
+}
+
+std::unordered_map<int, std::vector<uint16_t>> PollingWheel::advance(uint64_t targetTick) {
+    std::unordered_map<int, std::vector<uint16_t>> due;
+    if (this->timers.empty()) {
+        this->currentTick = std::max(this->currentTick, targetTick);
+        return due;
+    }
+
+    while (this->currentTick < targetTick) {
+        this->currentTick++;
+        for (size_t level = LEVELS - 1; level > 0; level--) {
+            if ((this->currentTick & ((uint64_t{1} << (LEVEL_BITS * level)) - 1)) == 0) {
+                this->cascade(level, this->currentTick);
+            }
+        }
+
+        auto entries = std::exchange(this->levels.at(0).at(this->currentTick & (LEVEL_SLOTS - 1)), {});
+        for (auto&& entry : entries) {
+            auto timer = this->timers.find(entry.key);
+            if (timer == this->timers.end() || timer->second.deadline != entry.deadline) {
+                continue;
+            }
+            auto& [sourceId, timerId, period, deadline] = timer->second;
+            due[sourceId].push_back(timerId);
+
+            // re-arm from the deadline rather than the wake-up, skipping the periods a late wake-up missed
+            deadline += period;
+            if (deadline <= targetTick) {
+                deadline += ((targetTick - deadline) / period + 1) * period;
+            }
+            this->insert(entry.key, deadline);
+        }
+    }
+    return due;
+}
+
+// Handlers run under the lock so a source cannot be removed while it executes
+void PollingWheel::dispatch(std::unordered_map<int, std::vector<uint16_t>>& due) {
+    std::vector<SentMessage> batch;
+    for (auto&& [sourceId, timerIds] : due) {
+        if (auto source = this->sources.find(sourceId); source != this->sources.end()) {
+            source->second(timerIds, batch);
+        }
+    }
+    if (!batch.empty() && this->sendBatch) {
+        this->sendBatch(std::move(batch));
+    }
+}
+
+uint64_t PollingWheel::nextWakeTick() {
+    // the wheel has to wake at the next occupied slot or at the next boundary where an upper level cascades
+    for (uint64_t tick = this->currentTick + 1; ; tick++) {
+        if ((tick & (LEVEL_SLOTS - 1)) == 0 || !this->levels.at(0).at(tick & (LEVEL_SLOTS - 1)).empty()) {
+            return tick;
+        }
+    }
+}
+
+void PollingWheel::arm() {
+    if (this->timers.empty()) {
+        this->wakeTimer.cancel();
+        this->armed = false;
+        return;
+    }
+
+    auto tick = this->nextWakeTick();
+    if (this->armed && this->armedTick == tick) {
+        return;
+    }
+    this->armed = true;
+    this->armedTick = tick;
+    this->wakeTimer.expires_at(this->epoch + tick * this->tickDuration);
+    this->wakeTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (!ec) {
+            this->onWake();
+        }
+    });
+}
+
+void PollingWheel::requestArm() {
+    boost::asio::post(this->ctx, [this]() {
+        std::scoped_lock lk(m);
+        this->arm();
+    });
+}
+
+void PollingWheel::onWake() {
+    std::scoped_lock lk(m);
+    this->armed = false;
+    auto due = this->advance(this->nowTick());
+    this->dispatch(due);
+    this->arm();
+}
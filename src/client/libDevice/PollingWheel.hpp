@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Protocol.hpp"
+#include <array>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Client wide hierarchical timer wheel for device polling. Every polling timer is kept
+    on an absolute tick deadline and re-armed from that deadline rather than from the time
+    it fired, so periods do not drift. A single steady_timer on the client io_context wakes
+    the wheel; all sources due on the same tick are dispatched in that wake-up and the
+    messages they produce go out as one batch.
+*/
+class PollingWheel {
+    public:
+        // Receives the timers of one source that fell due on the same tick and appends the messages to send
+        using Handler = std::function<void(const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch)>;
+        using BatchSender = std::function<void(std::vector<SentMessage> batch)>;
+
+        PollingWheel(boost::asio::io_context& ctx, BatchSender sendBatch, std::chrono::milliseconds tick = std::chrono::milliseconds(10));
+        ~PollingWheel();
+        PollingWheel(const PollingWheel&) = delete;
+        PollingWheel& operator=(const PollingWheel&) = delete;
+
+        int addSource(Handler handler);
+        // Cancels the timers of the source, its handler never runs again once this returns
+        void removeSource(int sourceId);
+        // Periods are rounded to the tick, and timers sharing a period are phase aligned so they fire together
+        void schedule(int sourceId, uint16_t timerId, std::chrono::milliseconds period);
+        // A shorter period applies right away, a longer one from the next expiry
+        void setPeriod(int sourceId, uint16_t timerId, std::chrono::milliseconds period);
+        void cancel(int sourceId, uint16_t timerId);
+        // Dispatches the timers outside their schedule (safe to call from any thread)
+        void signal(int sourceId, std::vector<uint16_t> timerIds);
+
+        std::chrono::milliseconds getTickDuration() const { return tickDuration; }
+
+    private:
+        static constexpr size_t LEVEL_BITS = 6;
+        static constexpr size_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+        static constexpr size_t LEVELS = 4;
+
+        struct Timer {
+            int sourceId;
+            uint16_t timerId;
+            uint64_t period;
+            uint64_t deadline;
+        };
+
+        // Slots are not cleaned on cancel or reschedule, stale entries no longer match their timer's deadline
+        struct SlotEntry {
+            uint64_t key;
+            uint64_t deadline;
+        };
+
+        boost::asio::io_context& ctx;
+        BatchSender sendBatch;
+        std::chrono::milliseconds tickDuration;
+        std::chrono::steady_clock::time_point epoch;
+        boost::asio::steady_timer wakeTimer;
+
+        std::recursive_mutex m;
+        std::unordered_map<int, Handler> sources;
+        std::unordered_map<uint64_t, Timer> timers;
+        std::array<std::array<std::vector<SlotEntry>, LEVEL_SLOTS>, LEVELS> levels;
+        uint64_t currentTick = 0;
+        uint64_t armedTick = 0;
+        bool armed = false;
+        int nextId = 0;
+
+        static uint64_t makeKey(int sourceId, uint16_t timerId);
+        uint64_t nowTick() const;
+        uint64_t toTicks(std::chrono::milliseconds period) const;
+        void insert(uint64_t key, uint64_t deadline);
+        void cascade(size_t level, uint64_t tick);
+        // Collects the timers due up to the target tick, grouped by source
+        std::unordered_map<int, std::vector<uint16_t>> advance(uint64_t targetTick);
+        void dispatch(std::unordered_map<int, std::vector<uint16_t>>& due);
+        uint64_t nextWakeTick();
+        void arm();
+        void requestArm();
+        void onWake();
+};
@@ -0,0 +1,103 @@
+#include "SendPolicy.hpp"
+#include "Connection.hpp"
+#include "Protocol.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    double parseAmount(const std::string& amount) {
+        size_t parsed = 0;
+        double value = std::stod(amount, &parsed);
+        if (parsed != amount.size() || value < 0) {
+            throw std::invalid_argument(amount);
+        }
+        return value;
+    }
+}
+
+SendPolicy::SendPolicy(const std::unordered_map<std::string, std::string>& config) {
+    try {
+        if (config.contains("send")) {
+            auto& mode = config.at("send");
+            if (mode != "change" && mode != "always") {
+                throw std::invalid_argument(mode);
+            }
+            onChange = mode == "change";
+        }
+        if (config.contains("deadband")) {
+            parseDeadbands(config.at("deadband"));
+            onChange = true;
+        }
+        if (config.contains("heartbeat")) {
+            heartbeat = std::chrono::milliseconds(std::stoul(config.at("heartbeat")));
+        }
+    }
+    catch (std::logic_error& e) { // invalid_argument and out_of_range from the parsers
+        throw BlsExceptionClass("Invalid send policy option: " + std::string(e.what()), ERROR_T::BAD_DEV_CONFIG);
+    }
+}
+
+void SendPolicy::parseDeadbands(const std::string& rules) {
+    std::stringstream ss(rules);
+    std::string rule;
+    while (std::getline(ss, rule, ';')) {
+        Deadband band;
+        auto separator = rule.find(':');
+        std::string amount = separator == std::string::npos ? rule : rule.substr(separator + 1);
+        if (amount.ends_with('%')) {
+            band.relative = true;
+            amount.pop_back();
+        }
+        band.amount = parseAmount(amount);
+        if (band.relative) {
+            band.amount /= 100;
+        }
+
+        if (separator == std::string::npos) {
+            defaultBand = band;
+        }
+        else {
+            attributeBands[rule.substr(0, separator)] = band;
+        }
+    }
+}
+
+bool SendPolicy::changed(const std::string& attribute, double previous, double current) const {
+    auto band = attributeBands.find(attribute);
+    auto deadband = band != attributeBands.end() ? std::optional(band->second) : defaultBand;
+    if (!deadband.has_value()) {
+        return previous != current;
+    }
+    double limit = deadband->relative ? deadband->amount * std::abs(previous) : deadband->amount;
+    // a zero band still reports any change
+    return std::abs(current - previous) > limit || (limit == 0 && previous != current);
+}
+
+bool SendPolicy::shouldSend(DynamicMessage& states, LastSent& last, std::chrono::steady_clock::time_point now) const {
+    if (!onChange) {
+        return true;
+    }
+
+    std::unordered_map<std::string, double> numeric;
+    std::vector<char> otherData;
+    states.getChangeSnapshot(numeric, otherData);
+
+    bool send = !last.valid
+             || otherData != last.otherData
+             || numeric.size() != last.numeric.size()
+             || (heartbeat.count() > 0 && now - last.time >= heartbeat);
+    for (auto it = numeric.begin(); !send && it != numeric.end(); it++) {
+        auto previous = last.numeric.find(it->first);
+        send = previous == last.numeric.end() || changed(it->first, previous->second, it->second);
+    }
+
+    // values inside the band are not recorded, so a slow drift still crosses it eventually
+    if (send) {
+        last.valid = true;
+        last.numeric = std::move(numeric);
+        last.otherData = std::move(otherData);
+        last.time = now;
+    }
+    return send;
+}
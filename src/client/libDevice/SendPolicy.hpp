@@ -0,0 +1,49 @@
+#pragma once
+
+#include "DynamicMessage.hpp"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Decides whether a polled state is worth sending to the master. Configured from the
+    device binding alongside options such as cooldown:
+        send-change         only send states that differ from the last one sent
+        deadband-<rules>    ';' separated [attribute:]amount[%] rules, numeric attributes that
+                            moved less than the band count as unchanged (implies send-change)
+        heartbeat-<ms>      send anyway once nothing was sent for this long
+    A rule without an attribute applies to every numeric attribute, and a trailing % makes
+    the band relative to the last value sent. Devices without these options send every poll.
+*/
+class SendPolicy {
+    public:
+        // Last state sent on one timer
+        struct LastSent {
+            bool valid = false;
+            std::unordered_map<std::string, double> numeric;
+            std::vector<char> otherData;
+            std::chrono::steady_clock::time_point time;
+        };
+
+        SendPolicy() = default;
+        SendPolicy(const std::unordered_map<std::string, std::string>& config);
+
+        // Records the states as sent when they should be sent
+        bool shouldSend(DynamicMessage& states, LastSent& last, std::chrono::steady_clock::time_point now) const;
+
+    private:
+        struct Deadband {
+            double amount = 0;
+            bool relative = false;
+        };
+
+        bool onChange = false;
+        std::optional<Deadband> defaultBand;
+        std::unordered_map<std::string, Deadband> attributeBands;
+        std::chrono::milliseconds heartbeat{0};
+
+        void parseDeadbands(const std::string& rules);
+        bool changed(const std::string& attribute, double previous, double current) const;
+};
@@ -0,0 +1,193 @@
+#include "SignalGenerator.hpp"
+#include "Connection.hpp"
+#include "Protocol.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <numbers>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+namespace {
+    double parseNumber(const std::string& number) {
+        size_t parsed = 0;
+        double value = std::stod(number, &parsed);
+        if (parsed != number.size()) {
+            throw std::invalid_argument(number);
+        }
+        return value;
+    }
+}
+
+SignalGenerator::SignalGenerator(const std::unordered_map<std::string, std::string>& config) {
+    static const std::unordered_map<std::string, Wave> waves = {
+        {"sine", Wave::SINE}, {"square", Wave::SQUARE}, {"saw", Wave::SAW},
+        {"random", Wave::RANDOM}, {"walk", Wave::WALK}, {"trace", Wave::TRACE}
+    };
+
+    try {
+        if (config.contains("sim")) {
+            auto found = waves.find(config.at("sim"));
+            if (found == waves.end()) {
+                throw std::invalid_argument(config.at("sim"));
+            }
+            wave = found->second;
+        }
+        if (config.contains("sim_period")) {
+            period = parseNumber(config.at("sim_period"));
+        }
+        if (config.contains("sim_min")) {
+            min = parseNumber(config.at("sim_min"));
+        }
+        if (config.contains("sim_max")) {
+            max = parseNumber(config.at("sim_max"));
+        }
+        if (config.contains("sim_rate")) {
+            rate = parseNumber(config.at("sim_rate"));
+        }
+        if (config.contains("sim_seed")) {
+            rng.seed(std::stoull(config.at("sim_seed")));
+        }
+        if (period <= 0 || rate <= 0 || max < min) {
+            throw std::invalid_argument("period and rate must be positive and min at most max");
+        }
+        if (config.contains("sim_trace")) {
+            wave = Wave::TRACE;
+            loadTrace(config.at("sim_trace"));
+        }
+        else if (wave == Wave::TRACE) {
+            throw std::invalid_argument("sim-trace requires a sim_trace file");
+        }
+    }
+    catch (std::logic_error& e) { // invalid_argument and out_of_range from the parsers
+        throw BlsExceptionClass("Invalid simulation option: " + std::string(e.what()), ERROR_T::BAD_DEV_CONFIG);
+    }
+}
+
+void SignalGenerator::loadTrace(const std::string& filename) {
+    std::ifstream file("./samples/client/" + filename);
+    if (!file.is_open()) {
+        throw std::invalid_argument("could not open trace " + filename);
+    }
+
+    std::string line, cell;
+    std::vector<std::string> columns;
+    std::getline(file, line);
+    std::stringstream header(line);
+    while (std::getline(header, cell, ',')) {
+        columns.push_back(cell);
+    }
+
+    auto time = 0ms;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        std::stringstream row(line);
+        std::getline(row, cell, ',');
+        time += std::chrono::milliseconds(std::stoul(cell));
+        TraceRow& traceRow = trace.emplace_back(TraceRow{time, {}});
+        for (size_t i = 1; i < columns.size() && std::getline(row, cell, ','); i++) {
+            traceRow.values.emplace(columns.at(i), cell);
+        }
+    }
+    if (trace.empty() || trace.back().time == 0ms) {
+        throw std::invalid_argument("trace " + filename + " has no rows or no duration");
+    }
+}
+
+const SignalGenerator::TraceRow* SignalGenerator::traceAt(std::chrono::milliseconds time) const {
+    auto cycleTime = time % trace.back().time;
+    auto after = std::ranges::upper_bound(trace, cycleTime, {}, &TraceRow::time);
+    // before the first row the last row of the previous cycle still holds
+    return after == trace.begin() ? &trace.back() : &*std::prev(after);
+}
+
+std::chrono::milliseconds SignalGenerator::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+std::chrono::milliseconds SignalGenerator::nextEvent() {
+    if (wave != Wave::TRACE) {
+        std::exponential_distribution<double> interval(rate);
+        return std::chrono::milliseconds(std::llround(interval(rng) * 1000));
+    }
+
+    auto cycle = trace.back().time;
+    auto cycleTime = elapsed() % cycle;
+    auto next = std::ranges::upper_bound(trace, cycleTime, {}, &TraceRow::time);
+    return next == trace.end() ? cycle - cycleTime + trace.front().time : next->time - cycleTime;
+}
+
+double SignalGenerator::sample(const std::string& attribute, std::chrono::milliseconds time) {
+    double phase = std::fmod(time.count() / period + (std::hash<std::string>{}(attribute) % 1000) / 1000.0, 1.0);
+    double amplitude = max - min;
+    switch (wave) {
+        case Wave::SINE:
+            return min + amplitude * (1 + std::sin(2 * std::numbers::pi * phase)) / 2;
+        case Wave::SQUARE:
+            return phase < 0.5 ? max : min;
+        case Wave::SAW:
+            return min + amplitude * phase;
+        case Wave::WALK: {
+            auto [position, inserted] = walkPositions.try_emplace(attribute, min + amplitude / 2);
+            std::normal_distribution<double> step(0, amplitude / 20);
+            double next = position->second + step(rng);
+            // reflect off the bounds
+            next = next > max ? 2 * max - next : next < min ? 2 * min - next : next;
+            position->second = std::clamp(next, min, max);
+            return position->second;
+        }
+        case Wave::RANDOM:
+        case Wave::TRACE:
+        break;
+    }
+    std::uniform_real_distribution<double> uniform(min, max);
+    return uniform(rng);
+}
+
+void SignalGenerator::fill(const std::string& attribute, double& value, std::chrono::milliseconds time) {
+    if (wave != Wave::TRACE) {
+        value = sample(attribute, time);
+        return;
+    }
+    auto* row = traceAt(time);
+    auto cell = row->values.find(attribute);
+    if (cell != row->values.end()) {
+        try {
+            value = parseNumber(cell->second);
+        }
+        catch (std::logic_error&) {} // keep the last value on cells that are not numbers
+    }
+}
+
+void SignalGenerator::fill(const std::string& attribute, int64_t& value, std::chrono::milliseconds time) {
+    double sampled = value;
+    fill(attribute, sampled, time);
+    value = std::llround(sampled);
+}
+
+void SignalGenerator::fill(const std::string& attribute, bool& value, std::chrono::milliseconds time) {
+    if (wave == Wave::TRACE) {
+        auto* row = traceAt(time);
+        auto cell = row->values.find(attribute);
+        if (cell != row->values.end()) {
+            value = cell->second == "true" || cell->second == "1";
+        }
+        return;
+    }
+    value = sample(attribute, time) > (min + max) / 2;
+}
+
+void SignalGenerator::fill(const std::string& attribute, std::string& value, std::chrono::milliseconds time) {
+    if (wave == Wave::TRACE) {
+        auto* row = traceAt(time);
+        auto cell = row->values.find(attribute);
+        if (cell != row->values.end()) {
+            value = cell->second;
+        }
+        return;
+    }
+    value = attribute + " " + std::to_string(std::llround(sample(attribute, time)));
+}
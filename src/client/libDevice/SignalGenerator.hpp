@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Produces attribute values for simulated devices. Configured from the device binding:
+        sim-<wave>          sine, square, saw, random (uniform), walk (bounded random walk) or trace
+        sim_period-<ms>     period of the periodic waves (default 1000)
+        sim_min-<v>         lower bound of the generated values (default 0)
+        sim_max-<v>         upper bound of the generated values (default 100)
+        sim_rate-<hz>       mean interrupt rate, events arrive as a poisson process (default 1)
+        sim_seed-<n>        seed of the random waves and event times, for reproducible runs
+        sim_trace-<file>    csv under samples/client replayed in a loop, with a header row: the
+                            first column holds the ms since the previous row and the others one
+                            attribute each, interrupts fire on every row
+    Attributes are offset in phase by their name so the attributes of one device differ.
+    Integers are rounded, booleans are set above the midpoint and strings carry the value.
+*/
+class SignalGenerator {
+    public:
+        SignalGenerator() = default;
+        SignalGenerator(const std::unordered_map<std::string, std::string>& config);
+
+        // Time since the generator was created, the time every sample is taken at
+        std::chrono::milliseconds elapsed() const;
+        // Delay until the next simulated interrupt
+        std::chrono::milliseconds nextEvent();
+
+        void fill(const std::string& attribute, double& value, std::chrono::milliseconds time);
+        void fill(const std::string& attribute, int64_t& value, std::chrono::milliseconds time);
+        void fill(const std::string& attribute, bool& value, std::chrono::milliseconds time);
+        void fill(const std::string& attribute, std::string& value, std::chrono::milliseconds time);
+        // Lists and maps keep their value
+        template<typename T>
+        void fill(const std::string&, T&, std::chrono::milliseconds) {}
+
+    private:
+        enum class Wave : uint8_t {
+            SINE,
+            SQUARE,
+            SAW,
+            RANDOM,
+            WALK,
+            TRACE
+        };
+
+        struct TraceRow {
+            // Since the start of the trace
+            std::chrono::milliseconds time;
+            std::unordered_map<std::string, std::string> values;
+        };
+
+        Wave wave = Wave::RANDOM;
+        double period = 1000;
+        double min = 0;
+        double max = 100;
+        double rate = 1;
+        std::mt19937_64 rng{std::random_device{}()};
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        // Last value of every attribute on the walk
+        std::unordered_map<std::string, double> walkPositions;
+        std::vector<TraceRow> trace;
+
+        void loadTrace(const std::string& filename);
+        const TraceRow* traceAt(std::chrono::milliseconds time) const;
+        double sample(const std::string& attribute, std::chrono::milliseconds time);
+};
@@ -0,0 +1,79 @@
+#include "SimulatedDevice.hpp"
+#include <chrono>
+#include <mutex>
+
+namespace {
+    #define DEVTYPE_BEGIN(name, ...) \
+    [[ maybe_unused ]] void fillStates(TypeDef::name& states, SignalGenerator& generator, std::chrono::milliseconds time) {
+    #define ATTRIBUTE(attr, ...) \
+        generator.fill(#attr, states.attr, time);
+    #define DEVTYPE_END \
+    }
+    #include "DEVTYPES.LIST"
+    #undef DEVTYPE_BEGIN
+    #undef ATTRIBUTE
+    #undef DEVTYPE_END
+}
+
+template<Driveable T>
+SimulatedDevice<T>::SimulatedDevice(DeviceKind kind) : kind(kind) {}
+
+template<Driveable T>
+void SimulatedDevice<T>::sample(T& states) {
+    std::scoped_lock lk(generatorMutex);
+    fillStates(states, generator, generator.elapsed());
+}
+
+template<Driveable T>
+void SimulatedDevice<T>::init(std::unordered_map<std::string, std::string> &config) {
+    generator = SignalGenerator(config);
+    this->sample(this->states);
+    if (kind == DeviceKind::INTERRUPT) {
+        this->addSimulatedIWatch([this]() {
+            std::scoped_lock lk(generatorMutex);
+            return generator.nextEvent();
+        }, [this]() {
+            T sampled;
+            this->sample(sampled);
+            std::scoped_lock lk(statesMutex);
+            this->states = sampled;
+            return true;
+        });
+    }
+}
+
+template<Driveable T>
+void SimulatedDevice<T>::processStates(DynamicMessage& dmsg) {
+    if (kind != DeviceKind::CURSOR) {
+        std::scoped_lock lk(statesMutex);
+        dmsg.unpackStates(this->states);
+        return;
+    }
+    T query;
+    dmsg.unpackStates(query);
+    this->sample(query);
+    this->writeQueryResult(query);
+}
+
+template<Driveable T>
+void SimulatedDevice<T>::transmitStates(DynamicMessage &dmsg) {
+    if (kind == DeviceKind::CURSOR) {
+        auto lastState = this->getLastQueryResult();
+        dmsg.packStates(lastState);
+        return;
+    }
+    std::scoped_lock lk(statesMutex);
+    if (kind == DeviceKind::POLLING) {
+        this->sample(this->states);
+    }
+    dmsg.packStates(this->states);
+}
+
+#define DEVTYPE_BEGIN(name, ...) \
+template class SimulatedDevice<TypeDef::name>;
+#define ATTRIBUTE(...)
+#define DEVTYPE_END
+#include "DEVTYPES.LIST"
+#undef DEVTYPE_BEGIN
+#undef ATTRIBUTE
+#undef DEVTYPE_END
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DeviceCore.hpp"
+#include "DynamicMessage.hpp"
+#include "Protocol.hpp"
+#include "SignalGenerator.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+    Stand-in driver for any device type, used when the client runs with --simulate.
+    States are produced by a SignalGenerator configured from the sim options of the
+    device binding (see SignalGenerator.hpp), so no hardware is touched:
+        POLLING     every read samples the generator
+        INTERRUPT   interrupts arrive at the generator's event rate and sample it
+        ACTUATOR    writes are kept as the device states
+        CURSOR      queries are answered with sampled states
+*/
+template<Driveable T>
+class SimulatedDevice : public DeviceCore<T> {
+    private:
+        DeviceKind kind;
+        SignalGenerator generator;
+        // Samples are taken from the poller, the interrupt watcher and message handlers
+        std::mutex generatorMutex;
+        // States are written by the interrupt watcher and read by transmitStates
+        std::mutex statesMutex;
+
+        void sample(T& states);
+
+    public:
+        SimulatedDevice(DeviceKind kind);
+        DeviceKind getKind() const { return kind; }
+        void processStates(DynamicMessage& dmsg);
+        void init(std::unordered_map<std::string, std::string> &config);
+        void transmitStates(DynamicMessage &dmsg);
+};
@@ -12,6 +12,8 @@ namespace Device{
             uint8_t ccw_pin2;
 
         public: 
+            // Writes only reach the driver's own outputs
+            static constexpr ProcessExclusion processExclusion = ProcessExclusion::TRANSMIT;
             ~DC_MOTOR();
             void processStates(DynamicMessage &dmsg);
             void init(std::unordered_map<std::string, std::string> &config);
@@ -16,6 +16,8 @@ namespace Device{
             }
 
         public: 
+            // Writes only reach the driver's own outputs
+            static constexpr ProcessExclusion processExclusion = ProcessExclusion::TRANSMIT;
             ~FN_SERVO();
             void processStates(DynamicMessage &dmsg);
             void init(std::unordered_map<std::string, std::string> &config);
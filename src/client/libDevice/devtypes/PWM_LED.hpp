@@ -8,6 +8,8 @@ namespace Device{
             uint8_t PIN;
         
         public: 
+            // Writes only reach the driver's own outputs
+            static constexpr ProcessExclusion processExclusion = ProcessExclusion::TRANSMIT;
             ~PWM_LED();
             void processStates(DynamicMessage &dmsg);
             void init(std::unordered_map<std::string, std::string> &config);
@@ -10,6 +10,8 @@ namespace Device{
             uint8_t GREEN_PIN;
 
         public: 
+            // Writes only reach the driver's own outputs
+            static constexpr ProcessExclusion processExclusion = ProcessExclusion::TRANSMIT;
             ~RGB_LED();
             void processStates(DynamicMessage &dmsg);
             void init(std::unordered_map<std::string, std::string> &config);
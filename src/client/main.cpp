@@ -1,4 +1,5 @@
 #include "Client.hpp"
+#include "LatencyTrace.hpp"
 #include <functional>
 #include <string>
 #include <thread>
@@ -13,16 +14,32 @@
 #endif
 
 int main(int argc, char* argv[]) {
+    // usage: client [name] [--simulate] [--trace]
     std::string name;
-    if (argc == 2) {
-        name = argv[1];
+    bool simulate = false;
+    bool trace = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--simulate") {
+            simulate = true;
+        }
+        else if (arg == "--trace") {
+            trace = true;
+        }
+        else {
+            name = arg;
+        }
     }
-    else {        
+    if (name.empty()) {        
         char hostname[HOST_NAME_MAX];
         gethostname(hostname, HOST_NAME_MAX+1);
         name = hostname;
     }
-    auto client = Client(name);
+    if (trace) {
+        LatencyTracer::instance().enable();
+        LatencyTracer::instance().startReporter(std::chrono::seconds(TRACE_REPORT_PERIOD), name);
+    }
+    auto client = Client(name, simulate);
     #ifdef SDL_ENABLED
         bool sdlRunning = true;
         if (!SDL_Init(SDL_INIT_VIDEO)) {
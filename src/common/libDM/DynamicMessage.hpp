@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
@@ -97,6 +98,24 @@ class DynamicMessage{
     }
 
 
+    // Reads a numeric primitive at its stored width
+    double readNumeric(const Descriptor &desc){
+        const char* src = this->data.data() + desc.lumpOffset; 
+        auto read = [src]<typename T>(T value){
+            std::memcpy(&value, src, sizeof(T)); 
+            return static_cast<double>(value); 
+        }; 
+        if(desc.descType == TYPE::float_t){
+            return desc.eleSize == sizeof(float) ? read(float{}) : read(double{}); 
+        }
+        switch(desc.eleSize){
+            case 1: return read(int8_t{}); 
+            case 2: return read(int16_t{}); 
+            case 4: return read(int32_t{}); 
+            default: return read(int64_t{}); 
+        }
+    }
+
     // Deserialize helper for primative types: 
     template <typename T>
     void deserialize(int descPos, T& primRecv, int &travDesc){
@@ -794,32 +813,25 @@ class DynamicMessage{
    }
 
 
-   // Utility function to get the volatility of a field
-    void getFieldVolatility(std::unordered_map<std::string, std::deque<float>>  &vol_list){
-        for(auto &obj : this->attributeMap){    
-            int desc = obj.second; 
-
-            TYPE type = this->Descriptors.at(desc).descType; 
-
-            // If the value is of numeric type; 
-            if(type == TYPE::float_t){
-                double carrier;
-                int trav_dist;
-                this->deserialize(desc ,carrier, trav_dist);
-                if (!vol_list.contains(obj.first)) {
-                    vol_list.try_emplace(obj.first);
-                }
-                vol_list.at(obj.first).push_back(carrier);
-                
+   // Numeric attributes by name, plus the lump with those values blanked so the remaining attributes compare as raw bytes
+    void getChangeSnapshot(std::unordered_map<std::string, double> &numeric, std::vector<char> &otherData){
+        otherData = this->data; 
+        for(auto &obj : this->attributeMap){
+            auto &desc = this->Descriptors.at(obj.second); 
+            if(desc.descType != TYPE::float_t && desc.descType != TYPE::int_t){
+                continue; 
             }
-            else if(type == TYPE::int_t){
-                int64_t carrier;
-                int trav_dist;
-                this->deserialize(desc, carrier, trav_dist);
-                if (!vol_list.contains(obj.first)) {
-                    vol_list.try_emplace(obj.first);
-                }
-                vol_list.at(obj.first).push_back(carrier);
+            numeric[obj.first] = this->readNumeric(desc); 
+            std::fill_n(otherData.begin() + desc.lumpOffset, desc.eleSize, 0); 
+        }
+    }
+
+   // Numeric attributes by name, used to sample the volatility of a device
+    void getNumericFields(std::unordered_map<std::string, double> &numeric){
+        for(auto &obj : this->attributeMap){
+            auto &desc = this->Descriptors.at(obj.second); 
+            if(desc.descType == TYPE::float_t || desc.descType == TYPE::int_t){
+                numeric[obj.first] = this->readNumeric(desc); 
             }
         }
    }
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Fixed size worker pool where every worker owns a job deque. Workers
+    drain their own deque first and steal from the other workers once it
+    is empty, so a burst of jobs submitted to one worker spreads across
+    the pool. Jobs submitted from inside a worker stay on that worker.
+
+    Jobs that wait on other jobs must wrap the wait in blockOn. While a
+    worker is blocked the pool starts a spare worker, so the pool always
+    has as many unblocked workers as it was sized with. Spares retire once
+    they run out of jobs while the pool has more unblocked workers than
+    its size.
+*/
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(size_t threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        // Early jobs may already start spares
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        for (size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, i, false);
+        }
+        live = threadCount;
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Runs every job already submitted, then stops the workers
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+        }
+        sleepCV.notify_all();
+        // No spare is started once stop is set
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void submit(Job job) {
+        size_t index;
+        if (currentPool == this) {
+            index = currentIndex;
+        }
+        else {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            index = nextWorker++ % workers.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mut);
+            workers[index]->jobs.push_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending++;
+        }
+        sleepCV.notify_one();
+    }
+
+    // Runs the wait, a pool worker is replaced by a spare for its duration
+    template<typename Wait>
+    static void blockOn(Wait&& wait) {
+        WorkStealingPool* pool = currentPool;
+        if (pool == nullptr) {
+            wait();
+            return;
+        }
+
+        pool->beginBlocking();
+        try {
+            wait();
+        }
+        catch (...) {
+            pool->endBlocking();
+            throw;
+        }
+        pool->endBlocking();
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    // Workers including the running spares started for blocked workers
+    size_t threadCount() {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        return live;
+    }
+
+private:
+    struct Worker {
+        std::mutex mut;
+        std::deque<Job> jobs;
+    };
+
+    // Owners take the oldest job so a task that resubmits itself cannot starve its neighbours
+    bool popLocal(size_t index, Job& job) {
+        auto& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mut);
+        if (worker.jobs.empty()) {
+            return false;
+        }
+        job = std::move(worker.jobs.front());
+        worker.jobs.pop_front();
+        return true;
+    }
+
+    bool steal(size_t index, Job& job) {
+        for (size_t i = 1; i < workers.size(); i++) {
+            auto& victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mut);
+            if (victim.jobs.empty()) {
+                continue;
+            }
+            job = std::move(victim.jobs.back());
+            victim.jobs.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    // The pool grows at most to its size plus the jobs blocked at once
+    void beginBlocking() {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        blocked++;
+        // The destructor joins the threads once stop is set
+        if (stop) {
+            return;
+        }
+        reapRetired();
+        if (live - blocked < workers.size()) {
+            // Spares share the deque of a worker so their own submits stay local
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, live % workers.size(), true);
+            live++;
+        }
+    }
+
+    void endBlocking() {
+        bool wakeSpares;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            blocked--;
+            wakeSpares = surplus();
+        }
+        // Idle spares retire on wake up
+        if (wakeSpares) {
+            sleepCV.notify_all();
+        }
+    }
+
+    // More workers are unblocked than the pool was sized with (sleepMutex must be held)
+    bool surplus() const {
+        return live - blocked > workers.size();
+    }
+
+    // Joins the spares that returned from workerLoop (sleepMutex must be held)
+    void reapRetired() {
+        for (auto id : retired) {
+            auto it = std::find_if(threads.begin(), threads.end(), [id](std::thread& thread) { return thread.get_id() == id; });
+            if (it != threads.end()) {
+                it->join();
+                threads.erase(it);
+            }
+        }
+        retired.clear();
+    }
+
+    void workerLoop(size_t index, bool spare) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            Job job;
+            if (popLocal(index, job) || steal(index, job)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    pending--;
+                }
+                job();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (spare && !stop && surplus()) {
+                live--;
+                retired.push_back(std::this_thread::get_id());
+                return;
+            }
+            // pending can briefly go negative when a job is taken before its submit is counted
+            if (stop && pending <= 0) {
+                return;
+            }
+            sleepCV.wait(lock, [this, spare]() { return stop || pending > 0 || (spare && surplus()); });
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
+    int64_t pending = 0;
+    // Threads that have not returned from workerLoop
+    size_t live = 0;
+    // Workers inside blockOn
+    size_t blocked = 0;
+    // Spares that returned but were not joined yet
+    std::vector<std::thread::id> retired;
+    size_t nextWorker = 0;
+    bool stop = false;
+
+    inline static thread_local WorkStealingPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
+};
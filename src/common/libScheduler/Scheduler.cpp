@@ -1,5 +1,6 @@
 #include "Scheduler.hpp"
 #include "Serialization.hpp"
+#include "Executor.hpp"
 #include <mutex>
 
 
@@ -23,24 +24,44 @@ HeapMasterMessage DeviceScheduler::makeMessage(TaskID& taskId, DeviceID& devName
 }
 
 
-DeviceScheduler::DeviceScheduler(std::vector<TaskDescriptor> &taskDescList, std::function<void(HeapMasterMessage)> msgHandler)
+DeviceScheduler::DeviceScheduler(std::vector<TaskDescriptor> &taskDescList, std::function<void(HeapMasterMessage)> msgHandler, bool staticLeases)
 {
+    // Collect the writers of each device before deciding which devices need the ownership protocol
+    std::unordered_map<DeviceID, std::set<TaskID>> deviceWriters; 
     for(auto& taskDesc : taskDescList){
         auto& taskName = taskDesc.name;
+        this->taskWaitMap[taskName].taskName = taskName;
         for(DeviceDescriptor& dev : taskDesc.outDevices){
             if(dev.deviceKind != DeviceKind::CURSOR){
-                if(this->scheduledProcessMap.contains(dev.device_name)){
-                    this->scheduledProcessMap[dev.device_name]; 
-                }
-                this->taskWaitMap[taskName].taskName = taskName;
-                this->taskWaitMap[taskName].mustOwn.insert(dev.device_name); 
+                deviceWriters[dev.device_name].insert(taskName); 
                 this->devControllerMap[dev.device_name] = dev.controller; 
             }
         }
     }
 
+    for(auto& [devName, writers] : deviceWriters){
+        if(staticLeases && writers.size() == 1){
+            // Sole writer: the device is leased once and skips the per execution protocol
+            this->leaseMap[devName] = *writers.begin(); 
+            continue; 
+        }
+        this->scheduledProcessMap[devName]; 
+        for(auto& taskName : writers){
+            this->taskWaitMap[taskName].mustOwn.insert(devName); 
+        }
+    }
+
     this->handleMessage = msgHandler; 
 }
+
+void DeviceScheduler::grantLeases(){
+    for(auto& [device, task] : this->leaseMap){
+        DeviceID devName = device; 
+        TaskID taskName = task; 
+        this->handleMessage(this->makeMessage(taskName, devName, PROTOCOLS::OWNER_LEASE)); 
+    }
+}
+
 /*
     May need to add a now owns 
 */
@@ -67,7 +88,10 @@ void DeviceScheduler::request(TaskID& requestor, int priority){
     // Wait until the final message arrives: 
     std::unique_lock<std::mutex> lock(jamar.mtx); 
 
-    jamar.cv.wait(lock, [&jamar](){return jamar.executeFlag;});    
+    // On the EM pool a spare worker runs the other tasks while this one waits for its grants
+    WorkStealingPool::blockOn([&](){
+        jamar.cv.wait(lock, [&jamar](){return jamar.executeFlag;});    
+    }); 
 }
 
 void DeviceScheduler::receive(HeapMasterMessage &recvMsg){
@@ -148,4 +172,11 @@ void DeviceScheduler::release(TaskID& reqTask){
         }
     }
     
-}
\ No newline at end of file
+}
+
+void DeviceScheduler::skip(TaskID& reqTask){
+    // The conclude still has to be sent so the mailbox does not hold back the other triggered tasks
+    std::string nullDev; 
+    this->handleMessage(this->makeMessage(reqTask, nullDev, PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE)); 
+    this->handleMessage(this->makeMessage(reqTask, nullDev, PROTOCOLS::OWNER_RELEASE_NULL)); 
+}
@@ -122,6 +122,9 @@ class DeviceScheduler{
         // Returns what each task is waiting on
         std::unordered_map<TaskID, PendingStateInfo> taskWaitMap; 
 
+        // Maps uncontended devices to the sole task that writes to them (granted when the EM starts)
+        std::unordered_map<DeviceID, TaskID> leaseMap; 
+
         // Utility Functions: 
         HeapMasterMessage makeMessage(TaskID& oName, DeviceID& devName, PROTOCOLS pmsg, int priority, bool vtype); 
 
@@ -130,10 +133,15 @@ class DeviceScheduler{
         
 
     public: 
-        DeviceScheduler(std::vector<TaskDescriptor> &taskDescList, std::function<void(HeapMasterMessage)> dmm_message); 
+        // Static leases hand sole writers their devices once instead of per execution
+        DeviceScheduler(std::vector<TaskDescriptor> &taskDescList, std::function<void(HeapMasterMessage)> dmm_message, bool staticLeases = false); 
         void request(TaskID& taskName, int priority); 
         void receive(HeapMasterMessage &DMM); 
         void release(TaskID &reqTask); 
+        // Ends an activation that turned out to write nothing without acquiring any device
+        void skip(TaskID &reqTask); 
+        // Sends a one time ownership lease for every device with a single writer
+        void grantLeases(); 
 }; 
 
 
@@ -0,0 +1,177 @@
+#include "LatencyTrace.hpp"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+    const char* stageName(TraceStage stage) {
+        switch (stage) {
+            case TraceStage::CLIENT_READ: return "client read";
+            case TraceStage::NETWORK_TO_MASTER: return "network to master";
+            case TraceStage::MAILBOX_QUEUE: return "mailbox queue";
+            case TraceStage::READER_BOX: return "reader box";
+            case TraceStage::TRIGGER_QUEUE: return "trigger queue";
+            case TraceStage::SCHEDULER: return "scheduler";
+            case TraceStage::VM_EXEC: return "vm execution";
+            case TraceStage::WRITER_QUEUE: return "writer queue";
+            case TraceStage::WRITER_BOX: return "writer box";
+            case TraceStage::NETWORK_TO_CLIENT: return "network to client";
+            case TraceStage::CLIENT_WRITE: return "client write";
+            case TraceStage::END_TO_END: return "end to end";
+            default: return "unknown";
+        }
+    }
+
+    const char* counterName(TraceCounter counter) {
+        switch (counter) {
+            case TraceCounter::DROPPED_EVENTS: return "dropped events";
+            case TraceCounter::COALESCED_EVENTS: return "coalesced events";
+            default: return "unknown";
+        }
+    }
+}
+
+void LatencyHistogram::add(int64_t ns) {
+    int64_t us = std::max<int64_t>(ns, 0) / 1000;
+    size_t bucket = std::min<size_t>(std::bit_width(static_cast<uint64_t>(us)), BUCKETS - 1);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sumUs.fetch_add(us, std::memory_order_relaxed);
+    int64_t max = maxUs.load(std::memory_order_relaxed);
+    while (us > max && !maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed));
+}
+
+double LatencyHistogram::getMeanUs() const {
+    uint64_t samples = getCount();
+    return samples == 0 ? 0 : static_cast<double>(sumUs.load(std::memory_order_relaxed)) / samples;
+}
+
+int64_t LatencyHistogram::getQuantileUs(double quantile) const {
+    uint64_t samples = getCount();
+    if (samples == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(quantile * samples + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // bucket i holds [2^(i-1), 2^i) us
+            return std::min((int64_t{1} << i) - 1, getMaxUs());
+        }
+    }
+    return getMaxUs();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sumUs.store(0, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+}
+
+LatencyTracer::LatencyTracer() : nextId(std::random_device{}()) {}
+
+LatencyTracer& LatencyTracer::instance() {
+    static LatencyTracer tracer;
+    return tracer;
+}
+
+int64_t LatencyTracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceContext LatencyTracer::begin() {
+    if (!isEnabled()) {
+        return {};
+    }
+    // ids start at a random offset so traces of different clients rarely collide
+    uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    if (id == 0) {
+        id = nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+    int64_t time = now();
+    return {.id = id, .origin = time, .stamp = time};
+}
+
+void LatencyTracer::record(TraceContext& trace, TraceStage stage) {
+    if (!trace.active()) {
+        return;
+    }
+    int64_t time = now();
+    histograms[static_cast<size_t>(stage)].add(time - trace.stamp);
+    trace.stamp = time;
+}
+
+void LatencyTracer::finish(TraceContext& trace, TraceStage stage) {
+    if (!trace.active()) {
+        return;
+    }
+    record(trace, stage);
+    histograms[static_cast<size_t>(TraceStage::END_TO_END)].add(trace.stamp - trace.origin);
+}
+
+const LatencyHistogram& LatencyTracer::getHistogram(TraceStage stage) const {
+    return histograms.at(static_cast<size_t>(stage));
+}
+
+void LatencyTracer::dump(std::ostream& out, const std::string& owner) const {
+    out << "[trace] " << owner << " latency (us)" << std::endl;
+    out << std::left << std::setw(20) << "  stage" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+        << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+    for (size_t i = 0; i < histograms.size(); i++) {
+        auto& histogram = histograms[i];
+        if (histogram.getCount() == 0) continue;
+        out << std::left << std::setw(20) << "  " + std::string(stageName(static_cast<TraceStage>(i))) << std::right
+            << std::setw(10) << histogram.getCount()
+            << std::setw(10) << std::fixed << std::setprecision(1) << histogram.getMeanUs()
+            << std::setw(10) << histogram.getQuantileUs(0.5)
+            << std::setw(10) << histogram.getQuantileUs(0.9)
+            << std::setw(10) << histogram.getQuantileUs(0.99)
+            << std::setw(10) << histogram.getMaxUs() << std::endl;
+    }
+    for (size_t i = 0; i < counters.size(); i++) {
+        uint64_t events = counters[i].load(std::memory_order_relaxed);
+        if (events == 0) continue;
+        out << std::left << std::setw(20) << "  " + std::string(counterName(static_cast<TraceCounter>(i))) << std::right
+            << std::setw(10) << events << std::endl;
+    }
+}
+
+void LatencyTracer::startReporter(std::chrono::seconds period, std::string owner) {
+    if (reporting.exchange(true)) {
+        return;
+    }
+    // the reporter only reads atomics of the process wide tracer, so it is left running until exit
+    std::thread([this, period, owner = std::move(owner)]() {
+        uint64_t reported = 0;
+        while (true) {
+            std::this_thread::sleep_for(period);
+            uint64_t recorded = 0;
+            for (auto& histogram : histograms) {
+                recorded += histogram.getCount();
+            }
+            for (auto& counter : counters) {
+                recorded += counter.load(std::memory_order_relaxed);
+            }
+            if (recorded != reported) {
+                reported = recorded;
+                dump(std::cout, owner);
+            }
+        }
+    }).detach();
+}
+
+void LatencyTracer::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+    for (auto& counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
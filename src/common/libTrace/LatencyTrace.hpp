@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// Seconds between histogram dumps of a traced process
+#define TRACE_REPORT_PERIOD 5
+
+/*
+    Optional end-to-end latency tracing of device events. A traced event carries a
+    TraceContext in SentHeader and Task_Info holding its id, the monotonic time of the
+    originating event and the time of the last stage it passed. Each stage records the
+    time since the previous stamp in a log2 histogram and restamps the context, so the
+    stages add up to the end-to-end latency recorded when the write reaches the device.
+    Stages crossing the network compare steady clocks of two processes, which is only
+    meaningful when master and clients share a host (bls load).
+*/
+
+// Ordered along the path of an event, from the sensor to the actuator
+enum class TraceStage : uint8_t {
+    // Reading and packing the states that raised the event
+    CLIENT_READ,
+    // Client send queue, network and the master network thread
+    NETWORK_TO_MASTER,
+    // Network manager to mailbox queue
+    MAILBOX_QUEUE,
+    // Dispatch of the state to the reader box of the task
+    READER_BOX,
+    // Trigger cache and execution manager queues
+    TRIGGER_QUEUE,
+    // Waiting on device ownership from the scheduler
+    SCHEDULER,
+    // Task execution in the VM
+    VM_EXEC,
+    // Execution manager to writer box queue
+    WRITER_QUEUE,
+    // Writer box to network manager, including writes held back for a callback
+    WRITER_BOX,
+    // Master send queue, network and the client listener
+    NETWORK_TO_CLIENT,
+    // Device strand and the driver write
+    CLIENT_WRITE,
+    // From the originating event to the completed write
+    END_TO_END,
+    COUNT
+};
+
+// Events counted next to the histograms, they are not tied to a trace
+enum class TraceCounter : uint8_t {
+    // Trigger events a bounded coalescing policy discarded
+    DROPPED_EVENTS,
+    // Trigger events replaced by a newer one under the latest policy
+    COALESCED_EVENTS,
+    COUNT
+};
+
+struct TraceContext {
+    uint32_t id = 0;
+    // steady clock ns of the originating event
+    int64_t origin = 0;
+    // steady clock ns of the last recorded stage
+    int64_t stamp = 0;
+
+    bool active() const { return id != 0; }
+};
+
+// Lock free histogram of latencies in power of two microsecond buckets
+class LatencyHistogram {
+    public:
+        static constexpr size_t BUCKETS = 40;
+
+        void add(int64_t ns);
+        uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+        double getMeanUs() const;
+        int64_t getMaxUs() const { return maxUs.load(std::memory_order_relaxed); }
+        // Upper bound of the bucket holding the quantile
+        int64_t getQuantileUs(double quantile) const;
+        void reset();
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> count = 0;
+        std::atomic<int64_t> sumUs = 0;
+        std::atomic<int64_t> maxUs = 0;
+};
+
+class LatencyTracer {
+    public:
+        static LatencyTracer& instance();
+
+        // Only enabled processes start traces, every process records the traces it receives
+        void enable() { enabled.store(true, std::memory_order_relaxed); }
+        bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+        static int64_t now();
+
+        // Starts a trace at an event source (inactive when tracing is disabled)
+        TraceContext begin();
+        // Records the time since the last stage of an active trace and restamps it
+        void record(TraceContext& trace, TraceStage stage);
+        // Records the last stage along with the end-to-end latency of the trace
+        void finish(TraceContext& trace, TraceStage stage);
+
+        void count(TraceCounter counter, uint64_t events = 1) {
+            counters[static_cast<size_t>(counter)].fetch_add(events, std::memory_order_relaxed);
+        }
+        uint64_t getCounter(TraceCounter counter) const {
+            return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        const LatencyHistogram& getHistogram(TraceStage stage) const;
+        void dump(std::ostream& out, const std::string& owner) const;
+        // Dumps the histograms every period while anything new was recorded
+        void startReporter(std::chrono::seconds period, std::string owner);
+        void reset();
+
+    private:
+        LatencyTracer();
+
+        std::atomic<bool> enabled = false;
+        std::atomic<uint32_t> nextId;
+        std::array<LatencyHistogram, static_cast<size_t>(TraceStage::COUNT)> histograms;
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(TraceCounter::COUNT)> counters{};
+        std::atomic<bool> reporting = false;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Serialization.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Fixed width bit mask sized at construction (one bit per bound device or trigger rule)
+*/
+class TriggerMask{
+    private: 
+        std::vector<uint64_t> words; 
+        size_t bitCount = 0; 
+
+    public: 
+        TriggerMask(size_t bits = 0) : words((bits + 63) / 64, 0), bitCount(bits) {}
+
+        void set(size_t bit){
+            this->words[bit >> 6] |= (uint64_t{1} << (bit & 63)); 
+        }
+
+        void reset(size_t bit){
+            this->words[bit >> 6] &= ~(uint64_t{1} << (bit & 63)); 
+        }
+
+        bool test(size_t bit) const{
+            return (this->words[bit >> 6] >> (bit & 63)) & 1; 
+        }
+
+        void clear(){
+            std::fill(this->words.begin(), this->words.end(), 0); 
+        }
+
+        // Returns true if every bit set in the other mask is also set in this one
+        bool covers(const TriggerMask& other) const{
+            for(size_t i = 0; i < this->words.size(); i++){
+                if((this->words[i] & other.words[i]) != other.words[i]){
+                    return false; 
+                }
+            }
+            return true; 
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const TriggerMask& mask){
+            for(size_t i = mask.bitCount; i > 0; i--){
+                os<<(mask.test(i - 1) ? '1' : '0'); 
+            }
+            return os; 
+        }
+}; 
+
+/*
+    Trigger rules of a single task, shared by the master mailbox and the client EM
+*/
+class TriggerManager{
+    private:   
+        // Devices seen since the last trigger along with the number of distinct devices among them
+        TriggerMask currentBitmap;  
+        size_t currentCount = 0; 
+        TriggerMask initBitmap; 
+        size_t initCount = 0; 
+        std::unordered_map<std::string, int> stringMap; 
+        std::vector<TriggerMask> ruleset; 
+        // Maps each device index to the rules that contain it (only these are tested on arrival)
+        std::vector<std::vector<int>> deviceRules; 
+        std::vector<TriggerData> trigData; 
+        TriggerMask excludedTriggers; 
+        // Maps trigger indices to integers
+        std::unordered_map<std::string, int> triggerIndexMap; 
+
+    
+    public: 
+        // Device Constructor (created rules)
+        TriggerManager(TaskDescriptor& TaskDesc){
+            for(DeviceDescriptor& devDesc : TaskDesc.binded_devices){
+                stringMap.try_emplace(devDesc.device_name, stringMap.size()); 
+            }
+
+            size_t deviceCount = stringMap.size(); 
+            this->currentBitmap = TriggerMask(deviceCount); 
+            this->initBitmap = TriggerMask(deviceCount); 
+            this->deviceRules.resize(deviceCount); 
+            this->trigData = TaskDesc.triggers; 
+            this->excludedTriggers = TriggerMask(TaskDesc.triggers.size()); 
+
+            int i = 0;
+            // Loop through rules; 
+            for(auto& data : TaskDesc.triggers)
+            {
+                auto& rule = data.rule;
+                TriggerMask king(deviceCount); 
+                for(auto& devName : rule){
+                    int devIndex = this->stringMap.at(devName); 
+                    if(!king.test(devIndex)){
+                        king.set(devIndex); 
+                        this->deviceRules[devIndex].push_back(i); 
+                    }
+                }       
+                this->triggerIndexMap[data.id] = i; 
+                ruleset.push_back(king); 
+                i++; 
+            }
+        }
+
+        private: 
+            // Tests the rules containing the arriving device and grabs the trigger rule with highest priority: 
+            bool testBit(int devIndex, int& id){
+                int max_priority = -1; 
+                for(int rule : this->deviceRules[devIndex]){
+                    if(this->excludedTriggers.test(rule)){
+                        continue;
+                    }
+
+                    if(this->currentBitmap.covers(this->ruleset[rule])){
+                        if(this->trigData[rule].priority > max_priority){
+                            max_priority = this->trigData[rule].priority;
+                            id = rule; 
+                        }
+                    }
+                }
+
+                // Check if the current bitmap holds the default rule (all devices)
+                return max_priority > 0 || this->currentCount == this->stringMap.size(); 
+            }
+
+        public: 
+            // Returns true if the new device corresponds to a trigger 
+            bool processDevice(std::string &object, int& trigger_id){
+                auto devEntry = this->stringMap.find(object); 
+                if(devEntry == this->stringMap.end()){
+                    return false; 
+                }
+                int devIndex = devEntry->second; 
+
+                if(this->initCount != this->stringMap.size()){
+                    if(!this->initBitmap.test(devIndex)){
+                        this->initBitmap.set(devIndex); 
+                        this->initCount++; 
+                    }
+                    // force a trigger when the map is init bitmap is filled
+                    if(this->initCount == this->stringMap.size()){
+                        // Code for initial trigger
+                        trigger_id = -1; 
+                        return true; 
+                    } 
+                    return false; 
+                }
+                
+                if(!this->currentBitmap.test(devIndex)){
+                    this->currentBitmap.set(devIndex); 
+                    this->currentCount++; 
+                }
+                bool found = this->testBit(devIndex, trigger_id); 
+                if(found){
+                    this->currentBitmap.clear(); 
+                    this->currentCount = 0; 
+    
+                    return true; 
+                }
+                return false; 
+            }
+
+            void debugPrintRules(){
+                for(auto& rule : this->ruleset){
+                    std::cout<<rule<<std::endl; 
+                }
+            }
+
+            void debugCurrentString(){
+                std::cout<<this->currentBitmap<<std::endl; 
+            }
+
+            void disableTrigger(std::string &triggerName){
+                int index = this->triggerIndexMap.at(triggerName); 
+                this->excludedTriggers.set(index); 
+            }
+
+            void enableTrigger(std::string &triggerName){
+                int index = this->triggerIndexMap.at(triggerName);
+                this->excludedTriggers.reset(index);
+            }
+
+            bool isInitialized() const {
+                return this->initCount == this->stringMap.size(); 
+            }
+
+            // Skips the initial trigger (used when rules are replaced on a running task)
+            void markInitialized(){
+                for(size_t i = 0; i < this->stringMap.size(); i++){
+                    this->initBitmap.set(i); 
+                }
+                this->initCount = this->stringMap.size(); 
+            }
+}; 
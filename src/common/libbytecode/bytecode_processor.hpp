@@ -52,7 +52,7 @@ class BytecodeProcessor {
         #undef OPCODE_END
 
         /* metadata */
-        std::unordered_map<uint16_t, std::pair<std::string, std::vector<std::string>>> functionMetadata;
+        std::unordered_map<uint32_t, std::pair<std::string, std::vector<std::string>>> functionMetadata;
         /* header data */
         std::vector<TaskDescriptor> taskDescs;
         /* literal pool */
@@ -88,6 +88,14 @@ inline void BytecodeProcessor<Derived, SkipMetadata>::loadBytecode(std::istream&
         throw std::runtime_error("Bad bytecode stream provided.");
     }
 
+    // Loading replaces any previously loaded program
+    functionMetadata.clear();
+    taskDescs.clear();
+    literalPool.clear();
+    instructions.clear();
+    instruction = 0;
+    signal = SIGNAL::START;
+
     readMetadata(bytecode);
     readHeader(bytecode);
     loadLiterals(bytecode);
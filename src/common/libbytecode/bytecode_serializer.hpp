@@ -5,6 +5,7 @@
 #include <ostream>
 #include <boost/archive/binary_oarchive.hpp>
 #include <ranges>
+#include <stdexcept>
 
 template<typename T, typename U>
 concept RangeOf = std::ranges::range<T> && std::is_same_v<std::ranges::range_value_t<T>, U>;
@@ -12,10 +13,10 @@ concept RangeOf = std::ranges::range<T> && std::is_same_v<std::ranges::range_val
 class BytecodeSerializer {
     public:
         BytecodeSerializer(std::ostream& stream) : stream(stream) { }
-        void writeMetadata(std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>>& functionSymbols);
+        void writeMetadata(std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>>& functionSymbols);
         void writeHeader(RangeOf<TaskDescriptor> auto&& taskDescriptors);
         void writeLiteralPool(RangeOf<BlsType> auto&& literals);
-        void writeLiteralPool(std::unordered_map<BlsType, uint8_t>& literalMap);
+        void writeLiteralPool(std::unordered_map<BlsType, uint16_t>& literalMap);
         void writeInstruction(INSTRUCTION& instruction);
 
     private:
@@ -28,10 +29,10 @@ inline boost::archive::binary_oarchive BytecodeSerializer::createArchiver() {
     return {stream, boost::archive::archive_flags::no_header};
 }
 
-inline void BytecodeSerializer::writeMetadata(std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>>& functionSymbols) {
+inline void BytecodeSerializer::writeMetadata(std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>>& functionSymbols) {
     uint32_t metadataEnd = 0;
     stream.write(reinterpret_cast<const char *>(&metadataEnd), sizeof(metadataEnd));
-    std::unordered_map<uint16_t, std::pair<std::string, std::vector<std::string>&>> functionMetadata;
+    std::unordered_map<uint32_t, std::pair<std::string, std::vector<std::string>&>> functionMetadata;
     for (auto&& [name, metadata] : functionSymbols) {
         functionMetadata.emplace(metadata.first, std::make_pair(name, std::ref(metadata.second)));
     }
@@ -44,6 +45,9 @@ inline void BytecodeSerializer::writeMetadata(std::unordered_map<std::string, st
 }
 
 inline void BytecodeSerializer::writeHeader(RangeOf<TaskDescriptor> auto&& taskDescriptors) {
+    if (taskDescriptors.size() > UINT16_MAX) {
+        throw std::runtime_error("Program exceeds the maximum of " + std::to_string(UINT16_MAX) + " tasks.");
+    }
     uint16_t descriptorCount = taskDescriptors.size();
     stream.write(reinterpret_cast<const char *>(&descriptorCount), sizeof(descriptorCount));
     auto oa = createArchiver();
@@ -53,6 +57,9 @@ inline void BytecodeSerializer::writeHeader(RangeOf<TaskDescriptor> auto&& taskD
 }
 
 inline void BytecodeSerializer::writeLiteralPool(RangeOf<BlsType> auto&& literals) {
+    if (literals.size() > UINT16_MAX) {
+        throw std::runtime_error("Program exceeds the maximum of " + std::to_string(UINT16_MAX) + " literals.");
+    }
     uint16_t poolSize = literals.size();
     stream.write(reinterpret_cast<const char *>(&poolSize), sizeof(poolSize));
     auto oa = createArchiver();
@@ -61,7 +68,7 @@ inline void BytecodeSerializer::writeLiteralPool(RangeOf<BlsType> auto&& literal
     }
 }
 
-inline void BytecodeSerializer::writeLiteralPool(std::unordered_map<BlsType, uint8_t>& literalMap) {
+inline void BytecodeSerializer::writeLiteralPool(std::unordered_map<BlsType, uint16_t>& literalMap) {
     auto literals = std::views::keys(literalMap);
     std::vector<BlsType> orderedLiterals(literals.begin(), literals.end());
     std::sort(orderedLiterals.begin(), orderedLiterals.end(), [&](const auto& a, const auto& b) {
@@ -7,7 +7,7 @@
  
 Connection::Connection(boost::asio::io_context &in_ctx, 
 tcp::socket socket ,Owner own_type, TSQ<OwnedSentMessage> &in_msg, std::string &ip_addr) 
-: ctx(in_ctx), socket(std::move(socket)), in_queue(in_msg)
+: ctx(in_ctx), socket(std::move(socket)), writeStrand(boost::asio::make_strand(in_ctx)), in_queue(in_msg)
     {
         for(int i = 0 ; i < IN_MSGSIZE ; i++){
             this->in_tickets.push_back(i); 
@@ -91,17 +91,63 @@ std::string& Connection::getIP(){
 }
 
 void Connection::send(SentMessage sm){
-    boost::asio::post(this->ctx, [this, sm](){
-        boost::asio::async_write(this->socket, std::array{
-            boost::asio::buffer(&sm.header, sizeof(SentHeader)),
-            boost::asio::buffer(sm.body.data(), sm.header.body_size)
-        },
-        [](boost::system::error_code ec, size_t) {
-            if (ec) {
-                std::cerr << "Error Writing Message: " << ec.message() << std::endl;
-            }
-        });
-    });
+    {
+        std::lock_guard<std::mutex> lock(this->filterMutex); 
+        if(this->outboundFilter && !this->outboundFilter(sm)){
+            return; 
+        }
+    }
+    std::vector<SentMessage> messages; 
+    messages.push_back(std::move(sm)); 
+    this->queueWrite(std::move(messages)); 
+}
+
+void Connection::sendBatch(std::vector<SentMessage> batch){
+    {
+        std::lock_guard<std::mutex> lock(this->filterMutex); 
+        if(this->outboundFilter){
+            std::erase_if(batch, [this](const SentMessage& sm){ return !this->outboundFilter(sm); }); 
+        }
+    }
+    if(batch.empty()){
+        return; 
+    }
+    this->queueWrite(std::move(batch)); 
+}
+
+// Sends and batches share one queue so the bytes of two messages never interleave on the socket
+void Connection::queueWrite(std::vector<SentMessage> messages){
+    boost::asio::post(this->writeStrand, [this, messages = std::move(messages)]() mutable {
+        bool idle = this->pendingWrites.empty(); 
+        this->pendingWrites.push_back(std::move(messages)); 
+        if(idle){
+            this->writeNext(); 
+        }
+    }); 
+}
+
+void Connection::writeNext(){
+    // The messages stay at the front of the queue (and alive) until the write completes
+    std::vector<boost::asio::const_buffer> buffers; 
+    for(auto& sm : this->pendingWrites.front()){
+        buffers.push_back(boost::asio::buffer(&sm.header, sizeof(SentHeader))); 
+        buffers.push_back(boost::asio::buffer(sm.body.data(), sm.header.body_size)); 
+    }
+    boost::asio::async_write(this->socket, buffers, boost::asio::bind_executor(this->writeStrand,
+    [this](boost::system::error_code ec, size_t) {
+        if (ec) {
+            std::cerr << "Error Writing Message: " << ec.message() << std::endl;
+        }
+        this->pendingWrites.pop_front(); 
+        if(!this->pendingWrites.empty()){
+            this->writeNext(); 
+        }
+    }));
+}
+
+void Connection::setOutboundFilter(std::function<bool(const SentMessage&)> filter){
+    std::lock_guard<std::mutex> lock(this->filterMutex); 
+    this->outboundFilter = std::move(filter); 
 }
 
 std::string& Connection::getName(){
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <boost/asio.hpp>
 #include "TSQ.hpp"
 #include "Protocol.hpp"
+#include <functional>
 #include <memory>
 #include <list>
+#include <mutex>
+#include <vector>
 
 #define IN_MSGSIZE 256
 
@@ -22,6 +26,10 @@ class Connection : public std::enable_shared_from_this<Connection>{
     private: 
         boost::asio::io_context &ctx; 
         tcp::socket socket;
+        // Writes are only started from this strand, one at a time
+        boost::asio::strand<boost::asio::io_context::executor_type> writeStrand; 
+        // Messages of each send or batch, the front one is being written
+        std::deque<std::vector<SentMessage>> pendingWrites; 
         Owner own; 
         std::string ip;
         std::string client_name; 
@@ -35,7 +43,14 @@ class Connection : public std::enable_shared_from_this<Connection>{
         TSQ<SentMessage> out_queue; 
         TSQ<OwnedSentMessage> &in_queue; 
 
+        // Decides whether an outgoing message is put on the wire (unset sends everything)
+        std::function<bool(const SentMessage&)> outboundFilter; 
+        // Held while the filter runs, so replacing it waits for every send still inside the old one
+        std::mutex filterMutex; 
+
         // Async Reader Writer functions: 
+        void queueWrite(std::vector<SentMessage> messages); 
+        void writeNext(); 
         void addToQueue(int index); 
         void readHeader(); 
         void readBody(int index); 
@@ -55,8 +70,12 @@ class Connection : public std::enable_shared_from_this<Connection>{
 
         std::string& getIP(); 
         void send(SentMessage sm); 
+        // Puts every message on the wire with a single write
+        void sendBatch(std::vector<SentMessage> batch); 
         std::string& getName(); 
         void setName(std::string& cname); 
+        // Once this returns no send is still running the previous filter
+        void setOutboundFilter(std::function<bool(const SentMessage&)> filter); 
 
         // Used to connect Master to external APIs (phase 3)
         void connectToServer(boost::asio::ip::tcp::resolver::results_type &results); 
@@ -53,7 +53,12 @@ enum class Protocol : uint8_t{
     
 
     // Client Loop back
-    CONNECTION_LOST 
+    CONNECTION_LOST, 
+
+    // Appended so the values of the messages above stay the same on the wire
+    // (Master -> Client)
+    OWNER_LEASE, 
+    LOAD_PROGRAM, 
 }; 
 
 enum class ERROR_T{
@@ -113,6 +118,9 @@ struct SentHeader{
 
     // Set by client
     float volatility = 0; 
+
+    // Latency trace of the event that produced the message (inactive unless tracing)
+    TraceContext trace; 
 }; 
 
 // Sending message this is what is actually sent over the internet
@@ -1,6 +1,7 @@
 #pragma once
 #include "DynamicMessage.hpp"
 #include "bls_types.hpp"
+#include "LatencyTrace.hpp"
 #include <boost/functional/hash.hpp>
 #include <boost/range/combine.hpp>
 #include <boost/serialization/vector.hpp>
@@ -46,7 +47,10 @@ enum class PROTOCOLS
     QUEUE_EMPTY, 
 
     // MM->EM (Forward data to a waiting device)
-    WAIT_STATE_FORWARD
+    WAIT_STATE_FORWARD, 
+
+    // EM -> MM
+    OWNER_LEASE
    
 };
 
@@ -62,6 +66,14 @@ enum class OVERWRITE_POLICY : uint8_t {
     NONE, 
 };
 
+// Applied when a task is triggered faster than it executes
+enum class COALESCE_POLICY : uint8_t {
+    NONE,           // keep every event
+    LATEST,         // replace the queued event with the newest one
+    FIFO,           // keep the oldest events, reject new ones once full
+    DROP_OLDEST,    // keep the newest events, evict the oldest once full
+};
+
 enum class PORTTYPE : uint8_t {
     GPIO, 
     I2C,
@@ -91,7 +103,7 @@ struct DeviceDescriptor {
     OVERWRITE_POLICY overwritePolicy = OVERWRITE_POLICY::NONE;
     bool isYield = true; 
     int polling_period = -1; // dynamic polling doesnt need a period
-    bool isConst = true; // disable dynamic polling subsystem for now, default to 1000ms poll in client
+    bool isConst = false; // polling devices without a constPoll rate are polled at the rate the master adapts
     bool ignoreWriteBacks = false; 
     /* 
         If the device is registered as a trigger then the execution of 
@@ -175,16 +187,54 @@ struct TriggerData {
     bool operator==(const TriggerData&) const = default;
 };
 
+// Task folded into a fused task, run in order on its own subset of the fused devices
+struct FusedTaskData {
+    std::string name;
+    uint32_t bytecode_offset = 0; // instruction index, as wide as the widest jump and call operands
+    // Position in the fused binded_devices of each of the member's parameters
+    std::vector<uint16_t> devicePositions;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar & name;
+        ar & bytecode_offset;
+        ar & devicePositions;
+    }
+
+    bool operator==(const FusedTaskData&) const = default;
+};
+
+// Threshold a task compares a device attribute against, the master polls the device faster as it gets close
+struct PollCondition {
+    std::string device;
+    std::string attribute;
+    double threshold = 0;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar & device;
+        ar & attribute;
+        ar & threshold;
+    }
+
+    bool operator==(const PollCondition&) const = default;
+};
+
 struct TaskDescriptor {
 
     std::string name = "";
     std::vector<DeviceDescriptor> binded_devices = {}; 
-    int bytecode_offset = 0; 
+    uint32_t bytecode_offset = 0; // instruction index, as wide as the widest jump and call operands
     std::vector<DeviceDescriptor> inDevices = {};
     std::vector<DeviceDescriptor> outDevices = {}; 
     std::string hostController = "MASTER";
 
     std::vector<TriggerData> triggers = {};
+    COALESCE_POLICY coalescePolicy = COALESCE_POLICY::NONE;
+    uint32_t coalesceDepth = 0; // queue bound for FIFO and DROP_OLDEST
+    std::vector<FusedTaskData> fusedTasks = {}; // empty unless several tasks were fused into this one
+    bool deferOwnership = false; // run before acquiring out devices and only acquire them if a state was modified
+    std::vector<PollCondition> pollConditions = {};
 
     template<typename Archive>
     void serialize(Archive& ar, const unsigned int version [[ maybe_unused ]]) {
@@ -195,6 +245,11 @@ struct TaskDescriptor {
         ar & outDevices;
         ar & hostController;
         ar & triggers;
+        ar & coalescePolicy;
+        ar & coalesceDepth;
+        ar & fusedTasks;
+        ar & deferOwnership;
+        ar & pollConditions;
     }
 
     bool operator==(const TaskDescriptor&) const = default;
@@ -232,6 +287,8 @@ struct Task_Info
     std::string controller;
     bool isVtype = false;
     int priority; 
+    // Follows the event through the master (see LatencyTrace.hpp)
+    TraceContext trace; 
 };
 
 struct DynamicMasterMessage
@@ -397,6 +454,42 @@ inline TriggerData tag_invoke(const boost::json::value_to_tag<TriggerData>&, boo
     return trigger;
 }
 
+inline void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, FusedTaskData const & fused) {
+    using namespace boost::json;
+    auto& obj = jv.emplace_object();
+    obj.emplace("name", value_from(fused.name));
+    obj.emplace("bytecode_offset", value_from(fused.bytecode_offset));
+    obj.emplace("devicePositions", value_from(fused.devicePositions));
+}
+
+inline FusedTaskData tag_invoke(const boost::json::value_to_tag<FusedTaskData>&, boost::json::value const& jv) {
+    using namespace boost::json;
+    auto& obj = jv.as_object();
+    FusedTaskData fused;
+    fused.name = value_to<std::string>(obj.at("name"));
+    fused.bytecode_offset = value_to<uint32_t>(obj.at("bytecode_offset"));
+    fused.devicePositions = value_to<std::vector<uint16_t>>(obj.at("devicePositions"));
+    return fused;
+}
+
+inline void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, PollCondition const & cond) {
+    using namespace boost::json;
+    auto& obj = jv.emplace_object();
+    obj.emplace("device", value_from(cond.device));
+    obj.emplace("attribute", value_from(cond.attribute));
+    obj.emplace("threshold", value_from(cond.threshold));
+}
+
+inline PollCondition tag_invoke(const boost::json::value_to_tag<PollCondition>&, boost::json::value const& jv) {
+    using namespace boost::json;
+    auto& obj = jv.as_object();
+    PollCondition cond;
+    cond.device = value_to<std::string>(obj.at("device"));
+    cond.attribute = value_to<std::string>(obj.at("attribute"));
+    cond.threshold = value_to<double>(obj.at("threshold"));
+    return cond;
+}
+
 inline void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, TaskDescriptor const & desc) {
     using namespace boost::json;
     auto& obj = jv.emplace_object();
@@ -407,6 +500,11 @@ inline void tag_invoke(const boost::json::value_from_tag&, boost::json::value& j
     obj.emplace("outDevices", value_from(desc.outDevices));
     obj.emplace("hostController", value_from(desc.hostController));
     obj.emplace("triggers", value_from(desc.triggers));
+    obj.emplace("coalescePolicy", value_from(static_cast<uint8_t>(desc.coalescePolicy)));
+    obj.emplace("coalesceDepth", value_from(desc.coalesceDepth));
+    obj.emplace("fusedTasks", value_from(desc.fusedTasks));
+    obj.emplace("deferOwnership", value_from(desc.deferOwnership));
+    obj.emplace("pollConditions", value_from(desc.pollConditions));
 }
 
 inline TaskDescriptor tag_invoke(const boost::json::value_to_tag<TaskDescriptor>&, boost::json::value const& jv) {
@@ -415,10 +513,21 @@ inline TaskDescriptor tag_invoke(const boost::json::value_to_tag<TaskDescriptor>
     TaskDescriptor desc;
     desc.name = value_to<std::string>(obj.at("name"));
     desc.binded_devices = value_to<std::vector<DeviceDescriptor>>(obj.at("binded_devices"));
-    desc.bytecode_offset = value_to<int>(obj.at("bytecode_offset"));
+    desc.bytecode_offset = value_to<uint32_t>(obj.at("bytecode_offset"));
     desc.inDevices = value_to<std::vector<DeviceDescriptor>>(obj.at("inDevices"));
     desc.outDevices = value_to<std::vector<DeviceDescriptor>>(obj.at("outDevices"));
     desc.hostController = value_to<std::string>(obj.at("hostController"));
     desc.triggers = value_to<std::vector<TriggerData>>(obj.at("triggers"));
+    desc.coalescePolicy = static_cast<COALESCE_POLICY>(value_to<uint8_t>(obj.at("coalescePolicy")));
+    desc.coalesceDepth = value_to<uint32_t>(obj.at("coalesceDepth"));
+    if (auto* fusedTasks = obj.if_contains("fusedTasks")) {
+        desc.fusedTasks = value_to<std::vector<FusedTaskData>>(*fusedTasks);
+    }
+    if (auto* deferOwnership = obj.if_contains("deferOwnership")) {
+        desc.deferOwnership = value_to<bool>(*deferOwnership);
+    }
+    if (auto* pollConditions = obj.if_contains("pollConditions")) {
+        desc.pollConditions = value_to<std::vector<PollCondition>>(*pollConditions);
+    }
     return desc;
 }
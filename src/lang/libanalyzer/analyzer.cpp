@@ -98,7 +98,7 @@ BlsObject Analyzer::visit(AstNode::Function::Procedure& ast) {
     auto& procedureSymbols = functionSymbols.at(procedureName).second;
     procedureSymbols.reserve(params.size());
     for (int i = 0; i < params.size(); i++) {
-        cs.addLocal(params.at(i), parameterTypes.at(i));
+        addLocal(params.at(i), parameterTypes.at(i));
         procedureSymbols.push_back(params.at(i));
     }
     for (auto&& statement : ast.statements) {
@@ -126,7 +126,7 @@ BlsObject Analyzer::visit(AstNode::Function::Task& ast) {
     taskSymbols.reserve(params.size());
     for (int i = 0; i < params.size(); i++) {
         parameterIndices.emplace(params.at(i), i);
-        cs.addLocal(params.at(i), parameterTypes.at(i));
+        addLocal(params.at(i), parameterTypes.at(i));
         taskSymbols.push_back(params.at(i));
     }
     tasks.emplace(taskName, FunctionSignature(taskName, std::monostate(), parameterTypes, parameterIndices));
@@ -400,7 +400,7 @@ BlsObject Analyzer::visit(AstNode::Statement::Declaration& ast) {
             typedObj.assign(literal);
         }
     }
-    cs.addLocal(name, typedObj);
+    addLocal(name, typedObj);
     ast.localIndex = cs.getLocalIndex(name);
     functionSymbols.at(cs.getFrameName()).second.push_back(name);
     return std::monostate();
@@ -1132,6 +1132,45 @@ BlsObject Analyzer::visit(AstNode::Initializer::Task& ast) {
             }
         }
     }
+    else if (option == "coalescePolicy") {
+        if (args.empty() || args.size() > 2) {
+            throw SemanticError("coalescePolicy must be supplied a policy name and an optional queue depth.", ast);
+        }
+        auto* policyExpr = dynamic_cast<AstNode::Expression::Literal*>(args.at(0).get());
+        if (!policyExpr || !std::holds_alternative<std::string>(policyExpr->literal)) {
+            throw SemanticError("Coalesce policy must be a string literal.", ast);
+        }
+        auto policy = std::get<std::string>(policyExpr->literal);
+        if (policy == "latest") {
+            desc.coalescePolicy = COALESCE_POLICY::LATEST;
+        }
+        else if (policy == "fifo") {
+            desc.coalescePolicy = COALESCE_POLICY::FIFO;
+        }
+        else if (policy == "dropOldest") {
+            desc.coalescePolicy = COALESCE_POLICY::DROP_OLDEST;
+        }
+        else {
+            throw SemanticError("Coalesce policy must be either \"latest\", \"fifo\", or \"dropOldest\".", ast);
+        }
+
+        if (desc.coalescePolicy == COALESCE_POLICY::LATEST) {
+            if (args.size() != 1) {
+                throw SemanticError("The latest coalesce policy does not take a queue depth.", ast);
+            }
+            desc.coalesceDepth = 1;
+        }
+        else {
+            if (args.size() != 2) {
+                throw SemanticError("Bounded coalesce policies must be supplied a queue depth.", ast);
+            }
+            auto* depthExpr = dynamic_cast<AstNode::Expression::Literal*>(args.at(1).get());
+            if (!depthExpr || !std::holds_alternative<int64_t>(depthExpr->literal) || std::get<int64_t>(depthExpr->literal) <= 0) {
+                throw SemanticError("Coalesce queue depth must be a positive integer literal.", ast);
+            }
+            desc.coalesceDepth = std::get<int64_t>(depthExpr->literal);
+        }
+    }
     else {
         throw SemanticError("Invalid task configuration option: " + option + ".", ast);
     }
@@ -32,7 +32,20 @@ namespace BlsLang {
             auto& getFunctionSymbols() { return functionSymbols; }
 
         private:
-            void addToPool(BlsType literal) { if (!literalPool.contains(literal)) literalPool.emplace(literal, literalPool.size()); }
+            // Pool and local indices are encoded as at most 16 bit operands
+            void addToPool(BlsType literal) {
+                if (literalPool.contains(literal)) return;
+                if (literalPool.size() > UINT16_MAX) {
+                    throw RuntimeError("Program exceeds the maximum of " + std::to_string(UINT16_MAX + 1) + " distinct literals.");
+                }
+                literalPool.emplace(literal, literalPool.size());
+            }
+            void addLocal(const std::string& name, BlsType value) {
+                if (cs.getLocalCount() > UINT16_MAX) {
+                    throw RuntimeError("Function exceeds the maximum of " + std::to_string(UINT16_MAX + 1) + " local variables.");
+                }
+                cs.addLocal(name, value);
+            }
 
             struct FunctionSignature {
                 std::string name;
@@ -65,8 +78,8 @@ namespace BlsLang {
             std::unordered_map<std::string, TaskDescriptor> taskDescriptors;
             std::vector<TaskDescriptor> boundTasks;
             std::unordered_map<std::string, std::vector<std::reference_wrapper<TaskDescriptor>>> boundTaskMap;
-            std::unordered_map<BlsType, uint8_t> literalPool;
-            std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>> functionSymbols;
+            std::unordered_map<BlsType, uint16_t> literalPool;
+            std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>> functionSymbols;
             AstNode* currentNode = nullptr;
     };
 
@@ -0,0 +1,219 @@
+#include "compile_cache.hpp"
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/unordered_set.hpp>
+#include <boost/serialization/vector.hpp>
+
+using namespace BlsLang;
+
+namespace boost::serialization {
+    template<typename Archive>
+    void serialize(Archive& ar, AstCondition& cond, const unsigned int) {
+        ar & cond.device;
+        ar & cond.attribute;
+        ar & cond.threshold;
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, AstTaskDesc& desc, const unsigned int) {
+        ar & desc.name;
+        ar & desc.inDeviceList;
+        ar & desc.outDeviceList;
+        ar & desc.readAttributes;
+        ar & desc.writtenAttributes;
+        ar & desc.unconditionalOutDevices;
+        ar & desc.hasSideEffects;
+        ar & desc.readsTrigger;
+        ar & desc.conditions;
+        ar & desc.deviceAliasMap;
+        ar & desc.bindedDevices;
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, AstDeviceDesc& desc, const unsigned int) {
+        ar & desc.name;
+        ar & desc.ctl_name;
+        ar & desc.inTaskList;
+        ar & desc.outTaskList;
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, GlobalContext& context, const unsigned int) {
+        ar & context.taskConnections;
+        ar & context.deviceConnections;
+    }
+}
+
+namespace {
+    // Hash of the compiler sources (set by the build), so entries from any other build are never loaded
+    constexpr uint64_t BUILD_ID = BLS_COMPILER_BUILD_ID;
+    constexpr std::array<char, 8> MAGIC = {'B', 'L', 'S', 'C', 'A', 'C', 'H', 'E'};
+
+    struct EntryHeader {
+        std::array<char, 8> magic;
+        uint64_t buildId;
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        uint64_t bytecodeSize;
+        uint64_t contextSize;
+    };
+
+    // Read only stream over a mapped entry
+    class MemoryBuffer : public std::streambuf {
+        public:
+            MemoryBuffer(const char* data, size_t size) {
+                auto* begin = const_cast<char*>(data);
+                setg(begin, begin, begin + size);
+            }
+    };
+
+    // FNV-1a, stable across builds unlike std::hash
+    uint64_t fnv1a(uint64_t seed, const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            seed ^= static_cast<unsigned char>(data[i]);
+            seed *= 0x100000001b3;
+        }
+        return seed;
+    }
+}
+
+uint64_t CompileCache::hashSource(const std::string& source) {
+    uint64_t seed = 0xcbf29ce484222325;
+    uint64_t buildId = BUILD_ID;
+    seed = fnv1a(seed, reinterpret_cast<const char*>(&buildId), sizeof(buildId));
+    // entries written by a different toolchain may lay out serialized data differently
+    seed = fnv1a(seed, __VERSION__, sizeof(__VERSION__));
+    return fnv1a(seed, source.data(), source.size());
+}
+
+std::filesystem::path CompileCache::defaultDirectory() {
+    std::error_code ec;
+    auto temp = std::filesystem::temp_directory_path(ec);
+    return (ec ? std::filesystem::path(".") : temp) / "bls_cache";
+}
+
+std::filesystem::path CompileCache::getEntryPath(const std::string& source) const {
+    std::stringstream name;
+    name << std::hex << hashSource(source) << ".blc";
+    return directory / name.str();
+}
+
+std::optional<CompiledProgram> CompileCache::load(const std::string& source) const {
+    namespace bip = boost::interprocess;
+    auto path = getEntryPath(source);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return std::nullopt;
+    }
+
+    try {
+        bip::file_mapping file(path.c_str(), bip::read_only);
+        // the region stays valid after the file mapping is closed
+        auto region = std::make_shared<bip::mapped_region>(file, bip::read_only);
+        auto* data = static_cast<const char*>(region->get_address());
+        size_t size = region->get_size();
+
+        EntryHeader header;
+        if (size < sizeof(header)) {
+            return std::nullopt;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != MAGIC
+         || header.buildId != BUILD_ID
+         || header.sourceHash != hashSource(source)
+         || header.sourceSize != source.size()
+         || sizeof(header) + header.sourceSize + header.bytecodeSize + header.contextSize != size) {
+            return std::nullopt;
+        }
+
+        // the full source is kept so a hash collision can never load the wrong program
+        auto* sourceSection = data + sizeof(header);
+        if (std::memcmp(sourceSection, source.data(), source.size()) != 0) {
+            return std::nullopt;
+        }
+        auto* bytecodeSection = sourceSection + header.sourceSize;
+        auto* contextSection = bytecodeSection + header.bytecodeSize;
+
+        CompiledProgram program;
+        program.bytecode = std::span<const char>(bytecodeSection, header.bytecodeSize);
+        program.mapping = region;
+        MemoryBuffer contextBuffer(contextSection, header.contextSize);
+        std::istream contextStream(&contextBuffer);
+        boost::archive::binary_iarchive ia(contextStream, boost::archive::archive_flags::no_header);
+        ia >> program.taskDescriptors;
+        ia >> program.globalContext;
+        ia >> program.taskFingerprints;
+        return program;
+    }
+    catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+void CompileCache::store(const std::string& source, const CompiledProgram& program) const {
+    std::filesystem::path tempPath;
+    try {
+        std::ostringstream context(std::ios::binary);
+        {
+            boost::archive::binary_oarchive oa(context, boost::archive::archive_flags::no_header);
+            oa << program.taskDescriptors;
+            oa << program.globalContext;
+            oa << program.taskFingerprints;
+        }
+        auto contextView = context.view();
+
+        EntryHeader header{};
+        header.magic = MAGIC;
+        header.buildId = BUILD_ID;
+        header.sourceHash = hashSource(source);
+        header.sourceSize = source.size();
+        header.bytecodeSize = program.bytecode.size();
+        header.contextSize = contextView.size();
+
+        std::filesystem::create_directories(directory);
+        auto path = getEntryPath(source);
+        // written beside the entry and renamed so readers never map a partial file
+        tempPath = path;
+        tempPath += "." + std::to_string(std::random_device{}()) + ".tmp";
+        {
+            std::ofstream entry(tempPath, std::ios::binary | std::ios::trunc);
+            entry.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            entry.write(source.data(), source.size());
+            entry.write(program.bytecode.data(), program.bytecode.size());
+            entry.write(contextView.data(), contextView.size());
+            if (!entry) {
+                throw std::ios_base::failure("Could not write cache entry");
+            }
+        }
+        std::filesystem::rename(tempPath, path);
+    }
+    catch (const std::exception&) {
+        // never leave a partial entry behind
+        if (!tempPath.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include "program_diff.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace BlsLang {
+
+    // Compiler outputs that are read back after a compile
+    struct CompiledProgram {
+        // Points into the mapped entry after a load, which mapping keeps alive
+        std::span<const char> bytecode;
+        std::vector<TaskDescriptor> taskDescriptors;
+        GlobalContext globalContext;
+        TaskFingerprints taskFingerprints;
+        std::shared_ptr<const void> mapping;
+    };
+
+    /*
+        On-disk cache of compiled programs keyed by a hash of the source and the compiler build.
+        An entry is a fixed header followed by the source, the raw bytecode and the serialized
+        compiler context. A hit maps the file, compares the source in place, leaves the bytecode
+        in the mapping and deserializes the context straight from it.
+    */
+    class CompileCache {
+        public:
+            CompileCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+            std::optional<CompiledProgram> load(const std::string& source) const;
+            // Write failures are ignored since the cache is only an optimization
+            void store(const std::string& source, const CompiledProgram& program) const;
+
+            std::filesystem::path getEntryPath(const std::string& source) const;
+            static uint64_t hashSource(const std::string& source);
+            // Shared cache location under the system temporary directory
+            static std::filesystem::path defaultDirectory();
+
+        private:
+            std::filesystem::path directory;
+    };
+
+}
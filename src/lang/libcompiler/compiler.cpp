@@ -1,10 +1,17 @@
 #include "compiler.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <span>
 #include <sstream>
 #include <tuple>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/container_hash/hash.hpp>
 #include <boost/range/combine.hpp>
 #include <variant>
 #include <vector>
@@ -12,6 +19,17 @@
 
 using namespace BlsLang;
 
+namespace {
+    void writeOutput(std::span<const char> bytecode, Compiler::ostream_t& outputStream) {
+        if (auto* vector = std::get_if<std::reference_wrapper<std::vector<char>>>(&outputStream)) {
+            vector->get().assign(bytecode.begin(), bytecode.end());
+        }
+        else {
+            std::get<std::reference_wrapper<std::ostream>>(outputStream).get().write(bytecode.data(), bytecode.size());
+        }
+    }
+}
+
 void Compiler::compileFile(const std::string& source, ostream_t outputStream) {
     std::ifstream file;
     file.open(source);
@@ -23,18 +41,133 @@ void Compiler::compileFile(const std::string& source, ostream_t outputStream) {
     compileSource(ss.str(), outputStream);
 }
 
+// The compiled AST keeps the ranges of the full program, so the slice is analyzed and generated from a fresh parse
+void Compiler::compileSlice(std::vector<TaskDescriptor>& tasks, std::vector<char>& bytecode) {
+    requireCompiled("program slices");
+    Parser sliceParser;
+    auto sliceAst = sliceParser.parse(tokens);
+    Analyzer sliceAnalyzer;
+    sliceAst->accept(sliceAnalyzer);
+
+    auto inSlice = [&tasks](const TaskDescriptor& bound) {
+        return std::ranges::any_of(tasks, [&bound](const TaskDescriptor& task) { return task.name == bound.name; });
+    };
+    std::vector<TaskDescriptor> sliceTasks;
+    std::ranges::copy_if(sliceAnalyzer.getBoundTasks(), std::back_inserter(sliceTasks), inSlice);
+    std::unordered_map<std::string, std::vector<std::reference_wrapper<TaskDescriptor>>> sliceTaskMap;
+    for (auto& task : sliceTasks) {
+        sliceTaskMap[task.name].push_back(task);
+    }
+
+    Generator sliceGenerator(sliceTasks, sliceTaskMap, sliceAnalyzer.getLiteralPool(), sliceAnalyzer.getFunctionSymbols());
+    sliceAst->accept(sliceGenerator);
+    sliceGenerator.writeBytecode(bytecode);
+    for (auto& task : tasks) {
+        task.bytecode_offset = sliceTaskMap.at(task.name).at(0).get().bytecode_offset;
+    }
+}
+
+void Compiler::fingerprintTasks() {
+    auto& source = static_cast<AstNode::Source&>(*ast);
+    std::vector<size_t> procedureSeeds(source.procedures.size());
+    std::vector<size_t> taskSeeds(source.tasks.size());
+    std::vector<std::pair<const AstNode*, size_t*>> nodes;
+    for (size_t i = 0; i < source.procedures.size(); i++) {
+        nodes.emplace_back(source.procedures[i].get(), &procedureSeeds[i]);
+    }
+    for (size_t i = 0; i < source.tasks.size(); i++) {
+        nodes.emplace_back(source.tasks[i].get(), &taskSeeds[i]);
+    }
+
+    // Top level nodes never overlap, so in source order each one is the next slice of the token stream
+    auto position = [](size_t line, size_t column) { return std::pair<size_t, size_t>{line, column}; };
+    std::ranges::sort(nodes, {}, [&](auto& node) { return position(node.first->lineStart, node.first->columnStart); });
+    auto token = tokens.begin();
+    for (auto& [node, seed] : nodes) {
+        auto start = position(node->lineStart, node->columnStart);
+        auto end = position(node->lineEnd, node->columnEnd);
+        while (token != tokens.end() && position(token->getLineStart(), token->getColStart()) < start) {
+            ++token;
+        }
+        // Comments and whitespace are not tokens of the node, so reformatting keeps its fingerprint
+        for (; token != tokens.end() && position(token->getLineStart(), token->getColStart()) <= end; ++token) {
+            if (token->getType() == Token::Type::COMMENT) {
+                continue;
+            }
+            boost::hash_combine(*seed, token->getType());
+            boost::hash_combine(*seed, token->getLiteral());
+        }
+    }
+
+    // Call targets are absolute, so any procedure edit conservatively changes every task
+    size_t procedureSeed = 0;
+    for (auto seed : procedureSeeds) {
+        boost::hash_combine(procedureSeed, seed);
+    }
+
+    for (size_t i = 0; i < source.tasks.size(); i++) {
+        size_t seed = procedureSeed;
+        boost::hash_combine(seed, taskSeeds[i]);
+        taskFingerprints[source.tasks[i]->name] = seed;
+    }
+}
+
 void Compiler::compileSource(const std::string& source, ostream_t outputStream) {
+    cachedProgram.reset();
+    cachedTaskMap.clear();
+    if (cache) {
+        auto program = cache->load(source);
+        // Entries stored without fingerprints cannot serve a compile that diffs reloads
+        if (program && fingerprinting && program->taskFingerprints.empty() && !program->taskDescriptors.empty()) {
+            program.reset();
+        }
+        if (program) {
+            cachedProgram = std::move(program);
+            for (auto& task : cachedProgram->taskDescriptors) {
+                cachedTaskMap[task.name].push_back(task);
+            }
+            writeOutput(cachedProgram->bytecode, outputStream);
+            return;
+        }
+    }
+
     tokens = lexer.lex(source);
     ast = parser.parse(tokens);
+    taskFingerprints.clear();
+    if (fingerprinting) {
+        fingerprintTasks();
+    }
+    // analysis registers signatures and literals in declaration order, so it stays sequential
     ast->accept(analyzer);
-    ast->accept(generator);
-    if (auto* stream = std::get_if<std::reference_wrapper<std::vector<char>>>(&outputStream)) {
+    if (compileThreads > 1) {
+        boost::asio::thread_pool pool(compileThreads);
+        // the dependency graph only reads the AST and can be built alongside the generated bodies
+        std::packaged_task<void()> depGraphJob([this]() { ast->accept(depGraph); });
+        auto depGraphResult = depGraphJob.get_future();
+        boost::asio::post(pool, std::move(depGraphJob));
+        generator.generateConcurrently(static_cast<AstNode::Source&>(*ast), pool);
+        depGraphResult.get();
+    }
+    else {
+        ast->accept(generator);
+    }
+    std::vector<char> bytecode;
+    if (cache) {
+        generator.writeBytecode(bytecode);
+        writeOutput(bytecode, outputStream);
+    }
+    else if (auto* stream = std::get_if<std::reference_wrapper<std::vector<char>>>(&outputStream)) {
         generator.writeBytecode(*stream);
     }
     else {
         generator.writeBytecode(std::get<std::reference_wrapper<std::ostream>>(outputStream));
     }
-    ast->accept(this->depGraph);
+    if (compileThreads == 1) {
+        ast->accept(this->depGraph);
+    }
+    if (cache) {
+        cache->store(source, {bytecode, analyzer.getBoundTasks(), depGraph.getGlobalContext(), taskFingerprints});
+    }
     // auto tempTask = this->depGraph.getTaskMap();  
 
 
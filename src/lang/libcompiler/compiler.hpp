@@ -1,5 +1,6 @@
 #pragma once
 #include "ast.hpp"
+#include "compile_cache.hpp"
 #include "Serialization.hpp"
 #include "generator.hpp"
 #include "lexer.hpp"
@@ -9,8 +10,17 @@
 #include "depgraph.hpp"
 #include "symgraph.hpp"
 #include "divider.hpp"
+#include "program_diff.hpp"
 #include "token.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -28,13 +38,32 @@ namespace BlsLang {
 
             void compileFile(const std::string& source, ostream_t outputStream = std::cout);
             void compileSource(const std::string& source, ostream_t outputStream = std::cout);
-            auto& getAst() { return ast; }
-            auto& getTaskDescriptors() { return analyzer.getBoundTasks(); }
-            auto& getTaskDescriptorMap() { return analyzer.getBoundTaskMap(); }
-            auto getTaskContexts(){return depGraph.getTaskMap();}
-            auto getGlobalContext() {return depGraph.getGlobalContext();}
+            // Generates a program holding only tasks (and every procedure) and points their offsets into it
+            void compileSlice(std::vector<TaskDescriptor>& tasks, std::vector<char>& bytecode);
+            // Reuses compiled programs stored in directory (getAst, getTaskContexts and compileSlice throw after a hit)
+            void setCacheDirectory(std::filesystem::path directory) { cache.emplace(std::move(directory)); }
+            // Generates function bodies and the dependency graph on up to threads workers (1 compiles sequentially)
+            void setCompileThreads(size_t threads) { compileThreads = std::max<size_t>(threads, 1); }
+            // Computes the task fingerprints needed to diff reloads (off by default)
+            void setFingerprinting(bool enabled) { fingerprinting = enabled; }
+            bool loadedFromCache() const { return cachedProgram.has_value(); }
+            auto& getAst() { requireCompiled("AST"); return ast; }
+            auto& getTaskDescriptors() { return cachedProgram ? cachedProgram->taskDescriptors : analyzer.getBoundTasks(); }
+            auto& getTaskDescriptorMap() { return cachedProgram ? cachedTaskMap : analyzer.getBoundTaskMap(); }
+            auto getTaskContexts(){requireCompiled("task contexts"); return depGraph.getTaskMap();}
+            auto getGlobalContext() {return cachedProgram ? cachedProgram->globalContext : depGraph.getGlobalContext();}
+            auto& getTaskFingerprints() { return cachedProgram ? cachedProgram->taskFingerprints : taskFingerprints; }
             
         private:
+            // Outputs only produced by a full compile are unavailable when it was served from the cache
+            void requireCompiled(const std::string& output) const {
+                if (cachedProgram) {
+                    throw std::runtime_error("No " + output + " available, the program was loaded from the compile cache.");
+                }
+            }
+            // Hashes the tokens of every task (and of all procedures) for incremental reloads in one pass over the tokens
+            void fingerprintTasks();
+
             std::vector<Token> tokens;
             std::unique_ptr<AstNode> ast;
             Lexer lexer;
@@ -44,6 +73,13 @@ namespace BlsLang {
             Generator generator;
             Symgraph symGraph; 
             Divider divider; 
+            TaskFingerprints taskFingerprints;
+            std::optional<CompileCache> cache;
+            size_t compileThreads = 1;
+            bool fingerprinting = false;
+            // Outputs of the last compile when it was served from the cache
+            std::optional<CompiledProgram> cachedProgram;
+            std::unordered_map<std::string, std::vector<std::reference_wrapper<TaskDescriptor>>> cachedTaskMap;
     };
 
 }
\ No newline at end of file
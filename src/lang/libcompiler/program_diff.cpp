@@ -0,0 +1,80 @@
+#include "program_diff.hpp"
+#include "Serialization.hpp"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace BlsLang;
+
+namespace {
+    // Bindings match when the device identity and every client or mailbox facing option match
+    bool sameBinding(const DeviceDescriptor& oldDevice, const DeviceDescriptor& newDevice) {
+        return oldDevice.hash_equal(newDevice)
+            && oldDevice.device_name == newDevice.device_name
+            && oldDevice.isVtype == newDevice.isVtype
+            && oldDevice.readPolicy == newDevice.readPolicy
+            && oldDevice.overwritePolicy == newDevice.overwritePolicy
+            && oldDevice.isYield == newDevice.isYield
+            && oldDevice.polling_period == newDevice.polling_period
+            && oldDevice.isConst == newDevice.isConst
+            && oldDevice.ignoreWriteBacks == newDevice.ignoreWriteBacks
+            && oldDevice.deviceKind == newDevice.deviceKind;
+    }
+
+    bool sameBindings(const std::vector<DeviceDescriptor>& oldDevices, const std::vector<DeviceDescriptor>& newDevices) {
+        return std::ranges::equal(oldDevices, newDevices, sameBinding);
+    }
+
+    bool sameFingerprint(const TaskFingerprints& oldFingerprints, const TaskFingerprints& newFingerprints, const std::string& task) {
+        auto oldEntry = oldFingerprints.find(task);
+        auto newEntry = newFingerprints.find(task);
+        return oldEntry != oldFingerprints.end()
+            && newEntry != newFingerprints.end()
+            && oldEntry->second == newEntry->second;
+    }
+}
+
+std::vector<TaskChange> BlsLang::diffPrograms(const std::vector<TaskDescriptor>& oldTasks
+                                            , const TaskFingerprints& oldFingerprints
+                                            , const std::vector<TaskDescriptor>& newTasks
+                                            , const TaskFingerprints& newFingerprints) {
+    // tasks are matched by name and bound device identity, so a rebound task reads as removed and added
+    auto hashEqual = [](const TaskDescriptor& t1, const TaskDescriptor& t2) { return t1.hash_equal(t2); };
+    std::unordered_map<TaskDescriptor, const TaskDescriptor*, std::hash<TaskDescriptor>, decltype(hashEqual)> oldTaskMap;
+    for (auto& task : oldTasks) {
+        oldTaskMap.emplace(task, &task);
+    }
+
+    std::vector<TaskChange> changes;
+    for (auto& newTask : newTasks) {
+        auto oldEntry = oldTaskMap.find(newTask);
+        if (oldEntry == oldTaskMap.end()) {
+            changes.push_back({.task = newTask.name, .requiresRestart = true});
+            continue;
+        }
+        auto& oldTask = *oldEntry->second;
+        oldTaskMap.erase(oldEntry);
+
+        TaskChange change{.task = newTask.name};
+        change.requiresRestart = !sameBindings(oldTask.binded_devices, newTask.binded_devices)
+                              || !sameBindings(oldTask.inDevices, newTask.inDevices)
+                              || !sameBindings(oldTask.outDevices, newTask.outDevices)
+                              || oldTask.hostController != newTask.hostController;
+        change.codeChanged = !sameFingerprint(oldFingerprints, newFingerprints, newTask.name);
+        change.triggersChanged = oldTask.triggers != newTask.triggers
+                              || oldTask.coalescePolicy != newTask.coalescePolicy
+                              || oldTask.coalesceDepth != newTask.coalesceDepth;
+        change.policyChanged = oldTask.deferOwnership != newTask.deferOwnership
+                            || oldTask.pollConditions != newTask.pollConditions;
+
+        if (change.requiresRestart || change.codeChanged || change.triggersChanged || change.policyChanged) {
+            changes.push_back(change);
+        }
+    }
+
+    for (auto& [task, _] : oldTaskMap) {
+        changes.push_back({.task = task.name, .requiresRestart = true});
+    }
+    return changes;
+}
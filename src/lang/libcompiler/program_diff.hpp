@@ -0,0 +1,34 @@
+#pragma once
+#include "Serialization.hpp"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BlsLang {
+
+    // Source fingerprint of every task keyed by task name
+    using TaskFingerprints = std::unordered_map<std::string, size_t>;
+
+    struct TaskChange {
+        std::string task;
+        // Task body (or a procedure it may call) was edited
+        bool codeChanged = false;
+        // Trigger rules or coalescing policy were edited
+        bool triggersChanged = false;
+        // Ownership deferral or the polling conditions derived from the task changed
+        bool policyChanged = false;
+        // Task was added, removed or rebound, which cannot be applied to a running system
+        bool requiresRestart = false;
+    };
+
+    /*
+        Compares two compiled programs task by task and returns every task that differs.
+        Only tasks whose bindings are unchanged can be swapped in place on a running master.
+    */
+    std::vector<TaskChange> diffPrograms(const std::vector<TaskDescriptor>& oldTasks
+                                       , const TaskFingerprints& oldFingerprints
+                                       , const std::vector<TaskDescriptor>& newTasks
+                                       , const TaskFingerprints& newFingerprints);
+
+}
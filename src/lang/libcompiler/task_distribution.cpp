@@ -0,0 +1,87 @@
+#include "task_distribution.hpp"
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include "reserved_tokens.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace BlsLang;
+
+namespace {
+    bool isLocalDevice(const DeviceDescriptor& device) {
+        return !device.isVtype && device.deviceKind != DeviceKind::CURSOR;
+    }
+
+    // Tasks missing from the dependency graph are never moved since nothing is known about them
+    bool isDistributable(const TaskDescriptor& task, const GlobalContext& context) {
+        auto connections = context.taskConnections.find(task.name);
+        return task.hostController != RESERVED_MASTER
+            && task.fusedTasks.empty()
+            && !task.triggers.empty()
+            && std::ranges::all_of(task.triggers, [](const TriggerData& trigger) { return trigger.id.empty(); })
+            && std::ranges::all_of(task.binded_devices, isLocalDevice)
+            && connections != context.taskConnections.end()
+            && !connections->second.hasSideEffects
+            && !connections->second.readsTrigger;
+    }
+
+    const std::unordered_set<DeviceID>& getWrittenDevices(const TaskDescriptor& task, const GlobalContext& context) {
+        return context.taskConnections.at(task.name).outDeviceList;
+    }
+}
+
+DistributionPlan BlsLang::distributeTasks(const std::vector<TaskDescriptor>& tasks, const GlobalContext& context) {
+    std::vector<bool> local(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        local.at(i) = isDistributable(tasks.at(i), context);
+    }
+
+    // A device written from both sides would need ownership across the network, so such writers stay on the master.
+    // Local tasks sharing a written device would only be ordered by the client EM, so those stay on the master as well
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::unordered_set<DeviceID> masterWritten;
+        std::unordered_map<DeviceID, size_t> localWriters;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (local.at(i)) {
+                for (auto&& device : getWrittenDevices(tasks.at(i), context)) {
+                    localWriters[device]++;
+                }
+                continue;
+            }
+            auto connections = context.taskConnections.find(tasks.at(i).name);
+            if (connections != context.taskConnections.end()) {
+                masterWritten.insert(connections->second.outDeviceList.begin(), connections->second.outDeviceList.end());
+            }
+            else {
+                for (auto&& device : tasks.at(i).binded_devices) {
+                    masterWritten.insert(device.device_name);
+                }
+            }
+        }
+        for (size_t i = 0; i < tasks.size(); i++) {
+            auto sharedWrite = [&](const DeviceID& device) { return masterWritten.contains(device) || localWriters.at(device) > 1; };
+            if (local.at(i) && std::ranges::any_of(getWrittenDevices(tasks.at(i), context), sharedWrite)) {
+                local.at(i) = false;
+                changed = true;
+            }
+        }
+    }
+
+    DistributionPlan plan;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        auto& task = tasks.at(i);
+        if (local.at(i)) {
+            plan.controllerTasks[task.hostController].push_back(task);
+        }
+        else {
+            plan.masterTasks.push_back(task);
+        }
+    }
+    return plan;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace BlsLang {
+
+    struct DistributionPlan {
+        // Tasks kept on the master execution manager
+        std::vector<TaskDescriptor> masterTasks;
+        // Tasks run by the client execution manager of their host controller
+        std::unordered_map<ControllerID, std::vector<TaskDescriptor>> controllerTasks;
+        // Program sent to each controller, holding only its own tasks (see Compiler::compileSlice)
+        std::unordered_map<ControllerID, std::vector<char>> controllerPrograms;
+    };
+
+    /*
+        Moves tasks whose devices all live on one controller onto that controller, so their
+        states never make the round trip through the master. A task is only moved when it needs
+        nothing the master provides: no virtual or cursor devices, no named triggers, no side
+        effects or trigger queries, and no device it writes that another task also writes.
+    */
+    DistributionPlan distributeTasks(const std::vector<TaskDescriptor>& tasks, const GlobalContext& context);
+
+}
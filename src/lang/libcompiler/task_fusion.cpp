@@ -0,0 +1,137 @@
+#include "task_fusion.hpp"
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include "reserved_tokens.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace BlsLang;
+
+namespace {
+    struct FusionGroup {
+        std::vector<const TaskDescriptor*> members;
+        std::unordered_set<DeviceID> boundDevices;
+        std::unordered_set<DeviceID> writtenDevices;
+    };
+
+    // Named triggers can be toggled for a single task at runtime, which a fused task could not honor
+    bool isFusable(const TaskDescriptor& task) {
+        return !task.triggers.empty()
+            && std::ranges::all_of(task.triggers, [](const TriggerData& trigger) { return trigger.id.empty(); });
+    }
+
+    bool sameTriggering(const TaskDescriptor& task, const TaskDescriptor& other) {
+        return task.triggers == other.triggers
+            && task.coalescePolicy == other.coalescePolicy
+            && task.coalesceDepth == other.coalesceDepth;
+    }
+
+    std::unordered_set<DeviceID> getBoundDevices(const TaskDescriptor& task) {
+        std::unordered_set<DeviceID> devices;
+        for (auto&& device : task.binded_devices) {
+            devices.insert(device.device_name);
+        }
+        return devices;
+    }
+
+    // Tasks missing from the dependency graph are assumed to write every device they bind
+    std::unordered_set<DeviceID> getWrittenDevices(const TaskDescriptor& task, const GlobalContext& context) {
+        auto connections = context.taskConnections.find(task.name);
+        if (connections == context.taskConnections.end()) {
+            return getBoundDevices(task);
+        }
+        return connections->second.outDeviceList;
+    }
+
+    bool canJoin(const FusionGroup& group, const TaskDescriptor& task, const std::unordered_set<DeviceID>& written) {
+        if (!sameTriggering(*group.members.front(), task)) {
+            return false;
+        }
+        if (std::ranges::any_of(group.members, [&task](auto* member) { return member->name == task.name; })) {
+            return false;
+        }
+        auto writtenByGroup = [&group](const DeviceDescriptor& device) { return group.writtenDevices.contains(device.device_name); };
+        auto boundByGroup = [&group](const DeviceID& device) { return group.boundDevices.contains(device); };
+        return std::ranges::none_of(task.binded_devices, writtenByGroup) && std::ranges::none_of(written, boundByGroup);
+    }
+
+    void mergeDevices(std::vector<DeviceDescriptor>& devices, const std::vector<DeviceDescriptor>& additions) {
+        for (auto&& device : additions) {
+            if (std::ranges::find(devices, device.device_name, &DeviceDescriptor::device_name) == devices.end()) {
+                devices.push_back(device);
+            }
+        }
+    }
+
+    TaskDescriptor fuseGroup(const FusionGroup& group) {
+        auto& first = *group.members.front();
+        TaskDescriptor fused;
+        fused.bytecode_offset = first.bytecode_offset;
+        // members may name different hosts, but the fused task only ever runs on the master
+        fused.hostController = RESERVED_MASTER;
+        fused.triggers = first.triggers;
+        fused.coalescePolicy = first.coalescePolicy;
+        fused.coalesceDepth = first.coalesceDepth;
+        fused.deferOwnership = std::ranges::all_of(group.members, &TaskDescriptor::deferOwnership);
+
+        std::unordered_map<DeviceID, uint16_t> devicePositions;
+        for (auto* member : group.members) {
+            fused.name += (fused.name.empty() ? "" : "+") + member->name;
+            FusedTaskData fusedTask;
+            fusedTask.name = member->name;
+            fusedTask.bytecode_offset = member->bytecode_offset;
+            for (auto&& device : member->binded_devices) {
+                auto [entry, inserted] = devicePositions.try_emplace(device.device_name, fused.binded_devices.size());
+                if (inserted) {
+                    fused.binded_devices.push_back(device);
+                }
+                fusedTask.devicePositions.push_back(entry->second);
+            }
+            fused.fusedTasks.push_back(std::move(fusedTask));
+            mergeDevices(fused.inDevices, member->inDevices);
+            mergeDevices(fused.outDevices, member->outDevices);
+            fused.pollConditions.insert(fused.pollConditions.end(), member->pollConditions.begin(), member->pollConditions.end());
+        }
+        return fused;
+    }
+}
+
+std::vector<TaskDescriptor> BlsLang::fuseTasks(const std::vector<TaskDescriptor>& tasks, const GlobalContext& context) {
+    std::vector<FusionGroup> groups;
+    std::vector<std::optional<size_t>> taskGroups(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        auto& task = tasks.at(i);
+        if (!isFusable(task)) {
+            continue;
+        }
+        auto written = getWrittenDevices(task, context);
+        auto group = std::ranges::find_if(groups, [&](const FusionGroup& group) { return canJoin(group, task, written); });
+        if (group == groups.end()) {
+            group = groups.emplace(groups.end());
+        }
+        group->members.push_back(&task);
+        group->boundDevices.merge(getBoundDevices(task));
+        group->writtenDevices.merge(written);
+        taskGroups.at(i) = std::distance(groups.begin(), group);
+    }
+
+    // fused tasks take the place of their first member so the task order stays stable
+    std::vector<TaskDescriptor> result;
+    std::unordered_set<size_t> emittedGroups;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        auto& groupIndex = taskGroups.at(i);
+        if (!groupIndex.has_value() || groups.at(*groupIndex).members.size() == 1) {
+            result.push_back(tasks.at(i));
+        }
+        else if (emittedGroups.insert(*groupIndex).second) {
+            result.push_back(fuseGroup(groups.at(*groupIndex)));
+        }
+    }
+    return result;
+}
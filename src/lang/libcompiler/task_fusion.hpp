@@ -0,0 +1,21 @@
+#pragma once
+#include "Serialization.hpp"
+#include "depgraph.hpp"
+#include <vector>
+
+namespace BlsLang {
+
+    /*
+        Folds tasks that share the same trigger rules into a single task, so a device event is
+        mailed, triggered, scheduled and executed once for the whole group. Every task passed in
+        must run on the master, so distributed tasks have to be removed first. A task's host
+        controller only says where it could be distributed to.
+        Tasks are only grouped when none of them writes a device that another one binds, which
+        keeps running the members back to back equivalent to running them separately.
+        The fused task has one trigger manager over the union of its members' devices, so its
+        initial trigger waits until every member's devices have reported. A member whose own
+        devices report first does not run until then.
+    */
+    std::vector<TaskDescriptor> fuseTasks(const std::vector<TaskDescriptor>& tasks, const GlobalContext& context);
+
+}
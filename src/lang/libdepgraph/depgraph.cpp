@@ -1,7 +1,10 @@
 #include "depgraph.hpp"
 
+#include <algorithm>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <variant>
 
 using namespace BlsLang; 
@@ -24,6 +27,31 @@ namespace  {
         // error("Device constructor contains no device name"); 
         return ""; 
     }
+
+    // Traps that only compute a value, so running them twice is indistinguishable from running them once
+    const std::unordered_set<std::string> PURE_TRAPS = {
+        "stoi", "toString", "getTrigger", "time", "loadJson", "jsonify", "containsType"
+    }; 
+
+    // Numeric value of a literal operand, looking through groups and negation
+    std::optional<double> numericLiteral(AstNode::Expression* expr){
+        if(auto* group = dynamic_cast<AstNode::Expression::Group*>(expr)){
+            return numericLiteral(group->expression.get()); 
+        }
+        if(auto* unary = dynamic_cast<AstNode::Expression::Unary*>(expr); unary && unary->op == "-"){
+            auto value = numericLiteral(unary->expression.get()); 
+            return value.has_value() ? std::optional(-value.value()) : std::nullopt; 
+        }
+        if(auto* literal = dynamic_cast<AstNode::Expression::Literal*>(expr)){
+            if(std::holds_alternative<int64_t>(literal->literal)){
+                return static_cast<double>(std::get<int64_t>(literal->literal)); 
+            }
+            if(std::holds_alternative<double>(literal->literal)){
+                return std::get<double>(literal->literal); 
+            }
+        }
+        return std::nullopt; 
+    }
 }
 
 GlobalContext& DepGraph::getGlobalContext(){
@@ -41,7 +69,26 @@ void DepGraph::printGlobalContext(){
         }
         std::cout<<"Out Devices: "<<std::endl; 
         for(auto& dev : pair.second.outDeviceList){
-            std::cout<<"*"<<dev<<std::endl; 
+            std::cout<<"*"<<dev<<(pair.second.unconditionalOutDevices.contains(dev) ? "" : " (conditional)")<<std::endl; 
+        }
+        for(auto& [dev, attrs] : pair.second.readAttributes){
+            for(auto& attr : attrs){
+                std::cout<<"Reads "<<dev<<"."<<attr<<std::endl; 
+            }
+        }
+        for(auto& [dev, attrs] : pair.second.writtenAttributes){
+            for(auto& attr : attrs){
+                std::cout<<"Writes "<<dev<<"."<<attr<<std::endl; 
+            }
+        }
+        for(auto& cond : pair.second.conditions){
+            std::cout<<"Compares "<<cond.device<<"."<<cond.attribute<<" to "<<cond.threshold<<std::endl; 
+        }
+        if(pair.second.hasSideEffects){
+            std::cout<<"Has side effects"<<std::endl; 
+        }
+        if(pair.second.readsTrigger){
+            std::cout<<"Reads its trigger"<<std::endl; 
         }
         
         std::cout<<"-------------------------"<<std::endl; 
@@ -52,6 +99,7 @@ void DepGraph::clearTaskCtx(){
     this->taskCtx.operatingTask = ""; 
     this->taskCtx.devAliasMap.clear();
     this->taskCtx.tempDevices.clear();  
+    this->taskCtx.conditionalDepth = 0; 
 }
 
 bool DepGraph::isDevice(const SymbolID& isDevice){
@@ -136,27 +184,62 @@ BlsObject DepGraph::visit(AstNode::Statement::Declaration& ast) {
 }
 
 
+// Compound assignments read the device they write, so they are read-modify-write accesses
+bool DepGraph::isCompoundAssignment(BINARY_OPERATOR op){
+    switch(op){
+        case BINARY_OPERATOR::ASSIGN_ADD:
+        case BINARY_OPERATOR::ASSIGN_SUB:
+        case BINARY_OPERATOR::ASSIGN_MUL:
+        case BINARY_OPERATOR::ASSIGN_DIV:
+        case BINARY_OPERATOR::ASSIGN_MOD:
+        case BINARY_OPERATOR::ASSIGN_EXP:
+            return true; 
+        default:
+            return false; 
+    }
+}
+
 BlsObject DepGraph::visit(AstNode::Expression::Binary &ast){
-    if(ast.op == "="){
+    auto op = getBinOpEnum(ast.op); 
+    if(op == BINARY_OPERATOR::ASSIGN){
        this->taskCtx.isReading = false;  
        ast.left->accept(*this); 
        this->taskCtx.isReading = true; 
 
        ast.right->accept(*this); 
     }
-    else if(ast.op == "+="){
+    else if(isCompoundAssignment(op)){
         this->taskCtx.isRW = true; 
         ast.left->accept(*this); 
         this->taskCtx.isRW = false; 
         ast.right->accept(*this); 
     }
     else{
+        if(op >= BINARY_OPERATOR::LT && op <= BINARY_OPERATOR::NE){
+            recordCondition(ast.left.get(), ast.right.get()); 
+            recordCondition(ast.right.get(), ast.left.get()); 
+        }
         ast.left->accept(*this); 
         ast.right->accept(*this); 
     }
     return true; 
 }
 
+void DepGraph::recordCondition(AstNode::Expression* attribute, AstNode::Expression* threshold){
+    auto* member = dynamic_cast<AstNode::Expression::Member*>(attribute); 
+    auto* object = member ? dynamic_cast<AstNode::Expression::Access*>(member->object.get()) : nullptr; 
+    auto value = numericLiteral(threshold); 
+    if(!object || !value.has_value() || !isDevice(object->identifier)){
+        return; 
+    }
+
+    auto& conditions = this->globalCtx.taskConnections[this->taskCtx.operatingTask].conditions; 
+    AstCondition cond{this->taskCtx.devAliasMap[object->identifier], member->member, value.value()}; 
+    if(std::ranges::find(conditions, cond) == conditions.end()){
+        conditions.push_back(std::move(cond)); 
+    }
+}
+
 
 BlsObject DepGraph::visit(AstNode::Statement::Expression &ast){
     ast.expression->accept(*this); 
@@ -183,6 +266,15 @@ BlsObject DepGraph::visit(AstNode::Expression::Function& ast) {
         this->globalCtx.taskConnections[task] = taskDesc; 
     }
     else{
+        // Method calls act on their object, anything else invoked by name is a trap or a procedure
+        auto* invocable = dynamic_cast<AstNode::Expression::Access*>(ast.invocable.get());
+        if(invocable && !PURE_TRAPS.contains(invocable->identifier)){
+            this->globalCtx.taskConnections[this->taskCtx.operatingTask].hasSideEffects = true; 
+        }
+        if(invocable && invocable->identifier == "getTrigger"){
+            this->globalCtx.taskConnections[this->taskCtx.operatingTask].readsTrigger = true; 
+        }
+
         auto& argList = ast.arguments; 
         for(auto& statement : argList){
             statement->accept(*this); 
@@ -229,11 +321,37 @@ BlsObject DepGraph::visit(AstNode::Expression::Access& ast) {
             }
         }
 
+        if(this->taskCtx.isRW || !this->taskCtx.isReading){
+            if(this->taskCtx.conditionalDepth == 0){
+                auto &targ = this->taskCtx.operatingTask; 
+                for(const DeviceID& dev : this->taskCtx.tempDevices){
+                    this->globalCtx.taskConnections[targ].unconditionalOutDevices.insert(dev); 
+                }
+            }
+        }
+
         this->taskCtx.tempDevices.clear(); 
     }
     return true; 
 }
 
+BlsObject DepGraph::visit(AstNode::Expression::Member& ast) {
+    auto* object = dynamic_cast<AstNode::Expression::Access*>(ast.object.get());
+    if(!this->setupCtx.inSetup && object && isDevice(object->identifier)){
+        auto& realDev = this->taskCtx.devAliasMap[object->identifier]; 
+        auto& taskDesc = this->globalCtx.taskConnections[this->taskCtx.operatingTask]; 
+        if(this->taskCtx.isRW || this->taskCtx.isReading){
+            taskDesc.readAttributes[realDev].insert(ast.member); 
+        }
+        if(this->taskCtx.isRW || !this->taskCtx.isReading){
+            taskDesc.writtenAttributes[realDev].insert(ast.member); 
+        }
+    }
+
+    ast.object->accept(*this); 
+    return true; 
+}
+
 
 BlsObject DepGraph::visit(AstNode::Expression::Literal& ast) {
     if(this->setupCtx.inSetup){
@@ -248,6 +366,7 @@ BlsObject DepGraph::visit(AstNode::Expression::Literal& ast) {
 BlsObject DepGraph::visit(AstNode::Statement::If& ast) {
     ast.condition->accept(*this); 
 
+    this->taskCtx.conditionalDepth++; 
     for(auto& ifStatement : ast.block){
         ifStatement->accept(*this); 
     }
@@ -259,6 +378,7 @@ BlsObject DepGraph::visit(AstNode::Statement::If& ast) {
     for(auto& elseStatement :  ast.elseBlock){
         elseStatement->accept(*this); 
     }
+    this->taskCtx.conditionalDepth--; 
     return true; 
     
 }
@@ -272,6 +392,7 @@ BlsObject DepGraph::visit(AstNode::Statement::For& ast) {
         ast.initStatement.value()->accept(*this); 
     }
 
+    this->taskCtx.conditionalDepth++; 
     if(ast.incrementExpression.has_value()){
         ast.incrementExpression.value()->accept(*this); 
     }
@@ -279,15 +400,20 @@ BlsObject DepGraph::visit(AstNode::Statement::For& ast) {
     for(auto& sm : ast.block){
         sm->accept(*this); 
     }
+    this->taskCtx.conditionalDepth--; 
     return true; 
     
 }
 
 BlsObject DepGraph::visit(AstNode::Statement::While& ast) {
     ast.condition->accept(*this); 
+    // The body of a do loop always runs at least once
+    int bodyDepth = (ast.type == AstNode::Statement::While::LOOP_TYPE::DO) ? 0 : 1; 
+    this->taskCtx.conditionalDepth += bodyDepth; 
     for(auto &sm : ast.block){
         sm->accept(*this); 
     }
+    this->taskCtx.conditionalDepth -= bodyDepth; 
     return true; 
 }
 
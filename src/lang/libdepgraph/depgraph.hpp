@@ -13,12 +13,33 @@ using TaskID = std::string;
 using DeviceID = std::string;  
 using ControllerID = std::string; 
 
+// Comparison of a device attribute against a numeric literal, the task acts once the attribute crosses the threshold
+struct AstCondition{
+    DeviceID device; 
+    std::string attribute; 
+    double threshold; 
+
+    bool operator==(const AstCondition&) const = default; 
+}; 
+
 struct AstTaskDesc{
     TaskID name; 
 
     std::unordered_set<DeviceID> inDeviceList;
     std::unordered_set<DeviceID> outDeviceList;  
 
+    // Attributes accessed through each device (whole device accesses are only in the lists above)
+    std::unordered_map<DeviceID, std::unordered_set<std::string>> readAttributes; 
+    std::unordered_map<DeviceID, std::unordered_set<std::string>> writtenAttributes; 
+    // Out devices written outside of any branch or loop body
+    std::unordered_set<DeviceID> unconditionalOutDevices; 
+    // Set when the task calls a procedure or a trap that acts outside of the task (print, push, sleep...)
+    bool hasSideEffects = false; 
+    // Set when the task asks which device triggered it
+    bool readsTrigger = false; 
+    // Thresholds the task compares device attributes against, used to speed up polling near them
+    std::vector<AstCondition> conditions; 
+
     std::unordered_map<SymbolID, DeviceID> deviceAliasMap; 
     std::vector<DeviceID> bindedDevices; 
 }; 
@@ -41,6 +62,8 @@ struct TaskContext{
     std::unordered_set<DeviceID> tempDevices; 
     bool isReading = true;
     bool isRW = false; 
+    // Number of branch and loop bodies enclosing the visited statement
+    int conditionalDepth = 0; 
 }; 
 
 struct SetupContext{
@@ -69,6 +92,9 @@ namespace BlsLang{
             //utility functions: 
             void clearTaskCtx(); 
             bool isDevice(const SymbolID &candidate); 
+            // Records attribute as a device attribute compared against the numeric literal threshold
+            void recordCondition(AstNode::Expression* attribute, AstNode::Expression* threshold); 
+            static bool isCompoundAssignment(BINARY_OPERATOR op); 
 
         public: 
 
@@ -91,6 +117,7 @@ namespace BlsLang{
             BlsObject visit(AstNode::Statement::Declaration& ast) override; 
             BlsObject visit(AstNode::Expression::Function& ast) override; 
             BlsObject visit(AstNode::Expression::Access& ast) override; 
+            BlsObject visit(AstNode::Expression::Member& ast) override; 
             BlsObject visit(AstNode::Expression::Literal& ast) override; 
             BlsObject visit(AstNode::Statement::Expression& ast) override; 
             BlsObject visit(AstNode::Function::Task &ast) override; 
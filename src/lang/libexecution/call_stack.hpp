@@ -34,14 +34,14 @@ namespace BlsLang {
                   , CONDITIONAL
                 };
 
-                using container_t = std::conditional_t<IntAddressable<T>, std::vector<BlsType>, std::unordered_map<T, std::pair<uint8_t, std::shared_ptr<BlsType>>>>;
+                using container_t = std::conditional_t<IntAddressable<T>, std::vector<BlsType>, std::unordered_map<T, std::pair<uint16_t, std::shared_ptr<BlsType>>>>;
 
                 Frame(Context context, const std::string& name) requires StringAddressable<T> : context(context), name(name) {}
                 Frame(size_t returnAddress, std::span<BlsType> arguments) requires IntAddressable<T>;
                 
                 Context context;
                 std::string name;
-                uint8_t localCount = 0;
+                uint32_t localCount = 0; // wider than the indices so the analyzer can detect overflow
 
                 size_t returnAddress;
                 std::stack<BlsType> operands;
@@ -64,7 +64,8 @@ namespace BlsLang {
             bool checkContext(Frame::Context context) requires StringAddressable<T>;
             bool checkLocalInFrame(T index) requires StringAddressable<T>;
             const std::string& getFrameName() requires StringAddressable<T>;
-            uint8_t getLocalIndex(T index) requires StringAddressable<T>;
+            uint16_t getLocalIndex(T index) requires StringAddressable<T>;
+            size_t getLocalCount() requires StringAddressable<T>;
 
         private:
             using cstack_t = std::conditional_t<std::same_as<T, std::string>, std::vector<Frame>, std::stack<Frame>>;
@@ -131,7 +132,7 @@ namespace BlsLang {
     inline void CallStack<T>::addLocal(T index, BlsType value) {
         if constexpr (std::is_same<T, std::string>()) {
             auto& frame = cs.back();
-            frame.locals.try_emplace(index, frame.localCount++, new BlsType(value));
+            frame.locals.try_emplace(index, static_cast<uint16_t>(frame.localCount++), new BlsType(value));
         }
         else {
             auto& locals = cs.top().locals;
@@ -205,7 +206,12 @@ namespace BlsLang {
     }
 
     template<StackType T>
-    inline uint8_t CallStack<T>::getLocalIndex(T index) requires StringAddressable<T> {
+    inline size_t CallStack<T>::getLocalCount() requires StringAddressable<T> {
+        return cs.back().localCount;
+    }
+
+    template<StackType T>
+    inline uint16_t CallStack<T>::getLocalIndex(T index) requires StringAddressable<T> {
         for (auto it = cs.rbegin(); it != cs.rend(); it++) {
             auto& locals = it->locals;
             if (locals.contains(index)) {
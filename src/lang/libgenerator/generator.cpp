@@ -10,12 +10,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <ranges>
 #include <sstream>
 #include <stdexcept>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -27,6 +30,78 @@ using namespace BlsLang;
 template<class... Ts>
 struct overloads : Ts... { using Ts::operator()...; };
 
+namespace {
+    // Operand encodings: the compact opcode is used whenever the operand fits, the _W variant otherwise
+
+    std::unique_ptr<INSTRUCTION> encodePUSH(uint16_t index) {
+        if (index <= UINT8_MAX) return createPUSH(index);
+        return createPUSH_W(index);
+    }
+
+    std::unique_ptr<INSTRUCTION> encodeLOAD(uint16_t index) {
+        if (index <= UINT8_MAX) return createLOAD(index);
+        return createLOAD_W(index);
+    }
+
+    std::unique_ptr<INSTRUCTION> encodeSTORE(uint16_t index) {
+        if (index <= UINT8_MAX) return createSTORE(index);
+        return createSTORE_W(index);
+    }
+
+    std::unique_ptr<INSTRUCTION> encodeMKTYPE(uint16_t index, uint8_t type) {
+        if (index <= UINT8_MAX) return createMKTYPE(index, type);
+        return createMKTYPE_W(index, type);
+    }
+
+    std::unique_ptr<INSTRUCTION> encodeCALL(uint32_t address, uint8_t argc) {
+        if (address <= UINT16_MAX) return createCALL(address, argc);
+        return createCALL_W(address, argc);
+    }
+
+    std::unique_ptr<INSTRUCTION> encodeJMP(size_t address) {
+        if (address <= UINT16_MAX) return createJMP(address);
+        return createJMP_W(address);
+    }
+
+    template<typename Narrow, typename Wide>
+    void setAddress(std::unique_ptr<INSTRUCTION>& instruction, size_t address, std::unique_ptr<Wide> (*createWide)(uint32_t, int)) {
+        if (address <= UINT16_MAX) {
+            static_cast<Narrow&>(*instruction).address = address;
+        }
+        else { // addresses are instruction indices, so widening in place never moves another target
+            instruction = createWide(address, 0);
+        }
+    }
+
+    std::optional<size_t> getJumpTarget(INSTRUCTION& instruction) {
+        switch (instruction.opcode) {
+            case OPCODE::JMP: return static_cast<INSTRUCTION::JMP&>(instruction).address;
+            case OPCODE::BRANCH: return static_cast<INSTRUCTION::BRANCH&>(instruction).address;
+            case OPCODE::JMPSC_OR: return static_cast<INSTRUCTION::JMPSC_OR&>(instruction).address;
+            case OPCODE::JMPSC_AND: return static_cast<INSTRUCTION::JMPSC_AND&>(instruction).address;
+            case OPCODE::JMP_W: return static_cast<INSTRUCTION::JMP_W&>(instruction).address;
+            case OPCODE::BRANCH_W: return static_cast<INSTRUCTION::BRANCH_W&>(instruction).address;
+            case OPCODE::JMPSC_OR_W: return static_cast<INSTRUCTION::JMPSC_OR_W&>(instruction).address;
+            case OPCODE::JMPSC_AND_W: return static_cast<INSTRUCTION::JMPSC_AND_W&>(instruction).address;
+            default: return std::nullopt;
+        }
+    }
+
+    // Moves the bytecode ranges recorded by a body generator to where the body was linked
+    class BytecodeRangeShifter : public Visitor {
+        public:
+            BytecodeRangeShifter(size_t base) : base(base) { }
+
+            void preVisit(AstNode& ast) override {
+                ast.bytecodeStart += base;
+                ast.bytecodeEnd += base;
+            }
+
+        private:
+            size_t base;
+    };
+}
+
 void Generator::writeBytecode(std::ostream& outputStream) {
     if (outputStream.bad()) {
         throw std::runtime_error("Bad output stream provided.");
@@ -42,6 +117,132 @@ void Generator::writeBytecode(std::ostream& outputStream) {
     }
 }
 
+void Generator::patchAddress(size_t position, size_t address) {
+    if (address > UINT32_MAX) {
+        throw std::runtime_error("Program exceeds the maximum addressable instruction count.");
+    }
+    auto& instruction = instructions.at(position);
+    switch (instruction->opcode) {
+        case OPCODE::JMP:
+            setAddress<INSTRUCTION::JMP>(instruction, address, createJMP_W);
+        break;
+
+        case OPCODE::BRANCH:
+            setAddress<INSTRUCTION::BRANCH>(instruction, address, createBRANCH_W);
+        break;
+
+        case OPCODE::JMPSC_OR:
+            setAddress<INSTRUCTION::JMPSC_OR>(instruction, address, createJMPSC_OR_W);
+        break;
+
+        case OPCODE::JMPSC_AND:
+            setAddress<INSTRUCTION::JMPSC_AND>(instruction, address, createJMPSC_AND_W);
+        break;
+
+        case OPCODE::JMP_W:
+            static_cast<INSTRUCTION::JMP_W&>(*instruction).address = address;
+        break;
+
+        case OPCODE::BRANCH_W:
+            static_cast<INSTRUCTION::BRANCH_W&>(*instruction).address = address;
+        break;
+
+        case OPCODE::JMPSC_OR_W:
+            static_cast<INSTRUCTION::JMPSC_OR_W&>(*instruction).address = address;
+        break;
+
+        case OPCODE::JMPSC_AND_W:
+            static_cast<INSTRUCTION::JMPSC_AND_W&>(*instruction).address = address;
+        break;
+
+        case OPCODE::CALL: {
+            auto argc = static_cast<INSTRUCTION::CALL&>(*instruction).argc;
+            instruction = encodeCALL(address, argc);
+            break;
+        }
+
+        case OPCODE::CALL_W:
+            static_cast<INSTRUCTION::CALL_W&>(*instruction).address = address;
+        break;
+
+        default:
+            throw std::runtime_error("Attempted to patch the address of a non jump or call instruction.");
+        break;
+    }
+}
+
+Generator::FunctionCode Generator::generateFunction(AstNode::Function& function) {
+    Generator body(boundTasks, boundTaskMap, literalPool, functionSymbols);
+    body.deferLinking = true;
+    function.accept(body);
+    return {std::move(body.instructions), std::move(body.callFixups)};
+}
+
+void Generator::linkFunction(FunctionCode& code, size_t base) {
+    for (auto&& instruction : code.instructions) {
+        auto target = getJumpTarget(*instruction);
+        instructions.push_back(std::move(instruction));
+        if (target.has_value()) {
+            patchAddress(instructions.size() - 1, *target + base);
+        }
+    }
+    for (auto&& [position, callee] : code.callFixups) {
+        patchAddress(base + position, procedureAddresses.at(callee));
+    }
+}
+
+void Generator::generateConcurrently(AstNode::Source& ast, boost::asio::thread_pool& pool) {
+    std::vector<AstNode::Function*> functions;
+    for (auto&& procedure : ast.procedures) {
+        functions.push_back(procedure.get());
+    }
+    for (auto&& task : ast.tasks) {
+        functions.push_back(task.get());
+    }
+
+    std::vector<std::future<FunctionCode>> pending;
+    for (auto* function : functions) {
+        std::packaged_task<FunctionCode()> job([this, function]() { return generateFunction(*function); });
+        pending.push_back(job.get_future());
+        boost::asio::post(pool, std::move(job));
+    }
+    for (auto&& body : pending) { // bodies still reference this generator, so all must finish before any error propagates
+        body.wait();
+    }
+    std::vector<FunctionCode> bodies;
+    for (auto&& body : pending) {
+        bodies.push_back(body.get());
+    }
+
+    // addresses are assigned in source order so the output matches sequential generation
+    ast.bytecodeStart = instructions.size();
+    std::vector<size_t> bases;
+    size_t base = instructions.size();
+    for (size_t i = 0; i < functions.size(); i++) {
+        auto& name = functions.at(i)->name;
+        bases.push_back(base);
+        if (i < ast.procedures.size()) {
+            functionSymbols[name].first = base;
+            procedureAddresses.emplace(name, base);
+        }
+        else if (boundTaskMap.contains(name)) {
+            functionSymbols[name].first = base;
+            for (auto&& task : boundTaskMap.at(name)) {
+                task.get().bytecode_offset = base;
+            }
+        }
+        base += bodies.at(i).instructions.size();
+    }
+
+    for (size_t i = 0; i < functions.size(); i++) {
+        linkFunction(bodies.at(i), bases.at(i));
+        BytecodeRangeShifter shifter(bases.at(i));
+        functions.at(i)->accept(shifter);
+    }
+    ast.setup->bytecodeStart = ast.setup->bytecodeEnd = instructions.size();
+    ast.bytecodeEnd = instructions.size();
+}
+
 void Generator::writeBytecode(std::vector<char>& outputVector) {
     auto outputStream = std::ostringstream(std::ios::binary);
     writeBytecode(outputStream);
@@ -74,9 +275,11 @@ BlsObject Generator::visit(AstNode::Source& ast) {
 BlsObject Generator::visit(AstNode::Function::Procedure& ast) {
     functionContext = FUNCTION_CONTEXT::PROCEDURE;
     auto& name = ast.name;
-    uint16_t address = instructions.size();
-    functionSymbols[name].first = address; // use operator[] to account for testing environment
-    procedureAddresses.emplace(name, address);
+    uint32_t address = instructions.size();
+    if (!deferLinking) {
+        functionSymbols[name].first = address; // use operator[] to account for testing environment
+        procedureAddresses.emplace(name, address);
+    }
     for (auto&& statement : ast.statements) {
         statement->accept(*this);
     }
@@ -85,31 +288,31 @@ BlsObject Generator::visit(AstNode::Function::Procedure& ast) {
     // will only be necessary for void once control path checking is implemented
     switch (getTypeFromName(ast.returnType->name)) {
         case TYPE::void_t:
-            instructions.push_back(createPUSH(literalPool.at(std::monostate())));
+            instructions.push_back(encodePUSH(literalPool.at(std::monostate())));
         break;
 
         case TYPE::bool_t:
-            instructions.push_back(createPUSH(literalPool.at(false)));
+            instructions.push_back(encodePUSH(literalPool.at(false)));
         break;
 
         case TYPE::int_t:
-            instructions.push_back(createPUSH(literalPool.at(0)));
+            instructions.push_back(encodePUSH(literalPool.at(0)));
         break;
 
         case TYPE::float_t:
-            instructions.push_back(createPUSH(literalPool.at(0.0)));
+            instructions.push_back(encodePUSH(literalPool.at(0.0)));
         break;
 
         case TYPE::string_t:
-            instructions.push_back(createPUSH(literalPool.at("")));
+            instructions.push_back(encodePUSH(literalPool.at("")));
         break;
 
         case TYPE::list_t:
-            instructions.push_back(createPUSH(literalPool.at(std::make_shared<VectorDescriptor>(TYPE::ANY))));
+            instructions.push_back(encodePUSH(literalPool.at(std::make_shared<VectorDescriptor>(TYPE::ANY))));
         break;
 
         case TYPE::map_t:
-            instructions.push_back(createPUSH(literalPool.at(std::make_shared<MapDescriptor>(TYPE::ANY))));
+            instructions.push_back(encodePUSH(literalPool.at(std::make_shared<MapDescriptor>(TYPE::ANY))));
         break;
 
         default:
@@ -125,10 +328,12 @@ BlsObject Generator::visit(AstNode::Function::Task& ast) {
     functionContext = FUNCTION_CONTEXT::TASK;
     auto& name = ast.name;
     if (!boundTaskMap.contains(name)) return 0; // skip generating code for unbound tasks
-    uint16_t address = instructions.size();
-    functionSymbols[name].first = address; // use operator[] to account for testing environment
-    for (auto&& task : boundTaskMap.at(name)) {
-        task.get().bytecode_offset = address; // update offset for all bound tasks
+    uint32_t address = instructions.size();
+    if (!deferLinking) {
+        functionSymbols[name].first = address; // use operator[] to account for testing environment
+        for (auto&& task : boundTaskMap.at(name)) {
+            task.get().bytecode_offset = address; // update offset for all bound tasks
+        }
     }
     for (auto&& statement : ast.statements) {
         statement->accept(*this);
@@ -144,32 +349,30 @@ BlsObject Generator::visit(AstNode::Setup&) {
 BlsObject Generator::visit(AstNode::Statement::If& ast) {
 
     ast.condition->accept(*this);
-    auto conditionBranch = createBRANCH(0);
-    auto* branchInstruction = conditionBranch.get();
-    instructions.push_back(std::move(conditionBranch));
+    size_t branchIndex = instructions.size();
+    instructions.push_back(createBRANCH(0));
     for (auto&& statement : ast.block) {
         statement->accept(*this);   
     }
 
     // create a JMP to return to default execution sequence
     // TODO: remove extraneous JMP produced by lone if or elif with no else
-    std::vector<INSTRUCTION::JMP*> jmpInstructions;
-    auto endOfBodyJmp = createJMP(instructions.size());
-    jmpInstructions.push_back(endOfBodyJmp.get());
-    instructions.push_back(std::move(endOfBodyJmp));
-    branchInstruction->address = instructions.size();
+    std::vector<size_t> jmpIndices;
+    jmpIndices.push_back(instructions.size());
+    instructions.push_back(createJMP(0));
+    patchAddress(branchIndex, instructions.size());
 
     for (auto&& elif : ast.elseIfStatements) {
         elif->accept(*this);
         // final instruction is guaranteed to be JMP, add it to jmp list
-        jmpInstructions.push_back(static_cast<INSTRUCTION::JMP*>(instructions.back().get()));
+        jmpIndices.push_back(instructions.size() - 1);
     }
     for (auto&& statement : ast.elseBlock) {
         statement->accept(*this);
     }
 
-    for (auto&& jmpInstruction : jmpInstructions) {
-        jmpInstruction->address = instructions.size();
+    for (auto&& jmpIndex : jmpIndices) {
+        patchAddress(jmpIndex, instructions.size());
     }
 
     return 0;
@@ -183,46 +386,43 @@ BlsObject Generator::visit(AstNode::Statement::For& ast) {
     if (initStatement.has_value()) {
         initStatement->get()->accept(*this);
     }
-    uint16_t loopStart = instructions.size();
+    size_t loopStart = instructions.size();
 
     auto& condition = ast.condition;
-    INSTRUCTION::BRANCH* loopBranchInstruction = nullptr; // no branch needed if no condition provided
+    std::optional<size_t> loopBranchIndex; // no branch needed if no condition provided
     if (condition.has_value()) {
         condition->get()->accept(*this);
-        auto loopBranch = createBRANCH(0);
-        loopBranchInstruction = loopBranch.get();
-        instructions.push_back(std::move(loopBranch));
+        loopBranchIndex = instructions.size();
+        instructions.push_back(createBRANCH(0));
     }
 
     for (auto&& statement : ast.block) {
         statement->accept(*this);
     }
 
-    uint16_t incrementIndex = instructions.size();
+    size_t incrementIndex = instructions.size();
     auto& incrementExpression = ast.incrementExpression;
     if (incrementExpression.has_value()) {
         incrementExpression->get()->accept(*this);
     }
     // maybe add a discard operation for the expression result
 
-    instructions.push_back(createJMP(loopStart));
-    uint16_t endAddress = instructions.size();
-    if (loopBranchInstruction) {
-        loopBranchInstruction->address = endAddress;
+    instructions.push_back(encodeJMP(loopStart));
+    size_t endAddress = instructions.size();
+    if (loopBranchIndex.has_value()) {
+        patchAddress(*loopBranchIndex, endAddress);
     }
 
     auto& loopContinues = continueIndices.top();
     auto& loopBreaks = breakIndices.top();
 
     for (size_t i = 0; i < loopContinues.size(); i++) {  // set continue JMP indices
-        auto& continueInstruction = instructions.at(loopContinues.top());
-        static_cast<INSTRUCTION::JMP&>(*continueInstruction).address = incrementIndex;
+        patchAddress(loopContinues.top(), incrementIndex);
         loopContinues.pop();
     }
 
     for (size_t i = 0; i < loopBreaks.size(); i++) {  // set break JMP indices
-        auto& breakInstruction = instructions.at(loopBreaks.top());
-        static_cast<INSTRUCTION::JMP&>(*breakInstruction).address = endAddress;
+        patchAddress(loopBreaks.top(), endAddress);
         loopBreaks.pop();
     }
     
@@ -235,41 +435,37 @@ BlsObject Generator::visit(AstNode::Statement::While& ast) {
     // ensure we only break / continue the innermost loop
     continueIndices.emplace();
     breakIndices.emplace();
-    std::optional<std::reference_wrapper<INSTRUCTION::JMP>> doJMPInstruction;
+    std::optional<size_t> doJMPIndex;
     if (ast.type == AstNode::Statement::While::LOOP_TYPE::DO) {
-        auto jmpPtr = createJMP(0);
-        doJMPInstruction = *jmpPtr;
-        instructions.push_back(std::move(jmpPtr));
+        doJMPIndex = instructions.size();
+        instructions.push_back(createJMP(0));
     }
-    uint16_t loopStart = instructions.size();
+    size_t loopStart = instructions.size();
 
     ast.condition->accept(*this);
-    auto loopBranch = createBRANCH(0);
-    auto* loopBranchInstruction = loopBranch.get();
-    instructions.push_back(std::move(loopBranch));
-    if (doJMPInstruction.has_value()) { // skip branch condition with do statement JMP
-        doJMPInstruction->get().address = instructions.size();
+    size_t loopBranchIndex = instructions.size();
+    instructions.push_back(createBRANCH(0));
+    if (doJMPIndex.has_value()) { // skip branch condition with do statement JMP
+        patchAddress(*doJMPIndex, instructions.size());
     }
 
     for (auto&& statement : ast.block) {
         statement->accept(*this);
     }
-    instructions.push_back(createJMP(loopStart));
-    uint16_t endAddress = instructions.size();
-    loopBranchInstruction->address = endAddress;
+    instructions.push_back(encodeJMP(loopStart));
+    size_t endAddress = instructions.size();
+    patchAddress(loopBranchIndex, endAddress);
 
     auto& loopContinues = continueIndices.top();
     auto& loopBreaks = breakIndices.top();
 
     for (size_t i = 0; i < loopContinues.size(); i++) {  // set continue JMP indices
-        auto& continueInstruction = instructions.at(loopContinues.top());
-        static_cast<INSTRUCTION::JMP&>(*continueInstruction).address = loopStart;
+        patchAddress(loopContinues.top(), loopStart);
         loopContinues.pop();
     }
 
     for (size_t i = 0; i < loopBreaks.size(); i++) {  // set break JMP indices
-        auto& breakInstruction = instructions.at(loopBreaks.top());
-        static_cast<INSTRUCTION::JMP&>(*breakInstruction).address = endAddress;
+        patchAddress(loopBreaks.top(), endAddress);
         loopBreaks.pop();
     }
 
@@ -289,7 +485,7 @@ BlsObject Generator::visit(AstNode::Statement::Return& ast) {
         returnExpression->get()->accept(*this);
     }
     else {  // push void value
-        instructions.push_back(createPUSH(literalPool.at(std::monostate())));
+        instructions.push_back(encodePUSH(literalPool.at(std::monostate())));
     }
     instructions.push_back(createRETURN());
     return 0;
@@ -310,11 +506,11 @@ BlsObject Generator::visit(AstNode::Statement::Break&) {
 BlsObject Generator::visit(AstNode::Statement::Declaration& ast) {
     auto type = getTypeFromName(ast.type->name);
     auto index = ast.localIndex;
-    instructions.push_back(createMKTYPE(index, static_cast<uint8_t>(type)));
+    instructions.push_back(encodeMKTYPE(index, static_cast<uint8_t>(type)));
     auto& value = ast.value;
     if (value.has_value()) {
         value->get()->accept(*this);
-        instructions.push_back(createSTORE(index));
+        instructions.push_back(encodeSTORE(index));
     }
     return 0;
 }
@@ -348,21 +544,21 @@ BlsObject Generator::visit(AstNode::Expression::Binary& ast) {
     switch (op) {
         case BINARY_OPERATOR::OR: {
             ast.left->accept(*this);
+            size_t jmpIndex = instructions.size();
             instructions.push_back(createJMPSC_OR(0)); // create short circuit jump
-            auto& jmp = static_cast<INSTRUCTION::JMPSC_OR&>(*instructions.back());
             ast.right->accept(*this);
             instructions.push_back(createOR());
-            jmp.address = instructions.size();
+            patchAddress(jmpIndex, instructions.size());
             break;
         }
 
         case BINARY_OPERATOR::AND: {
             ast.left->accept(*this);
+            size_t jmpIndex = instructions.size();
             instructions.push_back(createJMPSC_AND(0)); // create short circuit jump
-            auto& jmp = static_cast<INSTRUCTION::JMPSC_AND&>(*instructions.back());
             ast.right->accept(*this);
             instructions.push_back(createAND());
-            jmp.address = instructions.size();
+            patchAddress(jmpIndex, instructions.size());
             break;
         }
 
@@ -478,7 +674,7 @@ BlsObject Generator::visit(AstNode::Expression::Unary& ast) {
 
         // create unary op
         ast.expression->accept(*this); // visit as operand
-        instructions.push_back(createPUSH(literalPool.at(1))); // push literal 1
+        instructions.push_back(encodePUSH(literalPool.at(1))); // push literal 1
         instructions.push_back(std::move(instruction));
 
         instructions.push_back(std::move(storeInstruction)); // move store past unary op
@@ -539,9 +735,13 @@ BlsObject Generator::visit(AstNode::Expression::Function& ast) {
         #undef VARIADIC
         #undef ARGUMENT
         #undef TRAP_END
+        else if (deferLinking) { // callee address is only known once all bodies are linked
+            callFixups.emplace_back(instructions.size(), name);
+            instructions.push_back(createCALL(0, args.size()));
+        }
         else {
             auto address = procedureAddresses.at(name);
-            instructions.push_back(createCALL(address, args.size()));
+            instructions.push_back(encodeCALL(address, args.size()));
         }
     }
     else if (auto* invocable = dynamic_cast<AstNode::Expression::Member*>(ast.invocable.get())) {
@@ -570,10 +770,10 @@ BlsObject Generator::visit(AstNode::Expression::Function& ast) {
 BlsObject Generator::visit(AstNode::Expression::Access& ast) {
     auto localIndex = ast.localIndex;
     if (accessContext == ACCESS_CONTEXT::READ) {
-        instructions.push_back(createLOAD(localIndex));
+        instructions.push_back(encodeLOAD(localIndex));
     }
     else {
-        instructions.push_back(createSTORE(localIndex));
+        instructions.push_back(encodeSTORE(localIndex));
     }
     accessContext = ACCESS_CONTEXT::READ; // reset accessContext
     return 0;
@@ -583,7 +783,7 @@ BlsObject Generator::visit(AstNode::Expression::Member& ast) {
     auto accessContext = this->accessContext;
     this->accessContext = ACCESS_CONTEXT::READ; // read for lhs expression
     ast.object->accept(*this);
-    instructions.push_back(createPUSH(literalPool.at(ast.member)));
+    instructions.push_back(encodePUSH(literalPool.at(ast.member)));
     if (accessContext == ACCESS_CONTEXT::READ) {
         instructions.push_back(createALOAD());
     }
@@ -610,7 +810,7 @@ BlsObject Generator::visit(AstNode::Expression::Subscript& ast) {
 
 BlsObject Generator::visit(AstNode::Expression::Literal& ast) {
     BlsType literal = std::visit([](auto& l){ return BlsType(l); }, ast.literal);
-    instructions.push_back(createPUSH(literalPool.at(literal)));
+    instructions.push_back(encodePUSH(literalPool.at(literal)));
     return 0;
 }
 
@@ -620,13 +820,13 @@ BlsObject Generator::visit(AstNode::Expression::List& ast) {
     auto& list = std::dynamic_pointer_cast<VectorDescriptor>(std::get<std::shared_ptr<HeapDescriptor>>(literal))->getVector();
     for (size_t i = 0; i < list.size(); i++) {
         if (std::holds_alternative<std::monostate>(list.at(i))) { // sub expression needs to be evaluated at runtime
-            instructions.push_back(createPUSH(literalPool.at(literal)));
-            instructions.push_back(createPUSH(literalPool.at(int64_t(i))));
+            instructions.push_back(encodePUSH(literalPool.at(literal)));
+            instructions.push_back(encodePUSH(literalPool.at(int64_t(i))));
             expressions.at(i)->accept(*this);
             instructions.push_back(createASTORE());
         }
     }
-    instructions.push_back(createPUSH(literalPool.at(literal)));
+    instructions.push_back(encodePUSH(literalPool.at(literal)));
     return 0;
 }
 
@@ -643,13 +843,13 @@ BlsObject Generator::visit(AstNode::Expression::Map& ast) {
         if (!keyLiteral
          || std::holds_alternative<std::monostate>(map.at(std::get<std::string>(keyLiteral->literal)))) {
             // key value pair not in map literal at runtime; emplace
-            instructions.push_back(createPUSH(literalPool.at(literal)));
+            instructions.push_back(encodePUSH(literalPool.at(literal)));
             key->accept(*this);
             value->accept(*this);
             instructions.push_back(createMTRAP(static_cast<uint16_t>(BlsTrap::MCALLNUM::map__add)));
         }
     }
-    instructions.push_back(createPUSH(literalPool.at(literal)));
+    instructions.push_back(encodePUSH(literalPool.at(literal)));
     return 0;
 }
 
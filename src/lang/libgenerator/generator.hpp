@@ -8,7 +8,9 @@
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
+#include <boost/asio/thread_pool.hpp>
 
 namespace BlsLang {
 
@@ -17,8 +19,8 @@ namespace BlsLang {
             friend class GeneratorTest;
             Generator(std::vector<TaskDescriptor>& boundTasks
                     , std::unordered_map<std::string, std::vector<std::reference_wrapper<TaskDescriptor>>>& boundTaskMap
-                    , std::unordered_map<BlsType, uint8_t>& literalPool
-                    , std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>>& functionSymbols)
+                    , std::unordered_map<BlsType, uint16_t>& literalPool
+                    , std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>>& functionSymbols)
                     : boundTasks(boundTasks)
                     , boundTaskMap(boundTaskMap)
                     , literalPool(literalPool)
@@ -34,8 +36,21 @@ namespace BlsLang {
 
             void writeBytecode(std::ostream& outputStream);
             void writeBytecode(std::vector<char>& outputVector);
+            // Generates every procedure and task body on pool, then links them in source order
+            void generateConcurrently(AstNode::Source& ast, boost::asio::thread_pool& pool);
         
         private:
+            // Instructions of a single body, addressed relative to its first instruction
+            struct FunctionCode {
+                std::vector<std::unique_ptr<INSTRUCTION>> instructions;
+                std::vector<std::pair<size_t, std::string>> callFixups;
+            };
+
+            FunctionCode generateFunction(AstNode::Function& function);
+            void linkFunction(FunctionCode& code, size_t base);
+            // Sets the target of the jump or call at position, widening it in place if the target needs it
+            void patchAddress(size_t position, size_t address);
+
             enum class ACCESS_CONTEXT : uint8_t {
                   READ
                 , WRITE
@@ -48,11 +63,13 @@ namespace BlsLang {
 
             std::vector<TaskDescriptor>& boundTasks;
             std::unordered_map<std::string, std::vector<std::reference_wrapper<TaskDescriptor>>>& boundTaskMap;
-            std::unordered_map<BlsType, uint8_t>& literalPool;
-            std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>>& functionSymbols;
-            std::unordered_map<std::string, uint16_t> procedureAddresses;
+            std::unordered_map<BlsType, uint16_t>& literalPool;
+            std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>>& functionSymbols;
+            std::unordered_map<std::string, uint32_t> procedureAddresses;
             std::vector<std::unique_ptr<INSTRUCTION>> instructions;
-            std::stack<std::stack<uint16_t>> continueIndices, breakIndices; // needed for break and continue generation
+            std::stack<std::stack<size_t>> continueIndices, breakIndices; // needed for break and continue generation
+            std::vector<std::pair<size_t, std::string>> callFixups; // CALL positions and callees awaiting linking
+            bool deferLinking = false; // body generators leave function addresses to generateConcurrently
             ACCESS_CONTEXT accessContext = ACCESS_CONTEXT::READ; // needed for assignment generation
             FUNCTION_CONTEXT functionContext = FUNCTION_CONTEXT::PROCEDURE;
     };
@@ -0,0 +1,49 @@
+#include "bytecode_interpreter.hpp"
+#include "analyzer.hpp"
+#include "generator.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace BlsLang;
+
+void BytecodeInterpreter::interpretFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Could not open " + filename);
+    }
+    std::stringstream source;
+    source << file.rdbuf();
+    interpretSource(source.str());
+}
+
+// Only tasks bound in setup() are registered, since the generator emits code only for those
+void BytecodeInterpreter::interpretSource(const std::string& source) {
+    Lexer lexer;
+    Parser parser;
+    Analyzer analyzer;
+    auto ast = parser.parse(lexer.lex(source));
+    ast->accept(analyzer);
+
+    Generator generator(analyzer.getBoundTasks()
+                      , analyzer.getBoundTaskMap()
+                      , analyzer.getLiteralPool()
+                      , analyzer.getFunctionSymbols());
+    ast->accept(generator);
+    std::vector<char> bytecode;
+    generator.writeBytecode(bytecode);
+
+    tasks.clear();
+    vm = std::make_unique<VirtualMachine>();
+    vm->loadBytecode(bytecode);
+    for (auto&& [taskName, boundTasks] : analyzer.getBoundTaskMap()) {
+        // bindings of the same task share its bytecode offset
+        auto offset = boundTasks.at(0).get().bytecode_offset;
+        tasks.emplace(taskName, [vm = vm.get(), offset](std::vector<BlsType> args) {
+            vm->setTaskOffset(offset);
+            return vm->transform(std::move(args));
+        });
+    }
+}
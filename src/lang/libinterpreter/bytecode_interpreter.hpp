@@ -0,0 +1,26 @@
+#pragma once
+#include "bls_types.hpp"
+#include "virtual_machine.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BlsLang {
+
+    // Runs sources through the analyzer and generator and executes tasks on the VM,
+    // so locals are slot-resolved and interpreted runs match what the master executes
+    class BytecodeInterpreter {
+        public:
+            void interpretFile(const std::string& filename);
+            void interpretSource(const std::string& source);
+
+            auto& getTasks() { return tasks; }
+
+        private:
+            std::unique_ptr<VirtualMachine> vm;
+            std::unordered_map<std::string, std::function<std::vector<BlsType>(std::vector<BlsType>)>> tasks;
+    };
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "token.hpp"
+#include "char_class.hpp"
 #include <concepts>
 #include <cstddef>
 #include <sstream>
@@ -9,7 +10,8 @@ namespace BlsLang {
 
     template<typename T>
     concept CharacterPattern = std::same_as<T, char>
-                            || std::same_as<T, boost::regex>;
+                            || requires { { T::table } -> std::convertible_to<CharTable>;
+                                          { T::regex } -> std::convertible_to<boost::regex>; };
 
     class CharStream {
         public:
@@ -74,7 +76,7 @@ namespace BlsLang {
         else {
             std::string currChar; 
             currChar = ss.peek();
-            if (ss.eof() || !boost::regex_match(currChar, pattern)) {
+            if (ss.eof() || !boost::regex_match(currChar, T::regex)) {
                 return false;
             }
         }
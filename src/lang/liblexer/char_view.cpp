@@ -0,0 +1,24 @@
+#include "char_view.hpp"
+#include <cstddef>
+
+using namespace BlsLang;
+
+void CharView::loadSource(std::string_view input) {
+    src = input;
+    pos = 0;
+    line = 1;
+    col = 1;
+    resetToken();
+}
+
+void CharView::resetToken() {
+    tokenStart = pos;
+    tokenLine = line;
+    tokenCol = col;
+}
+
+TokenView CharView::emit(Token::Type type) {
+    TokenView t(type, src.substr(tokenStart, pos - tokenStart), tokenStart, tokenLine, tokenCol, line, col);
+    resetToken();
+    return t;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "token.hpp"
+#include "char_stream.hpp"
+#include <cstddef>
+#include <string_view>
+
+namespace BlsLang {
+
+    // Table driven counterpart of CharStream that scans a string_view in place
+    class CharView {
+        public:
+            CharView() {}
+            CharView(std::string_view input) : src(input) {}
+
+            void loadSource(std::string_view input);
+            // Looks ahead in source (without consuming characters) for characters matching given patterns
+            template<CharacterPattern... Args>
+            bool peek(Args... patterns) const;
+            // Looks ahead in source for characters matching given patterns and consumes matching characters
+            template<CharacterPattern... Args>
+            bool match(Args... patterns);
+            void resetToken();
+            // Creates a token referencing the currently consumed characters
+            TokenView emit(Token::Type type);
+            bool empty() const { return pos >= src.size(); }
+            std::string_view getTokenState() const { return src.substr(tokenStart, pos - tokenStart); }
+            size_t getLine() const { return line; }
+            size_t getColumn() const { return col; }
+        private:
+            template<CharacterPattern T>
+            bool peekPattern(T pattern, size_t idx) const;
+
+            std::string_view src;
+            size_t pos = 0, tokenStart = 0;
+            size_t line = 1, col = 1, tokenLine = 1, tokenCol = 1;
+    };
+
+    template<CharacterPattern... Args>
+    inline bool CharView::peek(Args... patterns) const {
+        size_t idx = pos;
+        return (peekPattern(patterns, idx++) && ...);
+    }
+
+    template<CharacterPattern... Args>
+    inline bool CharView::match(Args... patterns) {
+        if (!peek(patterns...)) return false;
+        size_t numPatterns = sizeof...(patterns);
+        for (size_t i = 0; i < numPatterns; i++) {
+            col++;
+            if (src[pos++] == '\n') {
+                line++;
+                col = 1;
+            }
+        }
+        return true;
+    }
+
+    template<CharacterPattern T>
+    inline bool CharView::peekPattern(T pattern, size_t idx) const {
+        if (idx >= src.size()) {
+            return false;
+        }
+        if constexpr (std::is_same<T, char>()) {
+            return src[idx] == pattern;
+        }
+        else {
+            return T::table.contains(src[idx]);
+        }
+    }
+}
@@ -9,45 +9,70 @@
 using namespace BlsLang;
 
 std::vector<Token> Lexer::lex(const std::string& input) {
-    cs.loadSource(input);
     std::vector<Token> tokens;
+    if (mode == Mode::TABLE) {
+        auto views = lexView(input);
+        tokens.reserve(views.size());
+        for (auto& view : views) {
+            tokens.push_back(view.toToken());
+        }
+        return tokens;
+    }
+
+    cs.loadSource(input);
     while (!cs.empty()) {
         while (cs.match(WHITESPACE));
         cs.resetToken();
         if (!cs.empty()) { // prevent attempts to lex empty token when EOF is reached
-            tokens.push_back(lexToken());
+            tokens.push_back(lexToken(cs));
+        }
+    }
+    return tokens;
+}
+
+std::vector<TokenView> Lexer::lexView(std::string_view input) {
+    cv.loadSource(input);
+    std::vector<TokenView> tokens;
+    while (!cv.empty()) {
+        while (cv.match(WHITESPACE));
+        cv.resetToken();
+        if (!cv.empty()) { // prevent attempts to lex empty token when EOF is reached
+            tokens.push_back(lexToken(cv));
         }
     }
     return tokens;
 }
 
-Token Lexer::lexToken() {
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexToken(Stream& cs) {
     if (cs.peek(IDENTIFIER_START)) {
-        return lexIdentifier();
+        return lexIdentifier(cs);
     }
     else if (cs.peek(NUMERIC_DIGIT) || cs.peek(DECIMAL_POINT, NUMERIC_DIGIT)) {
-        return lexNumber();
+        return lexNumber(cs);
     }
     else if (cs.peek(STRING_QUOTE)) {
-        return lexString();
+        return lexString(cs);
     }
     else if (cs.peek(COMMENT_SLASH, COMMENT_SLASH)
           || cs.peek(COMMENT_SLASH, COMMENT_STAR)) {
-        return lexComment();
+        return lexComment(cs);
     }
     else {
-        return lexOperator();
+        return lexOperator(cs);
     }
 }
 
-Token Lexer::lexIdentifier() {
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexIdentifier(Stream& cs) {
     cs.match(IDENTIFIER_START);
     while (cs.match(IDENTIFIER_END));
     return cs.emit(Token::Type::IDENTIFIER);
 }
 
-Token Lexer::lexNumber() {
-    Token::Type tokenType = Token::Type::INTEGER;
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexNumber(Stream& cs) {
+    auto tokenType = Token::Type::INTEGER;
 
     if (cs.match(ZERO, HEX_START, HEX_DIGIT)) { // hexadecmial literal
         while (cs.match(HEX_DIGIT));
@@ -69,7 +94,8 @@ Token Lexer::lexNumber() {
     return cs.emit(tokenType);
 }
 
-Token Lexer::lexString() {
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexString(Stream& cs) {
     cs.match(STRING_QUOTE); // consume opening quote
     while (!cs.match(STRING_QUOTE)) {
         if (cs.peek(ESCAPE_SLASH)) {  // consume escape sequence
@@ -84,7 +110,8 @@ Token Lexer::lexString() {
     return cs.emit(Token::Type::STRING);
 }
 
-Token Lexer::lexComment() {
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexComment(Stream& cs) {
     if (cs.match(COMMENT_SLASH, COMMENT_SLASH)) { // singleline comment
         while(cs.match(COMMENT_CONTENTS_SINGLELINE));
     }
@@ -99,7 +126,8 @@ Token Lexer::lexComment() {
     return cs.emit(Token::Type::COMMENT);
 }
 
-Token Lexer::lexOperator() {
+template<typename Stream>
+Lexer::StreamToken<Stream> Lexer::lexOperator(Stream& cs) {
     if (cs.match(OPERATOR_EQUALS_PREFIX, OPERATOR_EQUALS)
      || cs.match(OPERATOR_PLUS, OPERATOR_PLUS)
      || cs.match(OPERATOR_MINUS, OPERATOR_MINUS)
@@ -1,7 +1,10 @@
 #pragma once
 #include "token.hpp"
 #include "char_stream.hpp"
+#include "char_view.hpp"
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <boost/regex.hpp>
 
@@ -10,17 +13,39 @@ namespace BlsLang {
     class Lexer {
         public:
             friend class LexerTest;
+
+            enum class Mode {
+                STREAM,     // regex matching over an istringstream
+                TABLE       // character class tables over a string_view
+            };
+
+            Lexer(Mode mode = Mode::TABLE) : mode(mode) {}
+
             std::vector<Token> lex(const std::string& input);
+            // Table driven lex whose tokens reference the input instead of copying it
+            std::vector<TokenView> lexView(std::string_view input);
 
         private:
+            Mode mode;
             CharStream cs;
+            CharView cv;
+
+            // Token type emitted by a stream (Token for CharStream, TokenView for CharView)
+            template<typename Stream>
+            using StreamToken = decltype(std::declval<Stream&>().emit(Token::Type::COUNT));
 
-            Token lexToken();
-            Token lexIdentifier();
-            Token lexNumber();
-            Token lexString();
-            Token lexComment();
-            Token lexOperator();
+            template<typename Stream>
+            StreamToken<Stream> lexToken(Stream& cs);
+            template<typename Stream>
+            StreamToken<Stream> lexIdentifier(Stream& cs);
+            template<typename Stream>
+            StreamToken<Stream> lexNumber(Stream& cs);
+            template<typename Stream>
+            StreamToken<Stream> lexString(Stream& cs);
+            template<typename Stream>
+            StreamToken<Stream> lexComment(Stream& cs);
+            template<typename Stream>
+            StreamToken<Stream> lexOperator(Stream& cs);
     };
 
-}
\ No newline at end of file
+}
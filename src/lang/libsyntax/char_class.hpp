@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <boost/regex.hpp>
+
+namespace BlsLang {
+
+    // String literal usable as a template argument
+    template<size_t N>
+    struct FixedString {
+        constexpr FixedString(const char (&str)[N]) { std::copy_n(str, N, value); }
+        constexpr std::string_view view() const { return std::string_view(value, N - 1); }
+        char value[N];
+    };
+
+    // Membership table over all byte values
+    class CharTable {
+        public:
+            constexpr bool contains(char c) const { return table[static_cast<unsigned char>(c)]; }
+
+            // Builds a table from the body of a regex bracket expression (ranges, escapes and leading ^ are supported)
+            static consteval CharTable fromBracket(std::string_view spec) {
+                CharTable result;
+                bool negated = !spec.empty() && spec.front() == '^';
+                size_t i = negated ? 1 : 0;
+                while (i < spec.size()) {
+                    unsigned char low = next(spec, i);
+                    unsigned char high = low;
+                    if (i + 1 < spec.size() && spec[i] == '-') {
+                        i++;
+                        high = next(spec, i);
+                    }
+                    for (unsigned int c = low; c <= high; c++) {
+                        result.table[c] = true;
+                    }
+                }
+                if (negated) {
+                    for (auto& entry : result.table) {
+                        entry = !entry;
+                    }
+                }
+                return result;
+            }
+
+            static consteval CharTable all() {
+                CharTable result;
+                result.table.fill(true);
+                return result;
+            }
+
+        private:
+            static consteval unsigned char next(std::string_view spec, size_t& i) {
+                char c = spec[i++];
+                if (c != '\\' || i == spec.size()) {
+                    return c;
+                }
+                c = spec[i++];
+                switch (c) {
+                    case 'n': return '\n';
+                    case 'r': return '\r';
+                    case 't': return '\t';
+                    case 'f': return '\f';
+                    case 'v': return '\v';
+                    default: return c;
+                }
+            }
+
+            std::array<bool, 256> table{};
+    };
+
+    /*
+        Character class defined once by a regex bracket body. The table is generated at
+        compile time for the string_view lexer, the regex backs the stream lexer.
+    */
+    template<FixedString Spec>
+    struct CharClass {
+        static constexpr CharTable table = CharTable::fromBracket(Spec.view());
+        static inline const boost::regex regex{"[" + std::string(Spec.view()) + "]"};
+    };
+
+    // Matches any character (regex ".")
+    struct AnyChar {
+        static constexpr CharTable table = CharTable::all();
+        static inline const boost::regex regex{"."};
+    };
+
+}
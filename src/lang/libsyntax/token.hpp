@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <string>
+#include <string_view>
 #include <array>
 
 namespace BlsLang {
@@ -56,4 +57,38 @@ namespace BlsLang {
             size_t absIdx, lineStart, colStart, lineEnd, colEnd;
     };
 
+    // Token referencing its characters in the lexed source (the source must outlive it)
+    class TokenView {
+        public:
+            TokenView(Token::Type type
+                    , std::string_view literal
+                    , size_t absIdx = 0
+                    , size_t lineStart = 0
+                    , size_t colStart = 0
+                    , size_t lineEnd = 0
+                    , size_t colEnd = 0)
+                    : type(type)
+                    , literal(literal)
+                    , absIdx(absIdx)
+                    , lineStart(lineStart)
+                    , colStart(colStart)
+                    , lineEnd(lineEnd)
+                    , colEnd(colEnd) {}
+            Token::Type getType() const { return type; }
+            std::string_view getLiteral() const { return literal; }
+            size_t getAbsIdx() const { return absIdx; }
+            size_t getLineStart() const { return lineStart; }
+            size_t getColStart() const { return colStart; }
+            size_t getLineEnd() const { return lineEnd; }
+            size_t getColEnd() const { return colEnd; }
+            // Copies the referenced characters into an owning token
+            Token toToken() const { return Token(type, std::string(literal), absIdx, lineStart, colStart, lineEnd, colEnd); }
+            bool operator==(const TokenView&) const = default;
+
+        private:
+            Token::Type type;
+            std::string_view literal;
+            size_t absIdx, lineStart, colStart, lineEnd, colEnd;
+    };
+
 }
@@ -45,6 +45,10 @@ std::vector<bool>& VirtualMachine::getModifiedStates() {
 }
 
 void VirtualMachine::CALL(uint16_t address, uint8_t argc, int) {
+    CALL_W(address, argc);
+}
+
+void VirtualMachine::CALL_W(uint32_t address, uint8_t argc, int) {
     std::vector<BlsType> args;
     args.resize(argc);
     for (auto&& arg : std::ranges::reverse_view(args)) {
@@ -59,11 +63,19 @@ void VirtualMachine::EMIT(uint8_t signal, int) {
 }
 
 void VirtualMachine::PUSH(uint8_t index, int) {
+    PUSH_W(index);
+}
+
+void VirtualMachine::PUSH_W(uint16_t index, int) {
     auto value = literalPool[index];
     cs.pushOperand(value);
 }
 
 void VirtualMachine::MKTYPE(uint8_t index, uint8_t type, int) {
+    MKTYPE_W(index, type);
+}
+
+void VirtualMachine::MKTYPE_W(uint16_t index, uint8_t type, int) {
     TYPE objType = static_cast<TYPE>(type);
     BlsType value;
     switch (objType) {
@@ -107,6 +119,10 @@ void VirtualMachine::MKTYPE(uint8_t index, uint8_t type, int) {
 }
 
 void VirtualMachine::STORE(uint8_t index, int) {
+    STORE_W(index);
+}
+
+void VirtualMachine::STORE_W(uint16_t index, int) {
     auto value = cs.popOperand();
     cs.getLocal(index).uncheckedAssign(value);
     if (index < modifiedStates.size()) {
@@ -115,6 +131,10 @@ void VirtualMachine::STORE(uint8_t index, int) {
 }
 
 void VirtualMachine::LOAD(uint8_t index, int) {
+    LOAD_W(index);
+}
+
+void VirtualMachine::LOAD_W(uint16_t index, int) {
     auto variable = cs.getLocal(index);
     cs.pushOperand(variable);
 }
@@ -230,10 +250,18 @@ void VirtualMachine::EXP(int) {
 }
 
 void VirtualMachine::JMP(uint16_t address, int) {
+    JMP_W(address);
+}
+
+void VirtualMachine::JMP_W(uint32_t address, int) {
     instruction = address;
 }
 
 void VirtualMachine::BRANCH(uint16_t address, int) {
+    BRANCH_W(address);
+}
+
+void VirtualMachine::BRANCH_W(uint32_t address, int) {
     auto condition = cs.popOperand();
     if (!condition) {
         instruction = address;
@@ -312,6 +340,10 @@ void VirtualMachine::MTRAP(uint16_t callnum, int) {
 }
 
 void VirtualMachine::JMPSC_OR(uint16_t address, int) {
+    JMPSC_OR_W(address);
+}
+
+void VirtualMachine::JMPSC_OR_W(uint32_t address, int) {
     auto lhs = cs.popOperand();
     if (lhs) {
         instruction = address;
@@ -320,6 +352,10 @@ void VirtualMachine::JMPSC_OR(uint16_t address, int) {
 }
 
 void VirtualMachine::JMPSC_AND(uint16_t address, int) {
+    JMPSC_AND_W(address);
+}
+
+void VirtualMachine::JMPSC_AND_W(uint32_t address, int) {
     auto lhs = cs.popOperand();
     if (!lhs) {
         instruction = address;
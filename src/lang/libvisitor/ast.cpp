@@ -148,7 +148,7 @@ AstNode::Expression::Map::Map(const AstNode::Expression::Map& other) {
 }
 
 /* AstNode::Expression::Access */
-AstNode::Expression::Access::Access(std::string identifier, uint8_t localIndex)
+AstNode::Expression::Access::Access(std::string identifier, uint16_t localIndex)
                                   : identifier(std::move(identifier))
                                   , localIndex(localIndex)
                                   {}
@@ -290,7 +290,7 @@ AstNode::Statement::Declaration::Declaration(std::string name
                                            , std::unordered_set<std::string> modifiers
                                            , std::unique_ptr<AstNode::Specifier::Type> type
                                            , std::optional<std::unique_ptr<AstNode::Expression>> value
-                                           , uint8_t localIndex)
+                                           , uint16_t localIndex)
                                            : name(std::move(name))
                                            , modifiers(modifiers)
                                            , type(std::move(type))
@@ -302,7 +302,7 @@ AstNode::Statement::Declaration::Declaration(std::string name
                                            , std::unordered_set<std::string> modifiers
                                            , AstNode::Specifier::Type* type
                                            , std::optional<AstNode::Expression*> value
-                                           , uint8_t localIndex)
+                                           , uint16_t localIndex)
                                            : name(std::move(name))
                                            , modifiers(modifiers)
                                            , type(type)
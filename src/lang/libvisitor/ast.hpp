@@ -193,7 +193,7 @@ namespace BlsLang {
 
     struct AstNode::Expression::Access : public AstNode::Expression {
         Access() = default;
-        Access(std::string identifier, uint8_t localIndex = 0);
+        Access(std::string identifier, uint16_t localIndex = 0);
         Access(const Access& other);
         Access& operator=(const Access& rhs);
         
@@ -205,7 +205,7 @@ namespace BlsLang {
         constexpr auto getChildNames() { return packChildNames("identifier", "localIndex"); }
 
         std::string identifier;
-        uint8_t localIndex;
+        uint16_t localIndex;
     };
 
     struct AstNode::Expression::Member : public AstNode::Expression {
@@ -389,12 +389,12 @@ namespace BlsLang {
                   , std::unordered_set<std::string> modifiers
                   , std::unique_ptr<AstNode::Specifier::Type> type
                   , std::optional<std::unique_ptr<AstNode::Expression>> value
-                  , uint8_t localIndex = 0);
+                  , uint16_t localIndex = 0);
         Declaration(std::string name
                   , std::unordered_set<std::string> modifiers
                   , AstNode::Specifier::Type* type
                   , std::optional<AstNode::Expression*> value
-                  , uint8_t localIndex = 0);
+                  , uint16_t localIndex = 0);
         Declaration(const Declaration& other);
         Declaration& operator=(const Declaration& rhs);
 
@@ -409,7 +409,7 @@ namespace BlsLang {
         std::unordered_set<std::string> modifiers;
         std::unique_ptr<AstNode::Specifier::Type> type;
         std::optional<std::unique_ptr<AstNode::Expression>> value;
-        uint8_t localIndex;
+        uint16_t localIndex;
     };
 
     struct AstNode::Statement::Continue : public AstNode::Statement {
@@ -1,8 +1,12 @@
 #include "EM.hpp"
 #include "Serialization.hpp"
+#include "LatencyTrace.hpp"
 #include "MM.hpp"
 #include "Scheduler.hpp"
+#include "Executor.hpp"
 #include "bls_types.hpp"
+#include <algorithm>
+#include <iostream>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
@@ -13,10 +17,14 @@
 
 ExecutionManager::ExecutionManager(std::vector<TaskDescriptor> TaskList, TSQ<EMStateMessage> &readMM, 
     TSQ<HeapMasterMessage> &sendMM,
-    std::vector<char>& bytecode)
-    : readMM(readMM), sendMM(sendMM), scheduler(TaskList, [this](HeapMasterMessage dmm){this->sendMM.write(dmm);})
+    std::vector<char>& bytecode, size_t executorWorkers, bool leaseDevices)
+    : readMM(readMM), sendMM(sendMM), scheduler(TaskList, [this](HeapMasterMessage dmm){this->sendMM.write(dmm);}, leaseDevices)
 {
     this->TaskList = TaskList;
+    // A worker count of zero keeps one thread per execution unit
+    if(executorWorkers > 0){
+        this->executor = std::make_unique<WorkStealingPool>(executorWorkers); 
+    }
     for(auto &task : TaskList)
     {
         std::string TaskName = task.name;
@@ -31,13 +39,13 @@ ExecutionManager::ExecutionManager(std::vector<TaskDescriptor> TaskList, TSQ<EMS
         }
 
         auto bytecodeOffset = task.bytecode_offset;
-        EU_map[TaskName] = std::make_unique<ExecutionUnit>(task, devices, isVtype, controllers, this->sendMM, bytecodeOffset, bytecode, this->scheduler, eu_ctx);
+        EU_map[TaskName] = std::make_unique<ExecutionUnit>(task, devices, isVtype, controllers, this->sendMM, bytecodeOffset, bytecode, this->scheduler, eu_ctx, this->executor.get());
     }
 }
 
 ExecutionUnit::ExecutionUnit(TaskDescriptor task, std::vector<std::string> devices, std::vector<bool> isVtype, std::vector<std::string> controllers,
-    TSQ<HeapMasterMessage> &sendMM, size_t bytecodeOffset, std::vector<char>& bytecode, DeviceScheduler &devScheduler, asio::io_context &ctx)
-    : globalScheduler(devScheduler), sendMM(sendMM), ctx(ctx)
+    TSQ<HeapMasterMessage> &sendMM, size_t bytecodeOffset, std::vector<char>& bytecode, DeviceScheduler &devScheduler, asio::io_context &ctx, WorkStealingPool *executor)
+    : executor(executor), globalScheduler(devScheduler), sendMM(sendMM), ctx(ctx)
 {
     this->Task = task;
     this->devices = devices;
@@ -56,12 +64,16 @@ ExecutionUnit::ExecutionUnit(TaskDescriptor task, std::vector<std::string> devic
     }
 
     //this->running(vtypeHMMsMap, sendMM);
-    this->executionThread = std::thread(&ExecutionUnit::running, this);
+    if(this->executor == nullptr){
+        this->executionThread = std::thread(&ExecutionUnit::running, this);
+    }
 }
 
 ExecutionUnit::~ExecutionUnit()
 {
-    this->executionThread.join();
+    if(this->executionThread.joinable()){
+        this->executionThread.join();
+    }
 }
 
 HeapMasterMessage::HeapMasterMessage(std::shared_ptr<HeapDescriptor> heapTree, Task_Info info, PROTOCOLS protocol, bool isInterrupt)
@@ -81,7 +93,7 @@ DynamicMasterMessage::DynamicMasterMessage(DynamicMessage DM, Task_Info info, PR
 }
 
 
-void ExecutionUnit::replaceCachedStates(std::unordered_map<DeviceID, HeapMasterMessage> &cachedHMMs){
+bool ExecutionUnit::replaceCachedStates(std::unordered_map<DeviceID, HeapMasterMessage> &cachedHMMs){
 
     auto replacementItems = this->replacementCache.getMap(); 
     for(auto& item : replacementItems){
@@ -91,6 +103,7 @@ void ExecutionUnit::replaceCachedStates(std::unordered_map<DeviceID, HeapMasterM
         HeapMasterMessage replaceHMM = item.second;
         cachedHMMs[devState] = replaceHMM; 
     }
+    return !replacementItems.empty(); 
 }
 
 
@@ -98,95 +111,242 @@ void ExecutionUnit::running()
 {
     while(true)
     {
-
         EMStateMessage currentHMMs = EUcache.read();
+        this->execute(currentHMMs); 
+    }
+}
 
-        this->TriggerName = currentHMMs.TriggerName;  
-        //std::cout<<this->Task.name <<" TRIGGERED BY: "<<TriggerName<<std::endl; 
+void ExecutionUnit::schedule()
+{
+    if(!this->scheduled.exchange(true)){
+        this->executor->submit([this](){this->runScheduled();}); 
+    }
+}
 
-        std::unordered_map<DeviceID, HeapMasterMessage> HMMs;
-        
-        // Fill in the known data into the stack 
-        for(auto &HMM : currentHMMs.dmm_list)
-        {   
-            HMMs[HMM.info.device] = HMM; 
+void ExecutionUnit::runScheduled()
+{
+    // One activation per job so a busy task yields its worker between runs
+    if(auto currentHMMs = this->EUcache.pop()){
+        this->execute(*currentHMMs); 
+    }
+
+    if(this->EUcache.isEmpty()){
+        this->scheduled.store(false); 
+        // An activation written before the flag cleared would otherwise be missed
+        if(this->EUcache.isEmpty() || this->scheduled.exchange(true)){
+            return; 
         }
+    }
 
-        this->globalScheduler.request(this->Task.name, currentHMMs.priority); 
+    this->executor->submit([this](){this->runScheduled();}); 
+}
 
-        replaceCachedStates(HMMs); 
-        
-        std::vector<BlsType> transformableStates;
+void ExecutionUnit::stageReload(TaskDescriptor task, std::shared_ptr<const std::vector<char>> bytecode)
+{
+    std::lock_guard<std::mutex> lock(this->reloadMutex); 
+    this->pendingReload = PendingReload{std::move(task), std::move(bytecode)}; 
+}
 
-        // Tell the mailbox that the process is in execution
-        HeapMasterMessage execMsg;
-        execMsg.info.task = this->Task.name;
-        execMsg.protocol = PROTOCOLS::PROCESS_EXEC; 
-        this->sendMM.write(execMsg);
+void ExecutionUnit::applyPendingReload()
+{
+    std::optional<PendingReload> reload; 
+    {
+        std::lock_guard<std::mutex> lock(this->reloadMutex); 
+        reload.swap(this->pendingReload); 
+    }
+    if(!reload){
+        return; 
+    }
 
-        int i = 0; 
-        for(auto& deviceDesc : this->Task.binded_devices){
-            DeviceID devName = deviceDesc.device_name; 
-
-            if(HMMs.contains(devName)){
-                auto state = HMMs.at(devName).heapTree;
-                if (std::holds_alternative<std::shared_ptr<HeapDescriptor>>(state)) {
-                    // make sure default is set to unmodified (may not be needed depending on serialization
-                    auto desc = std::get<std::shared_ptr<HeapDescriptor>>(state)->clone();
-                    desc->modified = false;
-                    desc->index = i;  
-                    state = std::move(desc);
-                    
-                }
-                transformableStates.push_back(state); 
-            }
-            else{
-                auto defDevice = deviceDesc.initialValue; 
-                if (std::holds_alternative<std::shared_ptr<HeapDescriptor>>(defDevice)) {
-                    // make sure default is set to unmodified (may not be needed depending on serialization
-                    auto desc = std::get<std::shared_ptr<HeapDescriptor>>(defDevice)->clone();
-                    desc->modified = false;
-                    desc->index = i; 
-                    defDevice = std::move(desc);
-                }
-                transformableStates.push_back(defDevice); 
-            }
-            i++; 
+    // Only reached between activations, so the VM holds no frames of the old program
+    this->Task = reload->task; 
+    this->vm.loadBytecode(*reload->bytecode); 
+    this->vm.setTaskOffset(this->Task.bytecode_offset); 
+}
+
+void ExecutionUnit::execute(EMStateMessage &currentHMMs)
+{
+    this->applyPendingReload(); 
+    this->TriggerName = currentHMMs.TriggerName;  
+    //std::cout<<this->Task.name <<" TRIGGERED BY: "<<TriggerName<<std::endl; 
+
+    std::unordered_map<DeviceID, HeapMasterMessage> HMMs;
+    // The most recent traced state is followed as the event that triggered the run
+    TraceContext trace; 
+    auto& tracer = LatencyTracer::instance(); 
+    
+    // Fill in the known data into the stack 
+    for(auto &HMM : currentHMMs.dmm_list)
+    {   
+        HMMs[HMM.info.device] = HMM; 
+        if(HMM.info.trace.active() && HMM.info.trace.stamp > trace.stamp){
+            trace = HMM.info.trace; 
         }
+    }
+    tracer.record(trace, TraceStage::TRIGGER_QUEUE); 
+
+    // Writes that only happen on some paths are left unowned until a run actually takes one
+    std::vector<BlsType> transformableStates; 
+    std::vector<bool> modifiedStates; 
+    if(this->Task.deferOwnership){
+        this->notifyMailbox(PROTOCOLS::PROCESS_EXEC); 
+        transformableStates = this->loadStates(HMMs); 
+        modifiedStates = this->runTask(transformableStates); 
+        if(!this->writesOutDevice(modifiedStates)){
+            this->globalScheduler.skip(this->Task.name); 
+            this->replacementCache.clear(); 
+            return; 
+        }
+        // The mailbox stays in execution until the ownership requests switch it to forwarding,
+        // so nothing arriving meanwhile triggers the task again
+    }
 
-        transformableStates = vm.transform(transformableStates);
-        auto& modifiedStates = vm.getModifiedStates();
+    this->globalScheduler.request(this->Task.name, currentHMMs.priority); 
+    tracer.record(trace, TraceStage::SCHEDULER); 
 
-        std::vector<HeapMasterMessage> outGoingStates;  
+    bool replaced = replaceCachedStates(HMMs); 
 
-        // Release before retrieval
-        this->globalScheduler.release(this->Task.name);
+    // Tell the mailbox that the process is in execution
+    this->notifyMailbox(PROTOCOLS::PROCESS_EXEC); 
 
-        for(auto& devDesc : this->Task.outDevices)
-        {   
-            size_t pos = this->devicePositionMap[devDesc.device_name];
-            if (!modifiedStates.at(pos)) continue;
-            auto transformedState = transformableStates.at(pos);
-            HeapMasterMessage newHMM; 
-            newHMM.info.controller = devDesc.controller;
-            newHMM.info.device = devDesc.device_name; 
-            newHMM.info.isVtype = devDesc.isVtype; 
-            newHMM.info.task = this->Task.name; 
-            newHMM.protocol = PROTOCOLS::SENDSTATES;
-            newHMM.isInterrupt = false; 
-            newHMM.heapTree = transformedState;
-            newHMM.isCursor = (devDesc.deviceKind == DeviceKind::CURSOR);
-            outGoingStates.push_back(newHMM); 
+    // A deferred run is only repeated when a state changed while ownership was acquired. Out devices count too,
+    // since a partial write keeps the other attributes of the state the run started from
+    if(!this->Task.deferOwnership || replaced){
+        transformableStates = this->loadStates(HMMs);
+        modifiedStates = this->runTask(transformableStates); 
+    }
+    tracer.record(trace, TraceStage::VM_EXEC); 
+
+    std::vector<HeapMasterMessage> outGoingStates;  
+
+    // Release before retrieval
+    this->globalScheduler.release(this->Task.name);
+
+    for(auto& devDesc : this->Task.outDevices)
+    {   
+        size_t pos = this->devicePositionMap[devDesc.device_name];
+        if (!modifiedStates.at(pos)) continue;
+        auto transformedState = transformableStates.at(pos);
+        HeapMasterMessage newHMM; 
+        newHMM.info.controller = devDesc.controller;
+        newHMM.info.device = devDesc.device_name; 
+        newHMM.info.isVtype = devDesc.isVtype; 
+        newHMM.info.task = this->Task.name; 
+        newHMM.protocol = PROTOCOLS::SENDSTATES;
+        newHMM.isInterrupt = false; 
+        newHMM.heapTree = transformedState;
+        newHMM.isCursor = (devDesc.deviceKind == DeviceKind::CURSOR);
+        newHMM.info.trace = trace; 
+        outGoingStates.push_back(newHMM); 
+    }
+
+    for(HeapMasterMessage& hmm : outGoingStates)
+    {
+        this->sendMM.write(hmm);
+    }
+
+    // clear the replacement cache since the task ran successfully
+    this->replacementCache.clear(); 
+}
+
+void ExecutionUnit::notifyMailbox(PROTOCOLS protocol)
+{
+    HeapMasterMessage execMsg;
+    execMsg.info.task = this->Task.name;
+    execMsg.protocol = protocol; 
+    this->sendMM.write(execMsg);
+}
+
+std::vector<BlsType> ExecutionUnit::loadStates(std::unordered_map<DeviceID, HeapMasterMessage> &HMMs)
+{
+    std::vector<BlsType> transformableStates;
+    int i = 0; 
+    for(auto& deviceDesc : this->Task.binded_devices){
+        DeviceID devName = deviceDesc.device_name; 
+
+        if(HMMs.contains(devName)){
+            auto state = HMMs.at(devName).heapTree;
+            if (std::holds_alternative<std::shared_ptr<HeapDescriptor>>(state)) {
+                // make sure default is set to unmodified (may not be needed depending on serialization
+                auto desc = std::get<std::shared_ptr<HeapDescriptor>>(state)->clone();
+                desc->modified = false;
+                desc->index = i;  
+                state = std::move(desc);
+                
+            }
+            transformableStates.push_back(state); 
         }
+        else{
+            auto defDevice = deviceDesc.initialValue; 
+            if (std::holds_alternative<std::shared_ptr<HeapDescriptor>>(defDevice)) {
+                // make sure default is set to unmodified (may not be needed depending on serialization
+                auto desc = std::get<std::shared_ptr<HeapDescriptor>>(defDevice)->clone();
+                desc->modified = false;
+                desc->index = i; 
+                defDevice = std::move(desc);
+            }
+            transformableStates.push_back(defDevice); 
+        }
+        i++; 
+    }
+    return transformableStates; 
+}
 
-        for(HeapMasterMessage& hmm : outGoingStates)
-        {
-            this->sendMM.write(hmm);
+std::vector<bool> ExecutionUnit::runTask(std::vector<BlsType> &states)
+{
+    if(!this->Task.fusedTasks.empty()){
+        return this->transformFused(states); 
+    }
+    states = vm.transform(states);
+    return vm.getModifiedStates(); 
+}
+
+bool ExecutionUnit::writesOutDevice(const std::vector<bool> &modifiedStates)
+{
+    return std::ranges::any_of(this->Task.outDevices, [&](const DeviceDescriptor& devDesc){
+        return modifiedStates.at(this->devicePositionMap.at(devDesc.device_name)); 
+    }); 
+}
+
+std::vector<bool> ExecutionUnit::transformFused(std::vector<BlsType> &states)
+{
+    std::vector<bool> modifiedStates(states.size(), false); 
+    for(auto& member : this->Task.fusedTasks){
+        std::vector<BlsType> memberStates; 
+        for(size_t j = 0; j < member.devicePositions.size(); j++){
+            auto& state = states.at(member.devicePositions.at(j)); 
+            if(std::holds_alternative<std::shared_ptr<HeapDescriptor>>(state)){
+                // Traps index devices by the parameter position of the running member
+                std::get<std::shared_ptr<HeapDescriptor>>(state)->index = j; 
+            }
+            memberStates.push_back(state); 
         }
 
-        // clear the replacement cache since the task ran successfully
-        this->replacementCache.clear(); 
+        this->activePositions = &member.devicePositions; 
+        this->vm.setTaskOffset(member.bytecode_offset); 
+        memberStates = this->vm.transform(memberStates); 
+        this->activePositions = nullptr; 
+
+        auto& memberModified = this->vm.getModifiedStates(); 
+        for(size_t j = 0; j < member.devicePositions.size(); j++){
+            auto pos = member.devicePositions.at(j); 
+            states.at(pos) = memberStates.at(j); 
+            if(memberModified.at(j)){
+                modifiedStates.at(pos) = true; 
+            }
+        }
     }
+    return modifiedStates; 
+}
+
+size_t ExecutionUnit::resolveDeviceIndex(size_t index)
+{
+    return this->activePositions ? this->activePositions->at(index) : index; 
+}
+
+void ExecutionManager::reloadTask(TaskDescriptor task, std::shared_ptr<const std::vector<char>> bytecode)
+{
+    this->EU_map.at(task.name)->stageReload(std::move(task), std::move(bytecode)); 
 }
 
 ExecutionUnit &ExecutionManager::assign(HeapMasterMessage DMM)
@@ -204,6 +364,7 @@ void ExecutionManager::running()
     {
         // Send an initial request for data to be stored int the queues
         if(started){
+            this->scheduler.grantLeases(); 
             for(auto& pair : EU_map)
             {
                 Task_Info info = pair.second->info;
@@ -246,6 +407,9 @@ void ExecutionManager::running()
             }
             default:{
                 assignedUnit.EUcache.write(currentDMMs);
+                if(this->executor){
+                    assignedUnit.schedule(); 
+                }
                 break; 
             }
 
@@ -278,12 +442,13 @@ void ExecutionUnit::sendPushState(std::vector<BlsType> typeList){
             }
 
             this->vm.getModifiedStates()[index] = false; 
+            auto& device = this->Task.binded_devices.at(this->resolveDeviceIndex(index)); 
 
             // TODO: CHANGE THIS TO USE THE ACTUAL NAME INSTEAD OF THE ALIAS
-            pushStateHmm.info.device = this->Task.binded_devices.at(index).device_name; 
+            pushStateHmm.info.device = device.device_name; 
             pushStateHmm.info.task = this->Task.name; 
-            pushStateHmm.info.controller = this->Task.binded_devices.at(index).controller; 
-            pushStateHmm.isCursor = (this->Task.binded_devices.at(index).deviceKind == DeviceKind::CURSOR); 
+            pushStateHmm.info.controller = device.controller; 
+            pushStateHmm.isCursor = (device.deviceKind == DeviceKind::CURSOR); 
             this->sendMM.write(pushStateHmm); 
         }
     }
@@ -304,8 +469,9 @@ std::vector<BlsType> ExecutionUnit::sendPullState(std::vector<BlsType> typeList)
             else{
                 throw std::runtime_error("Suppose for pushing to non-primative device is not yet implemented");
             }
-            auto& deviceName =  this->Task.binded_devices.at(index).device_name; 
-            auto& controllerName =  this->Task.binded_devices.at(index).controller; 
+            auto& device = this->Task.binded_devices.at(this->resolveDeviceIndex(index)); 
+            auto& deviceName =  device.device_name; 
+            auto& controllerName =  device.controller; 
 
             this->pullPlacement.emplace(deviceName, i); 
             pullStateHmm.protocol = PROTOCOLS::PULL_REQUEST; 
@@ -314,14 +480,16 @@ std::vector<BlsType> ExecutionUnit::sendPullState(std::vector<BlsType> typeList)
             pullStateHmm.info.device = deviceName; 
             pullStateHmm.info.task = this->Task.name; 
             pullStateHmm.info.controller = controllerName; 
-            pullStateHmm.isCursor = (this->Task.binded_devices.at(index).deviceKind == DeviceKind::CURSOR); 
+            pullStateHmm.isCursor = (device.deviceKind == DeviceKind::CURSOR); 
             this->sendMM.write(pullStateHmm); 
             i++; 
         }
 
         {
             std::unique_lock<std::mutex> lock(this->pullMutex);
-            this->pullCV.wait(lock, [this](){return this->pullCounter == 0;}); 
+            WorkStealingPool::blockOn([&](){
+                this->pullCV.wait(lock, [this](){return this->pullCounter == 0;}); 
+            }); 
         }
 
         this->pullPlacement.clear(); 
@@ -6,10 +6,14 @@
 #include "Scheduler.hpp"
 #include "bls_types.hpp"
 #include "TSM.hpp"
+#include "Executor.hpp"
+#include <atomic>
 #include <condition_variable>
 #include <unordered_map>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 #include <functional>
@@ -28,8 +32,14 @@ class ExecutionUnit
     std::vector<std::string> controllers;
     TSQ<EMStateMessage> EUcache;
     std::thread executionThread;
+    // Shared worker pool, null when the unit runs on its own thread
+    WorkStealingPool *executor = nullptr; 
+    // Set while an activation of this unit is queued or running on the pool
+    std::atomic<bool> scheduled = false; 
     bool stop = false;
     std::unordered_map<std::string, int> devicePositionMap; 
+    // Device positions of the fused member currently running (null when the VM sees every device)
+    const std::vector<uint16_t> *activePositions = nullptr; 
     DeviceScheduler& globalScheduler; 
     // Contains the states to be replaced whikle the device is waiting for write access
     TSM<DeviceID, HeapMasterMessage> replacementCache;
@@ -47,6 +57,14 @@ class ExecutionUnit
     std::vector<BlsType> pullStoreVector; 
     std::unordered_map<DeviceID, int> pullPlacement; 
 
+    // Program staged by a hot reload, swapped in before the next activation
+    struct PendingReload{
+        TaskDescriptor task; 
+        std::shared_ptr<const std::vector<char>> bytecode; 
+    }; 
+    std::mutex reloadMutex; 
+    std::optional<PendingReload> pendingReload; 
+
     ExecutionUnit(TaskDescriptor TaskData
                 , std::vector<std::string> devices
                 , std::vector<bool> isVtype
@@ -55,13 +73,34 @@ class ExecutionUnit
                 , size_t bytecodeOffset
                 , std::vector<char>& bytecode
                 , DeviceScheduler &devSchedule, 
-                asio::io_context &ctx);
+                asio::io_context &ctx
+                , WorkStealingPool *executor = nullptr);
     
 
     
     void running();
-    // Replaced cached states while devices are read from
-    void replaceCachedStates(std::unordered_map<DeviceID, HeapMasterMessage> &cachedHMMs); 
+    // Runs a single task activation
+    void execute(EMStateMessage &currentHMMs); 
+    // Sends a task status message (execution start or end) to the mailbox
+    void notifyMailbox(PROTOCOLS protocol); 
+    // Builds the VM arguments from the received states, falling back to the initial values
+    std::vector<BlsType> loadStates(std::unordered_map<DeviceID, HeapMasterMessage> &HMMs); 
+    // Runs the task (or each fused member) over the states and returns which of them were modified
+    std::vector<bool> runTask(std::vector<BlsType> &states); 
+    // Whether a run modified a state the task is allowed to send
+    bool writesOutDevice(const std::vector<bool> &modifiedStates); 
+    // Runs every member of a fused task in order and returns which states any of them modified
+    std::vector<bool> transformFused(std::vector<BlsType> &states); 
+    // Maps a device index seen by the VM to its position in the task's bound devices
+    size_t resolveDeviceIndex(size_t index); 
+    // Queues the unit on the pool if it is not already queued (pool mode only)
+    void schedule(); 
+    void runScheduled(); 
+    // Stages a recompiled program for this task (bindings must be unchanged)
+    void stageReload(TaskDescriptor task, std::shared_ptr<const std::vector<char>> bytecode); 
+    void applyPendingReload(); 
+    // Replaced cached states while devices are read from, returns whether any state was replaced
+    bool replaceCachedStates(std::unordered_map<DeviceID, HeapMasterMessage> &cachedHMMs); 
    
     // OS level Traps (should always be a ptr heap descriptor so fine to take as value)
     void sendPushState(std::vector<BlsType> pushStates);
@@ -81,11 +120,15 @@ class ExecutionManager
     ExecutionManager(std::vector<TaskDescriptor> TaskList
                    , TSQ<EMStateMessage> &readMM
                    , TSQ<HeapMasterMessage> &sendMM
-                   , std::vector<char>& bytecode);
+                   , std::vector<char>& bytecode
+                   , size_t executorWorkers = 0
+                   , bool leaseDevices = false);
 
     ExecutionUnit &assign(HeapMasterMessage DMM);
 
     void running();
+    // Swaps the program of a running task, taking effect at its next activation
+    void reloadTask(TaskDescriptor task, std::shared_ptr<const std::vector<char>> bytecode);
 
     TSQ<EMStateMessage> &readMM;
     TSQ<HeapMasterMessage> &sendMM;
@@ -93,5 +136,7 @@ class ExecutionManager
     std::vector<TaskDescriptor> TaskList;
     DeviceScheduler scheduler; 
     boost::asio::io_context eu_ctx; 
+    // Declared last so queued activations drain before the units are destroyed
+    std::unique_ptr<WorkStealingPool> executor; 
 };
 
@@ -1,19 +1,28 @@
 #include "MM.hpp"
 #include "Serialization.hpp"
+#include "LatencyTrace.hpp"
 #include "DynamicMessage.hpp"
 #include "TSQ.hpp"
 #include "bls_types.hpp"
+#include <atomic>
 #include <memory>
 #include <unordered_set>
 #include <variant>
 
 
 MasterMailbox::MasterMailbox(std::vector<TaskDescriptor> TaskList, TSQ<DynamicMasterMessage> &readNM, 
-    TSQ<HeapMasterMessage> &readEM, TSQ<DynamicMasterMessage> &sendNM, TSQ<EMStateMessage> &sendEM)
+    TSQ<HeapMasterMessage> &readEM, TSQ<DynamicMasterMessage> &sendNM, TSQ<EMStateMessage> &sendEM, size_t shardCount)
 : readNM(readNM), readEM(readEM), sendEM(sendEM), sendNM(sendNM),  ConfContainer(sendNM ,TaskList)
 {
     this->TaskList = TaskList;
     std::unordered_set<std::string> emplaced_set; 
+
+    if(shardCount > 1){
+        this->shardPool = std::make_unique<boost::asio::thread_pool>(shardCount); 
+        for(auto &task : this->TaskList){
+            this->taskStrands.emplace(task.name, boost::asio::make_strand(*this->shardPool)); 
+        }
+    }
     
 
     // Creating the read line
@@ -88,20 +97,82 @@ DynamicMasterMessage MasterMailbox::buildDMM(HeapMasterMessage &hmm){
     return dmm;
 }
 
-ReaderBox::ReaderBox(std::string name, TaskDescriptor& taskDesc, std::unordered_set<TaskID> &triggerSet, TSQ<EMStateMessage> &ems)
+MasterMailbox::~MasterMailbox(){
+    if(this->shardPool){
+        this->shardPool->join(); 
+    }
+}
+
+ReaderBox::ReaderBox(std::string name, TaskDescriptor& taskDesc, TriggerGroup &triggerSet, TSQ<EMStateMessage> &ems)
 : triggerSet(triggerSet), triggerMan(taskDesc), sendEM(ems)
 {
     this->TaskName = name;
     this->taskDesc = taskDesc; 
+    this->coalescePolicy = taskDesc.coalescePolicy; 
+    this->coalesceDepth = taskDesc.coalesceDepth; 
 
     for(auto& desc : taskDesc.binded_devices){
         this->devDesc.emplace(desc.device_name, desc); 
     }
 }
 
+void MasterMailbox::reloadTask(TaskDescriptor& task){
+    this->taskReadMap.at(task.name)->reloadTriggers(task); 
+}
+
+
+void MasterMailbox::dispatchStates(std::vector<std::pair<TaskID, HeapMasterMessage>> &states){
+    if(!this->shardPool){
+        for(auto& [taskName, hmm] : states){
+            this->taskReadMap.at(taskName)->insertState(hmm); 
+        }
+        for(auto& [taskName, _] : states){
+            this->taskReadMap.at(taskName)->handleRequest(); 
+        }
+        return; 
+    }
+
+    if(states.size() == 1){
+        auto& [taskName, hmm] = states.front(); 
+        ReaderBox* reader = this->taskReadMap.at(taskName).get(); 
+        boost::asio::post(this->taskStrands.at(taskName), [reader, hmm = std::move(hmm)](){
+            reader->insertState(hmm); 
+            reader->handleRequest(); 
+        }); 
+        return; 
+    }
+
+    // Every task of the fan-out must join the trigger group before any of them requests ownership, 
+    // the strand that inserts last posts the requests so the calling thread never waits on the shards
+    struct FanOut{
+        std::atomic<size_t> pending; 
+        std::vector<std::pair<ReaderBox*, TaskStrand*>> readers; 
+    }; 
+    auto fanOut = std::make_shared<FanOut>(); 
+    fanOut->pending = states.size(); 
+    for(auto& [taskName, _] : states){
+        fanOut->readers.emplace_back(this->taskReadMap.at(taskName).get(), &this->taskStrands.at(taskName)); 
+    }
+
+    for(size_t i = 0; i < states.size(); i++){
+        auto [reader, strand] = fanOut->readers[i]; 
+        boost::asio::post(*strand, [reader, fanOut, hmm = std::move(states[i].second)](){
+            reader->insertState(hmm); 
+            if(fanOut->pending.fetch_sub(1, std::memory_order_acq_rel) != 1){
+                return; 
+            }
+            for(auto [member, memberStrand] : fanOut->readers){
+                boost::asio::post(*memberStrand, [member](){
+                    member->handleRequest(); 
+                }); 
+            }
+        }); 
+    }
+}
 
 void MasterMailbox::assignNM(DynamicMasterMessage DMM)
 {
+    LatencyTracer::instance().record(DMM.info.trace, TraceStage::MAILBOX_QUEUE); 
 
     switch(DMM.protocol)
     {   
@@ -110,6 +181,7 @@ void MasterMailbox::assignNM(DynamicMasterMessage DMM)
             DeviceID devName = DMM.info.device; 
 
 
+        std::vector<std::pair<TaskID, HeapMasterMessage>> states; 
         if(!DMM.isCursor){
             // For now we count callbacks to update the state in the mailbox (CHECK IF CALLBACK DEV IN READ LIST)
             for(auto &taskName : this->interruptName_map[devName]){
@@ -119,18 +191,14 @@ void MasterMailbox::assignNM(DynamicMasterMessage DMM)
                     hmm.protocol = PROTOCOLS::CALLBACKRECIEVED; 
                     hmm.info = DMM.info; 
                     hmm.heapTree = DMM.DM.toTree(); 
-                    this->taskReadMap[taskName]->insertState(hmm); 
+                    states.emplace_back(taskName, hmm); 
                 }
             }
-            for(auto& taskName : this->interruptName_map[devName]){
-                this->taskReadMap[taskName]->handleRequest(); 
-            } 
         }
         else{
-            auto& readMap = this->taskReadMap.at(DMM.info.task); 
-            readMap->insertState(DMM); 
-            readMap->handleRequest(); 
+            states.emplace_back(DMM.info.task, HeapMasterMessage(DMM)); 
         }  
+        this->dispatchStates(states); 
 
         if(DMM.isCursor){
             devName = devName + "::" + DMM.info.task; 
@@ -141,31 +209,21 @@ void MasterMailbox::assignNM(DynamicMasterMessage DMM)
         }
         case PROTOCOLS::SENDSTATES:
         {
+            std::vector<std::pair<TaskID, HeapMasterMessage>> states; 
             if(DMM.isInterrupt){
                 std::vector<TaskID> taskList = this->interruptName_map[DMM.info.device];
                 for(auto& taskId : taskList){
                     if(!this->taskReadMap.contains(taskId)){break;}
-                    auto& targReadBox = this->taskReadMap[taskId]; 
                     DMM.info.task = taskId; 
-
-                    HeapMasterMessage newHMM(DMM); 
-                    targReadBox->insertState(newHMM); 
+                    states.emplace_back(taskId, HeapMasterMessage(DMM)); 
                 } 
-                //std::cout<<"Tasks Triggered: "<<this->triggerSet.size()<<std::endl; 
-
-                for(auto& taskId : taskList){
-                    if(!this->taskReadMap.contains(taskId)){break;}
-                    auto& targReadBox = this->taskReadMap[taskId]; 
-                    targReadBox->handleRequest(); 
-                }
             }
             else{
                 TaskID targId = DMM.info.task; 
                 if(!this->taskReadMap.contains(targId)){break;}
-                auto& rBox = this->taskReadMap.at(targId); 
-                rBox->insertState(DMM);
-                rBox->handleRequest(); 
+                states.emplace_back(targId, HeapMasterMessage(DMM)); 
             }
+            this->dispatchStates(states); 
          
             break;
         }
@@ -205,6 +263,7 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
     {
         case PROTOCOLS::REQUESTINGSTATES:
         {
+            std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
             correspondingReaderBox.pending_requests = true; 
             break; 
         }
@@ -221,18 +280,13 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
                 }
 
                 std::vector<TaskID> taskList = this->interruptName_map.at(DMM.info.device); 
+                std::vector<std::pair<TaskID, HeapMasterMessage>> states; 
                 for(auto &name : taskList){
                     if(!this->taskReadMap.contains(name)){break;}
                     DMM.protocol = PROTOCOLS::CALLBACKRECIEVED; 
-                    std::unique_ptr<ReaderBox>& reader = this->taskReadMap[name]; 
-                    reader->insertState(DMM); 
+                    states.emplace_back(name, DMM); 
                 }   
-           
-                for(auto& name : taskList){
-                    if(!this->taskReadMap.contains(name)){break;}
-                    std::unique_ptr<ReaderBox>& reader = this->taskReadMap[name]; 
-                    reader->handleRequest();
-                }
+                this->dispatchStates(states); 
               
                 break; 
             }
@@ -242,6 +296,7 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
             }
 
             WriterBox &assignedBox = *deviceWriteMap.at(dev);
+            LatencyTracer::instance().record(DMM.info.trace, TraceStage::WRITER_QUEUE); 
             auto owPolicy = taskReadMap.at(DMM.info.task)->waitingQs.at(DMM.info.device).overwritePolicy;
 
             assignedBox.writeOut(DMM, owPolicy, PROTOCOLS::SENDSTATES); 
@@ -250,7 +305,13 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
         case PROTOCOLS::OWNER_CANDIDATE_REQUEST:{   
             auto taskName = DMM.info.task; 
             //std::cout<<"Mailbox Ownership request for the device: "<<DMM.info.device<<" from task "<<taskName<<std::endl; 
-            this->taskReadMap[taskName]->forwardPackets = true; 
+            {
+                // The shard strands read the box flags in insertState
+                std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+                correspondingReaderBox.forwardPackets = true; 
+                // A deferred task requests straight from its first run, which left the box in execution
+                correspondingReaderBox.inExec = false; 
+            }
             this->targetedDevices.insert(DMM.info.device); 
 
             if(this->vTypesSchedule.contains(DMM.info.device)){
@@ -268,11 +329,7 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
         case PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE:{
         
             auto taskName = DMM.info.task; 
-            if(this->triggerSet.contains(taskName)){
-                this->triggerSet.erase(taskName); 
-            }
-
-            if(triggerSet.empty()){
+            if(this->triggerSet.conclude(taskName)){
                 for(auto& dev : targetedDevices){
                     if(this->vTypesSchedule.contains(dev)){
                         auto& schedule = this->vTypesSchedule.at(dev);
@@ -302,7 +359,6 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
                         this->sendNM.write(dmm); 
                     }
                 }
-                this->triggerSet.clear(); 
                 this->targetedDevices.clear();
             }
 
@@ -340,14 +396,29 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
             this->ConfContainer.send(MasterMailbox::buildDMM(DMM));
             break; 
         }
+        case PROTOCOLS::OWNER_LEASE:{
+            // Leased devices stay owned by their sole writer for the lifetime of the program
+            if(this->vTypesSchedule.contains(DMM.info.device)){
+                auto& schedule = this->vTypesSchedule.at(DMM.info.device); 
+                schedule.owner = DMM.info.task; 
+                schedule.isOwned = true; 
+                break; 
+            }
+
+            this->sendNM.write(MasterMailbox::buildDMM(DMM)); 
+            break; 
+        }
         case PROTOCOLS::OWNER_RELEASE_NULL:{
-            auto taskName = DMM.info.task; 
-            this->taskReadMap.at(DMM.info.task)->inExec = false; 
+            std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+            correspondingReaderBox.inExec = false; 
             break; 
         }
         case PROTOCOLS::OWNER_RELEASE:{
             auto taskName = DMM.info.task; 
-            this->taskReadMap.at(DMM.info.task)->inExec = false; 
+            {
+                std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+                correspondingReaderBox.inExec = false; 
+            }
 
             if(this->vTypesSchedule.contains(DMM.info.device)){
                 auto& scheduler = this->vTypesSchedule.at(DMM.info.device); 
@@ -379,21 +450,21 @@ void MasterMailbox::assignEM(HeapMasterMessage DMM)
             break; 
         }
         case PROTOCOLS::PROCESS_EXEC :{
-            auto taskName = DMM.info.task;
-            this->taskReadMap[taskName]->forwardPackets = false;
-            this->taskReadMap.at(taskName)->inExec = true;
+            std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+            correspondingReaderBox.forwardPackets = false;
+            correspondingReaderBox.inExec = true;
             break;
         }
         case PROTOCOLS::DISABLE_TRIGGER : {
-            auto taskName = DMM.info.task;
             //std::cout<<"Disabling trigger: "<<DMM.info.device<<" for task "<<DMM.info.task<<std::endl; 
-            this->taskReadMap.at(taskName)->triggerMan.disableTrigger(DMM.info.device);
+            std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+            correspondingReaderBox.triggerMan.disableTrigger(DMM.info.device);
             break;
         }
         case PROTOCOLS::ENABLE_TRIGGER : {
-            auto taskName = DMM.info.task; 
             //std::cout<<"Disabling trigger: "<<DMM.info.device<<" for task "<<DMM.info.task<<std::endl; 
-            this->taskReadMap.at(taskName)->triggerMan.enableTrigger(DMM.info.device);
+            std::lock_guard<std::mutex> lock(correspondingReaderBox.read_mut); 
+            correspondingReaderBox.triggerMan.enableTrigger(DMM.info.device);
             break; 
         }
         case PROTOCOLS::PULL_REQUEST : {
@@ -2,7 +2,13 @@
 
 #include "Serialization.hpp"
 #include "TSQ.hpp"
-#include <bitset>
+#include "TriggerManager.hpp"
+#include "LatencyTrace.hpp"
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <deque>
+#include <iostream>
 #include <mutex>
 #include <stdexcept>
 #include <unordered_map>
@@ -17,7 +23,6 @@ using TaskID = std::string;
 using DeviceID = std::string; 
 
 # define MAX_EM_QUEUE_FILL 10 
-#define BITSET_SZ 32
  
 /*
     Contains a single dmsg (without needing the )
@@ -45,121 +50,29 @@ struct AtomicDMMContainer{
         }
 }; 
 
-class TriggerManager{
-    private:   
-        std::bitset<BITSET_SZ> currentBitmap;  
-        std::bitset<BITSET_SZ> initBitmap; 
-        std::unordered_map<std::string, int> stringMap; 
-        std::vector<std::bitset<BITSET_SZ>> ruleset; 
-        std::vector<TriggerData> trigData; 
-        std::bitset<BITSET_SZ> defaultBitstring; 
-        std::unordered_set<int> excludedTriggers; 
-        // Maps trigger indices to integers
-        std::unordered_map<std::string, int> triggerIndexMap; 
+/*
+    Tasks triggered by the current round of events, shared by all reader boxes
+    (used to ensure intended-order execution for trigger groups)
+*/
+class TriggerGroup{
+    private: 
+        std::unordered_set<TaskID> tasks; 
+        std::mutex mut; 
 
-    
     public: 
-        // Device Constructor (created rules)
-        TriggerManager(TaskDescriptor& TaskDesc){
-            int i = 0; 
-            for(DeviceDescriptor& devDesc : TaskDesc.binded_devices){
-                stringMap[devDesc.device_name] = i; 
-                i++; 
-            }
-
-            // Add the default universal bitset (all 1s): 
-            defaultBitstring = (1 << (i)) - 1; 
-            this->trigData = TaskDesc.triggers; 
-            i = 0;
-            // Loop through rules; 
-            for(auto& data : TaskDesc.triggers)
-            {
-                auto& rule = data.rule;
-                std::bitset<BITSET_SZ> king; 
-                for(auto& devName : rule){
-                    king.set(this->stringMap[devName]); 
-                }       
-                this->triggerIndexMap[data.id] = i; 
-                ruleset.push_back(king); 
-                i++; 
-            }
+        void insert(const TaskID& task){
+            std::lock_guard<std::mutex> lock(this->mut); 
+            this->tasks.insert(task); 
         }
 
-        private: 
-            // Tests bit against ruleset and grab the trigger rule with highest priority: 
-            bool testBit(int& id){
-                int i = 0; 
-                int max_priority = -1; 
-                for(auto& ruleBit : this->ruleset){
-                    if(excludedTriggers.contains(i)){
-                        continue;
-                    }
-
-                    if((this->currentBitmap & ruleBit) == ruleBit){
-                        if(this->trigData[i].priority > max_priority){
-                            max_priority = this->trigData[i].priority;
-                            id = i; 
-                        }
-                    }
-                    i++; 
-                }
-
-                if(max_priority > 0 || (this->currentBitmap & this->defaultBitstring) == this->defaultBitstring){
-                    return true; 
-                }
-
-                // Check if the reultBit is the default (all devices)
-                return false;  
-            }
-        public: 
-            // Returns true if the new device corresponds to a trigger 
-            bool processDevice(std::string &object, int& trigger_id){
-                int filledMap = pow(2, stringMap.size()) - 1; 
-                if(this->initBitmap.to_ulong() != filledMap){
-                    this->initBitmap.set(this->stringMap[object]);
-                    // force a trigger when the map is init bitmap is filled
-                    if(this->initBitmap.to_ulong() == filledMap){
-                        // Code for initial trigger
-                        trigger_id = -1; 
-                        return true; 
-                    } 
-                    return false; 
-                }
-                
-                this->currentBitmap.set(this->stringMap[object]);         
-                bool found = this->testBit(trigger_id); 
-                if(found){
-                    this->currentBitmap.reset(); 
-    
-                    return true; 
-                }
-                return false; 
-            }
-
-            void debugPrintRules(){
-                for(auto& rule : this->ruleset){
-                    std::cout<<rule<<std::endl; 
-                }
-            }
-
-            void debugCurrentString(){
-                std::cout<<this->currentBitmap<<std::endl; 
-            }
-
-            void disableTrigger(std::string &triggerName){
-                int index = this->triggerIndexMap.at(triggerName); 
-                this->excludedTriggers.insert(index); 
-            }
-
-            void enableTrigger(std::string &triggerName){
-                int index = this->triggerIndexMap.at(triggerName);
-                if(this->excludedTriggers.contains(index)){
-                    this->excludedTriggers.erase(index);
-                }
-            }
+        // Removes the task from the group and returns true if no triggered tasks remain
+        bool conclude(const TaskID& task){
+            std::lock_guard<std::mutex> lock(this->mut); 
+            this->tasks.erase(task); 
+            return this->tasks.empty(); 
+        }
 }; 
 
-
 struct DeviceBox{
     std::shared_ptr<TSQ<HeapMasterMessage>> stateQueues;
     AtomicDMMContainer lastMessage; 
@@ -181,8 +94,14 @@ struct ReaderBox
             Consists of the ordered list of all triggered events 
             to be queued up and sent to the execution manager
         */ 
-        std::vector<EMStateMessage> triggerCache; 
-        std::unordered_set<TaskID>& triggerSet; 
+        std::deque<EMStateMessage> triggerCache; 
+        // Governs how triggerCache behaves when the task falls behind its triggers
+        COALESCE_POLICY coalescePolicy = COALESCE_POLICY::NONE; 
+        size_t coalesceDepth = 0; 
+        // Events discarded by a bounded policy and events replaced by a newer one (also counted in the --trace report)
+        size_t droppedEvents = 0; 
+        size_t coalescedEvents = 0; 
+        TriggerGroup& triggerSet; 
         TriggerManager triggerMan; 
 
         bool callbackRecived;
@@ -202,6 +121,7 @@ struct ReaderBox
         // the bool initEvent determines if the event is an initial event or not
         void insertState(HeapMasterMessage newDMM){
             std::lock_guard<std::mutex> lock(this->read_mut); 
+            LatencyTracer::instance().record(newDMM.info.trace, TraceStage::READER_BOX); 
 
             if(!this->waitingQs.contains(newDMM.info.device)){
                 return; 
@@ -240,10 +160,6 @@ struct ReaderBox
             bool writeTrig = this->triggerMan.processDevice(newDMM.info.device, triggerId); 
     
             if(writeTrig){
-                if(!this->forwardPackets){
-                    this->triggerSet.insert(this->TaskName); 
-                }
-               
                 std::string triggerName = "";
                 uint16_t priority = 1;
                 if (triggerId > -2) {
@@ -288,10 +204,49 @@ struct ReaderBox
                 ems.taskName = this->TaskName; 
                 ems.protocol = PROTOCOLS::SENDSTATES; 
             
-                this->triggerCache.push_back(ems); 
+                // A discarded event does not schedule the task
+                if(this->enqueueTrigger(ems) && !this->forwardPackets){
+                    this->triggerSet.insert(this->TaskName); 
+                }
             }
         }
 
+        // Applies the coalescing policy to a new trigger event and returns false when it was discarded (read_mut must be held)
+        bool enqueueTrigger(EMStateMessage &ems){
+            auto& tracer = LatencyTracer::instance(); 
+            switch(this->coalescePolicy){
+                case COALESCE_POLICY::LATEST:{
+                    if(!this->triggerCache.empty()){
+                        this->coalescedEvents += this->triggerCache.size(); 
+                        tracer.count(TraceCounter::COALESCED_EVENTS, this->triggerCache.size()); 
+                        this->triggerCache.clear(); 
+                    }
+                    break; 
+                }
+                case COALESCE_POLICY::FIFO:{
+                    if(this->triggerCache.size() >= this->coalesceDepth){
+                        this->droppedEvents++; 
+                        tracer.count(TraceCounter::DROPPED_EVENTS); 
+                        return false; 
+                    }
+                    break; 
+                }
+                case COALESCE_POLICY::DROP_OLDEST:{
+                    while(this->triggerCache.size() >= this->coalesceDepth && !this->triggerCache.empty()){
+                        this->triggerCache.pop_front(); 
+                        this->droppedEvents++; 
+                        tracer.count(TraceCounter::DROPPED_EVENTS); 
+                    }
+                    break; 
+                }
+                default:{
+                    break; 
+                }
+            }
+            this->triggerCache.push_back(ems); 
+            return true; 
+        }
+
         void handleRequest(){
             std::lock_guard<std::mutex> lock(this->read_mut); 
 
@@ -301,8 +256,16 @@ struct ReaderBox
                 for(int i = 0; i < maxQueueSz; i++){
                     // Update when trigger naming comes 
                     if(!triggerCache.empty()){
-                        auto ems = this->triggerCache.back(); 
-                        this->triggerCache.pop_back(); 
+                        // Coalesced queues are forwarded oldest first, the unbounded cache keeps its LIFO order
+                        EMStateMessage ems; 
+                        if(this->coalescePolicy == COALESCE_POLICY::NONE){
+                            ems = this->triggerCache.back(); 
+                            this->triggerCache.pop_back(); 
+                        }
+                        else{
+                            ems = this->triggerCache.front(); 
+                            this->triggerCache.pop_front(); 
+                        }
                         sendEM.write(ems); 
                     }
                     else{
@@ -313,7 +276,20 @@ struct ReaderBox
         }   
 
 
-        ReaderBox(std::string name,  TaskDescriptor& taskDesc, std::unordered_set<TaskID> &trigSet, TSQ<EMStateMessage> &emMsg);
+        // Replaces the trigger rules and coalescing policy while keeping the queued device states
+        void reloadTriggers(TaskDescriptor& newDesc){
+            std::lock_guard<std::mutex> lock(this->read_mut); 
+            bool initialized = this->triggerMan.isInitialized(); 
+            this->triggerMan = TriggerManager(newDesc); 
+            if(initialized){
+                this->triggerMan.markInitialized(); 
+            }
+            this->taskDesc = newDesc; 
+            this->coalescePolicy = newDesc.coalescePolicy; 
+            this->coalesceDepth = newDesc.coalesceDepth; 
+        }
+
+        ReaderBox(std::string name,  TaskDescriptor& taskDesc, TriggerGroup &trigSet, TSQ<EMStateMessage> &emMsg);
     
 };
 
@@ -578,18 +554,22 @@ struct WriterBox
 class MasterMailbox
 {
     public:
+    using TaskStrand = boost::asio::strand<boost::asio::thread_pool::executor_type>; 
+
     TSQ<DynamicMasterMessage> &readNM;
     TSQ<HeapMasterMessage> &readEM;
     TSQ<EMStateMessage> &sendEM;
     TSQ<DynamicMasterMessage> &sendNM;
+    // A shard count above 1 processes reader boxes on that many worker threads (serialized per task)
     MasterMailbox(std::vector<TaskDescriptor> TaskList, TSQ<DynamicMasterMessage> &readNM, TSQ<HeapMasterMessage> &readEM,
-         TSQ<DynamicMasterMessage> &sendNM, TSQ<EMStateMessage> &sendEM);
+         TSQ<DynamicMasterMessage> &sendNM, TSQ<EMStateMessage> &sendEM, size_t shardCount = 1);
+    ~MasterMailbox(); 
     std::vector<TaskDescriptor> TaskList;
     std::unordered_map<DeviceID, ControllerID> parentCont; 
     static DynamicMasterMessage buildDMM(HeapMasterMessage &hmm); 
     
     // List of tasks that were triggered (used to ensure intended-order execution for trigger groups)
-    std::unordered_set<TaskID> triggerSet; 
+    TriggerGroup triggerSet; 
     std::unordered_set<DeviceID> targetedDevices; 
 
     // number of found requests 
@@ -601,12 +581,21 @@ class MasterMailbox
     std::unordered_map<DeviceID, ManagedVType> vTypesSchedule; 
     ConfirmContainer ConfContainer; 
 
+    // Sharded mode workers
+    std::unique_ptr<boost::asio::thread_pool> shardPool; 
+    std::unordered_map<TaskID, TaskStrand> taskStrands; 
+
 
     TSQ<std::string> readRequest; 
 
     // Helper functions for sending items; 
     void notifyCallback(); 
     void notifyEmptyQueue();
+    // Inserts each state into its task's reader box, then lets every reader box handle pending requests
+    void dispatchStates(std::vector<std::pair<TaskID, HeapMasterMessage>> &states); 
+
+    // Applies edited trigger rules of a running task (bindings must be unchanged)
+    void reloadTask(TaskDescriptor& task); 
 
     void assignNM(DynamicMasterMessage DMM);
     void assignEM(HeapMasterMessage DMM);
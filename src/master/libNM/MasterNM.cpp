@@ -1,11 +1,13 @@
 #include "MasterNM.hpp"
 #include "Serialization.hpp"
+#include "LatencyTrace.hpp"
 #include "DynamicMessage.hpp"
 #include "Protocol.hpp"
 #include <algorithm>
 #include <exception>
 #include <set>
 #include <stdexcept>
+#include <unordered_set>
 
 
 MasterNM::MasterNM(std::vector<TaskDescriptor> &desc_list, TSQ<DMM> &in_msg, TSQ<DMM> &out_q)
@@ -44,6 +46,8 @@ void MasterNM::writeConfig(std::vector<TaskDescriptor> &desc_list){
     std::set<std::string> c_list; 
     std::set<std::string> dev_list; 
 
+    this->task_descs = desc_list; 
+
     int i = 0; 
     for(auto &task : desc_list){
         this->task_list.push_back(task.name); 
@@ -98,6 +102,7 @@ bool MasterNM::start(){
         this->ctx_thread = std::thread([this](){this->master_ctx.run();}); 
         // This is bad (its wasting a lot of CPU cycles)
         this->updateThread = std::thread([this](){this->update();});
+        this->tickerThread = std::jthread([this](std::stop_token stoken){this->updateTicker(stoken);}); 
      
         if(this->bcast_thread.joinable()){
             this->bcast_thread.join(); 
@@ -130,6 +135,11 @@ void MasterNM::stop(){
         this->updateThread.join(); 
     }
 
+    this->tickerThread.request_stop(); 
+    if(this->tickerThread.joinable()){
+        this->tickerThread.join(); 
+    }
+
     std::cout<<"Server has closed"<<std::endl; 
 }
 
@@ -233,7 +243,6 @@ void MasterNM::masterRead(){
             throw std::runtime_error("Failed to find the physical information for a specified task");
         }
 
-        bool nonStateChange = true;
 
 
         // Add other communication MASERT_PROTOCOLS
@@ -258,6 +267,12 @@ void MasterNM::masterRead(){
                 sm_main.header.prot = Protocol::OWNER_CANDIDATE_REQUEST_CONCLUDE; 
                 break; 
             }
+            case PROTOCOLS::OWNER_LEASE : {
+                sm_main.header.prot = Protocol::OWNER_LEASE; 
+                std::scoped_lock lk(this->lease_mutex); 
+                this->controller_leases[cont].push_back(sm_main); 
+                break; 
+            }
             case PROTOCOLS::PULL_REQUEST:{
                 //std::cout<<"Sending out pull request for task "<<new_state.info.task<<" for device: "<<new_state.info.device<<std::endl;
                 sm_main.header.prot = Protocol::PULL_REQUEST; 
@@ -265,9 +280,10 @@ void MasterNM::masterRead(){
             }
             default : {
                 sm_main.header.prot = Protocol::STATE_CHANGE;
-                nonStateChange = false; 
                 sm_main.body = new_state.DM.Serialize(); 
                 sm_main.header.body_size = sm_main.body.size(); 
+                LatencyTracer::instance().record(new_state.info.trace, TraceStage::WRITER_BOX); 
+                sm_main.header.trace = new_state.info.trace; 
             }
         }
    
@@ -275,31 +291,27 @@ void MasterNM::masterRead(){
         sm_main.header.task_priority = new_state.info.priority; 
     
         messageClient(cont, sm_main); 
+    }
+}
 
-        if(nonStateChange){
-            continue; 
-        }
-        
-        // Send the Ticker Update Message (idk maybe)
-
-        std::vector<Timer> timer_list; 
-        this->tickerTable.sendTicker(timer_list, cont, this->device_alias_map);
-        if(!timer_list.empty()){
+// Sends the dynamic periods of the controller that changed since the last update
+void MasterNM::sendTickerUpdate(std::string &controller){
+    std::vector<Timer> timer_list; 
+    this->tickerTable.sendTicker(timer_list, controller, this->device_alias_map);
+    if(!timer_list.empty()){
 
-            SentMessage sm_update; 
-            DynamicMessage dmsg; 
+        SentMessage sm_update; 
+        DynamicMessage dmsg; 
 
-            dmsg.createField("__TICKER_UPDATE__", timer_list); 
-            sm_update.body = dmsg.Serialize(); 
+        dmsg.createField("__TICKER_UPDATE__", timer_list); 
+        sm_update.body = dmsg.Serialize(); 
 
-            sm_update.header.ctl_code = this->controller_alias_map[new_state.info.controller]; 
-            sm_update.header.device_code = this->device_alias_map[new_state.info.device]; 
-            sm_update.header.prot = Protocol::TICKER_UPDATE; 
-            sm_update.header.body_size = sm_update.body.size(); 
-            
-            messageClient(cont, sm_update); 
-        }
+        sm_update.header.ctl_code = this->controller_alias_map[controller]; 
+        sm_update.header.device_code = 0; 
+        sm_update.header.prot = Protocol::TICKER_UPDATE; 
+        sm_update.header.body_size = sm_update.body.size(); 
         
+        messageClient(controller, sm_update); 
     }
 }
 
@@ -310,6 +322,33 @@ void MasterNM::update(){
     }
 }
 
+// Applies the polled states to the ticker and sends the periods that changed
+void MasterNM::updateTicker(std::stop_token stoken){
+    while(auto sample = this->ticker_queue.read(stoken)){
+        // A backlog of states is applied before any controller is updated
+        std::unordered_set<std::string> controllers; 
+        do{
+            if(!sample->device.empty()){
+                if(sample->dmsg.hasField("__DEV_ATTR_VOLATILITY__")){
+                    std::unordered_map<AttrAlias, float> vol_map; 
+                    sample->dmsg.unpack("__DEV_ATTR_VOLATILITY__", vol_map); 
+                    this->tickerTable.updateVolH(sample->device, vol_map); 
+                }
+
+                // Poll faster while the state is close to a condition of the tasks
+                std::unordered_map<AttrAlias, double> values; 
+                sample->dmsg.getNumericFields(values); 
+                this->tickerTable.updateConditions(sample->device, values); 
+            }
+            controllers.insert(sample->controller); 
+        } while((sample = this->ticker_queue.pop())); 
+
+        for(auto controller : controllers){
+            this->sendTickerUpdate(controller); 
+        }
+    }
+}
+
 
 void MasterNM::handleMessage(OwnedSentMessage &in_msg){
     DynamicMessage dmsg; 
@@ -364,6 +403,8 @@ void MasterNM::handleMessage(OwnedSentMessage &in_msg){
 
 
                 bool interrupt = in_msg.sm.header.fromInterrupt; 
+                auto trace = in_msg.sm.header.trace; 
+                LatencyTracer::instance().record(trace, TraceStage::NETWORK_TO_MASTER); 
 
                 // insert the volatility into the ticker_table: 
                 if(!interrupt){
@@ -371,12 +412,8 @@ void MasterNM::handleMessage(OwnedSentMessage &in_msg){
                     // Get the block from the timer_id
                     auto task_list = this->tickerTable.getTasks(id); 
 
-                    std::unordered_map<AttrAlias, float> vol_map; 
-
-                    if(dmsg.hasField("__DEV_ATTR_VOLATILITY__")){
-                        dmsg.unpack("__DEV_ATTR_VOLATILITY__", vol_map); 
-                        this->tickerTable.updateVolH(device_name, vol_map); 
-                    }
+                    // The ticker thread adapts the polling rate to the state
+                    this->ticker_queue.write({this->controller_list[in_msg.sm.header.ctl_code], device_name, dmsg}); 
 
                     //std::cout<<"Not Interrupt?"<<std::endl; 
                     for(auto &o_name : task_list){
@@ -387,6 +424,7 @@ void MasterNM::handleMessage(OwnedSentMessage &in_msg){
                         new_msg.DM = dmsg; 
                         new_msg.isInterrupt = false; 
                         new_msg.protocol = PROTOCOLS::SENDSTATES; 
+                        new_msg.info.trace = trace; 
                         //std::cout<<"Write to queue"<<std::endl; 
                         
                         this->EMM_out_queue.write(new_msg); 
@@ -401,6 +439,7 @@ void MasterNM::handleMessage(OwnedSentMessage &in_msg){
                     new_msg.DM = dmsg; 
                     new_msg.isInterrupt = true;
                     new_msg.protocol = PROTOCOLS::SENDSTATES;
+                    new_msg.info.trace = trace; 
                     //std::cout<<"Write to queue"<<std::endl; 
 
                     this->EMM_out_queue.write(new_msg); 
@@ -459,6 +498,83 @@ DynamicMasterMessage MasterNM::makeDMM(SentMessage &in_msg, PROTOCOLS pcode){
 
 
 // Creates the config message and send it to the client (assuming the target is found)
+void MasterNM::setControllerPrograms(std::unordered_map<std::string, std::vector<TaskDescriptor>> &tasks, std::unordered_map<std::string, std::vector<char>> &programs){
+    this->controller_tasks = tasks; 
+    this->controller_bytecode = programs; 
+}
+
+void MasterNM::sendProgram(std::shared_ptr<Connection> &client_con){
+    std::string c_name = client_con->getName(); 
+    if(!this->controller_tasks.contains(c_name)){
+        return; 
+    }
+    auto& localTasks = this->controller_tasks.at(c_name); 
+
+    std::vector<uint16_t> task_ids; 
+    std::set<std::string> local_names; 
+    for(auto& task : localTasks){
+        task_ids.push_back(this->task_alias_map.at(task.name)); 
+        local_names.insert(task.name); 
+    }
+
+    // Devices of this controller that tasks on the master still read
+    std::set<uint16_t> master_devices; 
+    std::vector<std::string> dev_names; 
+    std::vector<uint16_t> dev_codes; 
+    for(auto& task : this->task_descs){
+        for(auto& dev : task.binded_devices){
+            if(dev.controller != c_name){
+                continue; 
+            }
+            auto dev_code = this->device_alias_map.at(dev.device_name); 
+            if(std::ranges::find(dev_codes, dev_code) == dev_codes.end()){
+                dev_names.push_back(dev.device_name); 
+                dev_codes.push_back(dev_code); 
+            }
+            if(!local_names.contains(task.name)){
+                master_devices.insert(dev_code); 
+            }
+        }
+    }
+
+    std::string task_json = boost::json::serialize(boost::json::value_from(localTasks)); 
+    auto& program = this->controller_bytecode.at(c_name); 
+    std::string bytecode(program.begin(), program.end()); 
+
+    DynamicMessage dmsg; 
+    dmsg.createField("__TASK_DESCS__", task_json); 
+    dmsg.createField("__TASK_IDS__", task_ids); 
+    dmsg.createField("__BYTECODE__", bytecode); 
+    dmsg.createField("__DEV_NAMES__", dev_names); 
+    dmsg.createField("__DEV_CODES__", dev_codes); 
+    // Empty vectors cannot be packed, so a missing field means every state stays on the controller
+    if(!master_devices.empty()){
+        std::vector<uint16_t> master_list(master_devices.begin(), master_devices.end()); 
+        dmsg.createField("__MASTER_DEVICES__", master_list); 
+    }
+
+    SentMessage sm; 
+    sm.header.prot = Protocol::LOAD_PROGRAM; 
+    sm.header.ctl_code = this->controller_alias_map[c_name]; 
+    sm.header.device_code = 0; 
+    sm.body = dmsg.Serialize(); 
+    sm.header.body_size = sm.body.size(); 
+
+    std::cout<<"Loading "<<localTasks.size()<<" tasks onto "<<c_name<<std::endl; 
+    client_con->send(sm); 
+}
+
+void MasterNM::sendLeases(std::shared_ptr<Connection> &client_con){
+    std::scoped_lock lk(this->lease_mutex); 
+    auto leases = this->controller_leases.find(client_con->getName()); 
+    if(leases == this->controller_leases.end()){
+        return; 
+    }
+    for(auto& sm : leases->second){
+        client_con->send(sm); 
+    }
+}
+
 bool MasterNM::confirmClient(std::shared_ptr<Connection> &con_obj){
     std::string c_name = con_obj->getName();
     SentMessage dev_sm; 
@@ -483,12 +599,26 @@ bool MasterNM::confirmClient(std::shared_ptr<Connection> &con_obj){
 
     con_obj->send(dev_sm); 
 
+    // Local tasks are loaded once the devices they run on are configured
+    this->sendProgram(con_obj); 
+
+    // A reconnected client starts without the leases of its devices
+    this->sendLeases(con_obj); 
+
 
 
     return true; 
 }
 
 // Makes the beginning call
+void MasterNM::reloadConditions(std::vector<TaskDescriptor> &descs){
+    this->tickerTable.setConditions(descs); 
+    // Sends the timers the reloaded tasks added
+    for(auto &controller : this->controller_list){
+        this->ticker_queue.write({controller, "", {}}); 
+    }
+}
+
 void MasterNM::makeBeginCall(){
     std::cout<<"Beginning the Sending process!"<<std::endl; 
     // send out client start (might not need this due to the initialization of the sending process)
@@ -2,7 +2,10 @@
 #include "Connection.hpp"
 #include "Protocol.hpp"
 #include "Serialization.hpp"
+#include <mutex>
+#include <stop_token>
 #include <thread> 
+#include <unordered_map>
 #include "Ticker.hpp"
 
 
@@ -11,12 +14,25 @@ using boost::asio::ip::tcp;
 using boost::asio::ip::udp; 
 using DMM = DynamicMasterMessage; 
 
+// Polled state handed from the network thread to the ticker thread, 
+// samples without a device only send the pending timers of the controller
+struct TickerSample{
+    std::string controller; 
+    DevAlias device; 
+    DynamicMessage dmsg; 
+}; 
+
 
 class MasterNM{
     private: 
         std::vector<std::string> controller_list; 
         std::vector<std::string> device_list; 
         std::vector<std::string> task_list; 
+        std::vector<TaskDescriptor> task_descs; 
+
+        // Tasks run by the client execution managers and the program slice of each controller
+        std::unordered_map<std::string, std::vector<TaskDescriptor>> controller_tasks; 
+        std::unordered_map<std::string, std::vector<char>> controller_bytecode; 
 
         // Device descriptor info (mostly used for debugging maybe for other things): 
         std::unordered_map<std::string, DeviceDescriptor> dd_map; 
@@ -45,8 +61,14 @@ class MasterNM{
         std::thread bcast_thread; 
         TSQ<OwnedSentMessage> in_queue; 
 
-        // Ticker 
+        // Ticker, updated off the network thread from the polled states
         MTicker tickerTable; 
+        TSQ<TickerSample> ticker_queue; 
+        std::jthread tickerThread; 
+
+        // Leases granted per controller, sent again when the controller reconnects
+        std::mutex lease_mutex; 
+        std::unordered_map<std::string, std::vector<SentMessage>> controller_leases; 
 
         // Number of remaining processes to confirm
         int remConnections; 
@@ -80,16 +102,24 @@ class MasterNM{
         // Read in data and send it out; 
         void masterRead(); 
         void update(); 
+        void updateTicker(std::stop_token stoken); 
 
         // Transfer the items
         void sendInitialTicker(std::shared_ptr<Connection> &client_con); 
+        void sendTickerUpdate(std::string &controller); 
+        void sendProgram(std::shared_ptr<Connection> &client_con); 
+        void sendLeases(std::shared_ptr<Connection> &client_con); 
 
     public:     
         MasterNM(std::vector<TaskDescriptor> &descs, TSQ<DMM> &in_que, TSQ<DMM> &out_q); 
         ~MasterNM(); 
         bool start();
+        // Must be called before start so the tasks are sent when their controller connects
+        void setControllerPrograms(std::unordered_map<std::string, std::vector<TaskDescriptor>> &tasks, std::unordered_map<std::string, std::vector<char>> &programs); 
         void stop(); 
         void makeBeginCall();
+        // Replaces the polling conditions of the tasks after a hot reload
+        void reloadConditions(std::vector<TaskDescriptor> &descs); 
 
 
 }; 
\ No newline at end of file
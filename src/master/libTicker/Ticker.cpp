@@ -1,23 +1,21 @@
 #include "Ticker.hpp"
 #include "Serialization.hpp"
 #include <boost/math/distributions/normal.hpp>
+#include <algorithm>
+#include <cmath>
 #include <functional> 
 
 
 // Maximum polling rate per second (10 ms period or 100 updates per)
 #define MAX_POLLR 100
-
-// Thanks Chat gpt
+// Slowest dynamic period (ms), used once no condition is likely to fire
+#define MAX_DYN_PERIOD 1000
+// Dynamic periods are multiples of the client polling wheel tick (ms)
+#define PERIOD_STEP 10
+// Relative period change below which no ticker update is sent
+#define PERIOD_CHANGE_MIN 0.2
 
 namespace {
-    struct PairHash {
-        size_t operator()(const std::pair<std::string, int>& p) const {
-            size_t h1 = std::hash<std::string>{}(p.first);
-            size_t h2 = std::hash<int>{}(p.second);
-            return h1 ^ (h2 << 1); // Bitwise combination
-        }
-    };
-    
     Timer makeTimer(TimerDesc tdesc, uint16_t dname){
         Timer newTimer; 
         newTimer.const_poll = tdesc.isConst; 
@@ -32,77 +30,72 @@ namespace {
 
 MTicker::MTicker(std::vector<TaskDescriptor> &Tasks)
 {
-    std::unordered_map<std::pair<std::string, int>, TimerID, PairHash> used_id;
-    int curr_id = 1; 
+    {
+        std::scoped_lock lk(this->ticker_mutex); 
+        this->addTimers(Tasks, false); 
+    }
+    this->setConditions(Tasks); 
+}
 
+void MTicker::addTimers(std::vector<TaskDescriptor> &Tasks, bool reload){
     for(auto &task : Tasks){
         for(auto &dev : task.binded_devices){
-            if((dev.deviceKind == DeviceKind::INTERRUPT) && !dev.isConst){
+            // Only polling devices are read on a dynamic timer
+            if((dev.deviceKind != DeviceKind::POLLING) && !dev.isConst){
                 continue; 
             }
 
            DevAlias dev_alias = dev.device_name; 
            this->ctl_device_map[dev.controller].insert(dev_alias); 
            // Device Info; 
-           TimerInfo device_info; 
-           if(this->ticker_table.find(dev_alias) != this->ticker_table.end()){
-                device_info = this->ticker_table[dev_alias]; 
-           }
-        
+           TimerInfo &device_info = this->ticker_table[dev_alias]; 
+
+           // A constant timer is shared by the tasks polling the device at the same rate
+           TimerID timer_id = 0; 
            if(dev.isConst){
-                auto data_pair = std::make_pair(dev_alias, dev.polling_period); 
-                if(used_id.find(data_pair) != used_id.end()){
-                    TimerID obj = used_id[data_pair]; 
-                    this->timer_map[obj].tasks.push_back(task.name); 
+                auto used = std::ranges::find_if(device_info.const_timers, [&](TimerID id){ return this->timer_map[id].period == dev.polling_period; }); 
+                if(used != device_info.const_timers.end()){
+                    timer_id = *used; 
                 }
-                else{
-
-                    TimerDesc newTimer; 
-                    newTimer.id = curr_id; 
-                    newTimer.tasks.push_back(task.name); 
-                    newTimer.period =  dev.polling_period; 
-                    newTimer.isConst = true; 
-
-                    // Add timer id -> object mapping in the timer
-                    this->timer_map[curr_id] = newTimer;
-
-                    // Add ID to constant timer
-                    device_info.const_timers.push_back(newTimer.id); 
+           }
+           else{
+                timer_id = device_info.dynamic_time; 
+           }
 
-                    // This is now a used ID, cache it: 
-                    used_id[data_pair] = curr_id; 
+           if(timer_id != 0){
+                auto &tasks = this->timer_map[timer_id].tasks; 
+                if(std::ranges::find(tasks, task.name) == tasks.end()){
+                    tasks.push_back(task.name); 
                 }
+                continue; 
+           }
+
+           TimerDesc newTimer; 
+           newTimer.id = this->next_id++; 
+           newTimer.tasks.push_back(task.name); 
+           newTimer.isConst = dev.isConst; 
+           if(dev.isConst){
+                newTimer.period = dev.polling_period; 
+                device_info.const_timers.push_back(newTimer.id); 
            }
            else{
-                // Make a new TimerDesc if the Dynamic Timer id is unitialized
-                if(device_info.dynamic_time == 0){
-                    // Establish the id of the dynamic timer
-                    device_info.dynamic_time = curr_id; 
-
-                    TimerDesc newTimer; 
-                    newTimer.id = curr_id; 
-                    // yes, all dynamic prs are initialized to a polling rate of 0.5 secons
-                    newTimer.period = 500;
-                    newTimer.tasks.push_back(task.name); 
-                    newTimer.isConst = false; 
-
-                    // add the new timer to the timer id map;
-                    this->timer_map[curr_id] = newTimer; 
-                } 
-                else{
-                    int dyn_id = device_info.dynamic_time; 
-                    this->timer_map[dyn_id].tasks.push_back(task.name); 
+                // yes, all dynamic prs are initialized to a polling rate of 0.5 secons
+                newTimer.period = 500; 
+                device_info.dynamic_time = newTimer.id; 
+           }
+           this->timer_map[newTimer.id] = newTimer; 
 
-                }
+           // Controllers already running only learn about the timer through the next update
+           if(reload){
+                this->changed_timers.insert(newTimer.id); 
            }
-           curr_id++; 
-           this->ticker_table[dev_alias] = device_info;  
         }
     }
 }
 
 // Send the initial Message (including the constant timers for a certain ctl);
 void MTicker::sendInitial(std::vector<Timer> &timerList, std::string &ctl, std::unordered_map<std::string, uint16_t> &devNames){
+    std::scoped_lock lk(this->ticker_mutex); 
     std::unordered_set<DevAlias> omar = this->ctl_device_map[ctl]; 
 
     for(auto& devName : omar){
@@ -114,6 +107,7 @@ void MTicker::sendInitial(std::vector<Timer> &timerList, std::string &ctl, std::
         for(auto &tid:  tInfo.const_timers){
             TimerDesc tdesc = this->timer_map[tid]; 
             timerList.push_back(makeTimer(tdesc, devNames[dname])); 
+            this->changed_timers.erase(tid); 
 
         }
         
@@ -122,86 +116,146 @@ void MTicker::sendInitial(std::vector<Timer> &timerList, std::string &ctl, std::
             TimerID dynId =  tInfo.dynamic_time; 
             TimerDesc newDynTimer = this->timer_map[dynId];
             timerList.push_back(makeTimer(newDynTimer, devNames[dname])); 
+            this->changed_timers.erase(dynId); 
         }
     }   
 }
 
 
 void MTicker::sendTicker(std::vector<Timer> &timerList, std::string &ctl, std::unordered_map<std::string, uint16_t> &devNames){
+    std::scoped_lock lk(this->ticker_mutex); 
     std::unordered_set<DevAlias> omar = this->ctl_device_map[ctl];  
 
     // Only receive a subset of devices that belong to controller ctl: 
     for(auto &dev : omar){
         DevAlias dname = dev; 
         TimerInfo tinfo = this->ticker_table[dev]; 
+
+        // Constant timers are only sent when a reload added them
+        for(auto &tid : tinfo.const_timers){
+            if(this->changed_timers.erase(tid)){
+                timerList.push_back(makeTimer(this->timer_map[tid], devNames[dname])); 
+            }
+        }
         
-        // Only send the dynamic time: 
+        // Only send the dynamic time, and only once its period changed: 
         TimerID id = tinfo.dynamic_time; 
-        if(id != 0){
+        if(id != 0 && this->changed_timers.erase(id)){
             timerList.push_back(makeTimer(this->timer_map[id], devNames[dname])); 
         }
     }
 }
 
-// Update vol Thread
-void MTicker::updateVol(){
-    std::cout<<"To be implemented"<<std::endl; 
-}
-
 // Volatility object
 void MTicker::updateVolH(DevAlias& devName, std::unordered_map<AttrAlias, float>& dataMap){
-    // Update the volatility values: (Perhaps add a mutex)
-    this->volMap[devName] = dataMap; 
+    std::scoped_lock lk(this->ticker_mutex); 
+    // Clients only send the volatilities that changed, so the rest keep their last value
+    for(auto &[attr, vol] : dataMap){
+        this->volMap[devName][attr] = vol; 
+    }
 }
 
+void MTicker::setConditions(std::vector<TaskDescriptor> &Tasks){
+    std::scoped_lock lk(this->ticker_mutex); 
+    // Reloaded tasks may poll devices no running task gave a timer
+    this->addTimers(Tasks, true); 
+
+    this->device_conditions.clear(); 
+    for(auto &task : Tasks){
+        for(auto &cond : task.pollConditions){
+            auto &conditions = this->device_conditions[cond.device]; 
+            if(std::ranges::find(conditions, cond) == conditions.end()){
+                conditions.push_back(cond); 
+            }
+        }
+    }
+}
+
+void MTicker::updateConditions(DevAlias& devName, std::unordered_map<AttrAlias, double>& values){
+    std::vector<Conditional> conditional; 
+    {
+        // Conditions are replaced on hot reloads
+        std::scoped_lock lk(this->ticker_mutex); 
+        auto conditions = this->device_conditions.find(devName); 
+        if(conditions == this->device_conditions.end()){
+            return; 
+        }
 
-// Update vol Thread
-void MTicker::updateSA(){
-    std::cout<<"To be implemented"<<std::endl; 
+        for(auto &cond : conditions->second){
+            auto value = values.find(cond.attribute); 
+            if(value != values.end()){
+                conditional.push_back({static_cast<float>(cond.threshold), static_cast<float>(value->second), devName, cond.attribute}); 
+            }
+        }
+    }
+    if(!conditional.empty()){
+        this->updateSAH(conditional); 
+    }
 }
 
 /* 
 
-Receives the static analysis information from the Exeuction Manager (via the line)
-and updates the polling rate using a gaussian function
+Receives the conditions of the tasks evaluated against the latest states and
+sets the dynamic period of each device from the chance that one of its conditions
+flips before the next poll. The attribute is modelled as normally distributed around
+its last value with the volatility reported by the client, so a condition whose
+threshold lies d away flips with probability p = 2 * P(X > d). The device is polled
+at p * MAX_POLLR, between MAX_POLLR (threshold reached) and 1000 / MAX_DYN_PERIOD.
 
 */ 
 
 void MTicker::updateSAH(std::vector<Conditional> &conditional){
+    std::scoped_lock lk(this->ticker_mutex); 
+
+    // Shortest period asked for by the conditions of each device
+    std::unordered_map<DevAlias, float> periods; 
     for(auto &cond : conditional){
         // Get the volatility for the attribute
         float std = this->volMap[cond.device][cond.field]; 
-        float mean = cond.rhs_arg; 
-        float tester = cond.lhs_arg; 
-
-        float max_pollr = MAX_POLLR; 
+        float distance = std::abs(cond.lhs_arg - cond.rhs_arg); 
 
-        // Boost normal: 
-        boost::math::normal dist(mean, std); 
-        auto ans = static_cast<float>(boost::math::cdf(dist, tester)); 
         float scale = 0; 
-
-        if(tester <= mean){
-            scale = ans; 
+        if(std > 0){
+            // Boost normal: 
+            boost::math::normal dist(0, std); 
+            scale = 2 * static_cast<float>(boost::math::cdf(boost::math::complement(dist, distance))); 
         }
-        else if(tester > mean){
-            scale = 1 - ans; 
+        else if(distance == 0){
+            // A flat attribute only flips a condition it sits on
+            scale = 1; 
         }
 
         // Conversion of polling rate (hz) to period (ms)
-        float period = 1000/((scale * 0.5) * max_pollr); 
+        float period = (scale > 0) ? 1000 / (scale * MAX_POLLR) : MAX_DYN_PERIOD; 
+        period = std::clamp<float>(period, 1000.0f / MAX_POLLR, MAX_DYN_PERIOD); 
 
-        // Check the current entry in the ticker table: 
-        TimerID currTimer = this->ticker_table[cond.device].dynamic_time; 
+        auto [entry, inserted] = periods.try_emplace(cond.device, period); 
+        entry->second = std::min(entry->second, period); 
+    }
 
-        // Alter the current time to account for increased urgency
-        if(period < this->timer_map[currTimer].period){
-            this->timer_map[currTimer].period = static_cast<int>(period); 
+    for(auto &[device, period] : periods){
+        auto info = this->ticker_table.find(device); 
+        if(info == this->ticker_table.end() || info->second.dynamic_time == 0){
+            continue; 
+        }
+
+        auto &timer = this->timer_map.at(info->second.dynamic_time); 
+        int newPeriod = static_cast<int>(std::lround(period / PERIOD_STEP)) * PERIOD_STEP; 
+        // Small adjustments are not worth a ticker update
+        if(std::abs(newPeriod - timer.period) >= std::max<float>(PERIOD_STEP, PERIOD_CHANGE_MIN * timer.period)){
+            timer.period = newPeriod; 
+            this->changed_timers.insert(timer.id); 
         }
     }
 }
 
 // maps names to tasks
-std::vector<TaskAlias>& MTicker::getTasks(TimerID t_id){
-    return this->timer_map[t_id].tasks; 
+std::vector<TaskAlias> MTicker::getTasks(TimerID t_id){
+    std::scoped_lock lk(this->ticker_mutex); 
+    // Copied, reloads add tasks to the timers
+    auto timer = this->timer_map.find(t_id); 
+    if(timer == this->timer_map.end()){
+        return {}; 
+    }
+    return timer->second.tasks; 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <string> 
 #include "Serialization.hpp"
 #include "Protocol.hpp"
+#include <mutex>
 #include <unordered_set>
 
 using DevAlias = std::string; 
@@ -16,7 +17,7 @@ using TimerList = std::unordered_map<int, TimerID>;
 using AttrVol = std::unordered_map<AttrAlias, float>; 
 
 struct Conditional{
-    // RHS and LHS sign
+    // Threshold of the condition (RHS) and the last value of the attribute (LHS)
     float rhs_arg; 
     float lhs_arg; 
     // Device associated with the object
@@ -67,29 +68,42 @@ class MTicker{
 
         std::unordered_map<DevAlias, DeviceDescriptor> device_data; 
 
+        // Thresholds the tasks compare each device's attributes against
+        std::unordered_map<DevAlias, std::vector<PollCondition>> device_conditions; 
+        // Timers added on a reload, or dynamic timers whose period changed, since they were last sent
+        std::unordered_set<TimerID> changed_timers; 
+        TimerID next_id = 1; 
+
+        // Handlers run on the network threads
+        std::mutex ticker_mutex; 
+
+        // Gives every polling device of the tasks its timers, reusing the ones it already has
+        void addTimers(std::vector<TaskDescriptor> &Tasks, bool reload); 
+
     public: 
         // Intialize the tocker table: 
         MTicker(std::vector<TaskDescriptor> &Tasks);
 
+        // Rebuilds the conditions of every device from the tasks and adds the timers they are missing (hot reload)
+        void setConditions(std::vector<TaskDescriptor> &Tasks); 
+
 
-        // Thread updates volatility from the vol TSQ
-        void updateVol(); 
         // Updates single volatility object: 
         void updateVolH(DevAlias& devName, std::unordered_map<AttrAlias, float>& dataMap); 
 
-        // Thread reads the volati
-        void updateSA(); 
-        // Updates single ticker entry from SA line
+        // Evaluates the device's conditions against the state it just sent
+        void updateConditions(DevAlias& devName, std::unordered_map<AttrAlias, double>& values); 
+        // Updates the dynamic periods from conditions evaluated against the latest states
         void updateSAH(std::vector<Conditional> &conditional_data); 
 
 
         // Send the inital message with constants;  
         void sendInitial(std::vector<Timer> &timerVector, std::string &ctl, std::unordered_map<std::string, uint16_t> &device_map); 
-        // send the remaining messages (only dynamic rates)
+        // send the remaining messages (only timers added or dynamic rates that changed since the last call)
         void sendTicker(std::vector<Timer> &timerVector, std::string &ctl, std::unordered_map<std::string, uint16_t> &device_map); 
 
         // Get Tasks list: given a timerID get the list of associated tasks
-        std::vector<TaskAlias>& getTasks(TimerID id); 
+        std::vector<TaskAlias> getTasks(TimerID id); 
 
         
 
@@ -1,10 +1,24 @@
 #include "compiler.hpp"
+#include "program_diff.hpp"
+#include "task_fusion.hpp"
+#include "task_distribution.hpp"
 #include "Serialization.hpp"
 #include "EM.hpp"
 #include "MM.hpp"
 #include "MasterNM.hpp"
+#include "LatencyTrace.hpp"
 #include "bls_types.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <filesystem>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -59,7 +73,99 @@ namespace {
             for(auto& devId : outMap){
                 task.outDevices.push_back(devMap[devId]); 
             }   
+
+            // Tasks that only write inside branches and are safe to rerun skip ownership on runs that write nothing.
+            // The first run sees out device states from before ownership, so it may only decide on the in devices
+            auto& connections = gcx.taskConnections[task.name]; 
+            bool readsOutDevice = std::ranges::any_of(outMap, [&connections](const DeviceID& dev){
+                return connections.inDeviceList.contains(dev); 
+            }); 
+            task.deferOwnership = !outMap.empty() && !readsOutDevice && connections.unconditionalOutDevices.empty() && !connections.hasSideEffects; 
+
+            // Thresholds the master adapts the polling rate of the compared devices to
+            for(auto& cond : connections.conditions){
+                task.pollConditions.push_back({cond.device, cond.attribute, cond.threshold}); 
+            }
+        }
+    }
+
+    /*
+        Recompiles the source whenever it is modified and hot swaps the tasks whose
+        bindings are unchanged. Everything else keeps running the previous program.
+    */
+    void watchSource(const std::string& filename, std::vector<TaskDescriptor> runningTasks, 
+                     BlsLang::TaskFingerprints runningFingerprints, ExecutionManager& EM, MasterMailbox& MM, MasterNM& NM){
+        namespace fs = std::filesystem; 
+        std::error_code ec; 
+        auto lastWrite = fs::last_write_time(filename, ec); 
+
+        while(true){
+            std::this_thread::sleep_for(std::chrono::seconds(1)); 
+            auto writeTime = fs::last_write_time(filename, ec); 
+            if(ec || writeTime == lastWrite){
+                continue; 
+            }
+            lastWrite = writeTime; 
+
+            auto bytecode = std::make_shared<std::vector<char>>(); 
+            BlsLang::Compiler compiler; 
+            compiler.setFingerprinting(true); 
+            try{
+                compiler.compileFile(filename, *bytecode); 
+            }
+            catch(std::exception& e){
+                std::cout<<"Reload failed, keeping the running program: "<<e.what()<<std::endl; 
+                continue; 
+            }
+
+            std::vector<TaskDescriptor> newTasks = compiler.getTaskDescriptors(); 
+            modifyTaskDesc(newTasks, compiler.getGlobalContext()); 
+            auto& newFingerprints = compiler.getTaskFingerprints(); 
+
+            bool conditionsChanged = false; 
+            for(auto& change : BlsLang::diffPrograms(runningTasks, runningFingerprints, newTasks, newFingerprints)){
+                if(change.requiresRestart){
+                    std::cout<<"Task "<<change.task<<" was added, removed or rebound; restart to apply it"<<std::endl; 
+                    continue; 
+                }
+
+                auto newTask = std::ranges::find(newTasks, change.task, &TaskDescriptor::name); 
+                auto runningTask = std::ranges::find(runningTasks, change.task, &TaskDescriptor::name); 
+                if(change.triggersChanged){
+                    MM.reloadTask(*newTask); 
+                }
+                if(change.policyChanged && runningTask->pollConditions != newTask->pollConditions){
+                    conditionsChanged = true; 
+                }
+                // Offsets of unchanged tasks stay valid against the program they already hold
+                EM.reloadTask(*newTask, bytecode); 
+                *runningTask = *newTask; 
+                runningFingerprints[change.task] = newFingerprints.at(change.task); 
+            }
+
+            // Deferred ownership is carried by the reloaded task, the polling conditions live in the ticker
+            if(conditionsChanged){
+                NM.reloadConditions(runningTasks); 
+            }
+        }
+    }
+}
+
+
+// Parses the value of a count option, nothing is returned for non-numbers and counts below min
+std::optional<size_t> parseCount(const std::string& value, size_t min){
+    if(value.empty() || !std::ranges::all_of(value, [](unsigned char c){ return std::isdigit(c); })){
+        return std::nullopt; 
+    }
+    try{
+        size_t count = std::stoul(value); 
+        if(count < min){
+            return std::nullopt; 
         }
+        return count; 
+    }
+    catch(std::out_of_range&){
+        return std::nullopt; 
     }
 }
 
@@ -68,19 +174,104 @@ int main(int argc, char *argv[]){
 
     
     std::string filename;
+    // Number of mailbox worker threads (1 keeps all reader boxes on the NM thread)
+    size_t mailboxShards = 1; 
+    // Number of shared execution workers (0 gives every task its own thread)
+    size_t executorWorkers = 0; 
+    // Recompile and hot swap edited tasks while running
+    bool watch = false; 
+    // Reuse the compiled program from the last run of an unchanged source
+    bool useCache = false; 
+    // Workers used to generate task and procedure bodies (1 compiles sequentially)
+    size_t compileThreads = 1; 
+    // Run tasks sharing the same trigger rules as a single execution unit
+    bool fuse = false; 
+    // Run tasks whose devices all live on one controller on that controller
+    bool distribute = false; 
+    // Dump the latency histograms of traced events
+    bool trace = false; 
+    // Lease devices with a single writing task to it instead of running the ownership protocol per execution
+    bool leaseDevices = false; 
 
-    if(argc == 2){
+    if(argc >= 2){
         filename = std::string(std::string(argv[1])); 
     }
     else{
         std::cout<<"Invalid number of arguments"<<std::endl;
         return 1;
     }
+
+    for(int i = 2; i < argc; i++){
+        std::string option = argv[i]; 
+        if(option == "--mm-shards" && i + 1 < argc){
+            auto shards = parseCount(argv[++i], 1); 
+            if(!shards){
+                std::cout<<"--mm-shards expects a number of at least 1, got: "<<argv[i]<<std::endl; 
+                return 1; 
+            }
+            mailboxShards = *shards; 
+        }
+        else if(option == "--em-workers" && i + 1 < argc){
+            auto workers = parseCount(argv[++i], 1); 
+            if(!workers){
+                std::cout<<"--em-workers expects a number of at least 1, got: "<<argv[i]<<std::endl; 
+                return 1; 
+            }
+            executorWorkers = *workers; 
+        }
+        else if(option == "--em-pool"){
+            executorWorkers = std::max(1u, std::thread::hardware_concurrency()); 
+        }
+        else if(option == "--watch"){
+            watch = true; 
+        }
+        else if(option == "--cache"){
+            useCache = true; 
+        }
+        else if(option == "--compile-threads" && i + 1 < argc){
+            auto threads = parseCount(argv[++i], 1); 
+            if(!threads){
+                std::cout<<"--compile-threads expects a number of at least 1, got: "<<argv[i]<<std::endl; 
+                return 1; 
+            }
+            compileThreads = *threads; 
+        }
+        else if(option == "--fuse-tasks"){
+            fuse = true; 
+        }
+        else if(option == "--distribute"){
+            distribute = true; 
+        }
+        else if(option == "--trace"){
+            trace = true; 
+        }
+        else if(option == "--lease-devices"){
+            leaseDevices = true; 
+        }
+        else{
+            std::cout<<"Unknown option: "<<option<<std::endl; 
+            return 1; 
+        }
+    }
+    
+    if(trace){
+        LatencyTracer::instance().enable(); 
+        LatencyTracer::instance().startReporter(std::chrono::seconds(TRACE_REPORT_PERIOD), "master"); 
+    }
     
     printf("pre compilation\n");
     // Makes interpreter
     std::vector<char> bytecode;
     BlsLang::Compiler compiler;
+    // Controller programs are generated from the compiled source, which a cached compile skips
+    if(useCache && distribute && !watch){
+        std::cout<<"The compile cache is disabled while distributing tasks"<<std::endl; 
+    }
+    else if(useCache){
+        compiler.setCacheDirectory(BlsLang::CompileCache::defaultDirectory()); 
+    }
+    compiler.setCompileThreads(compileThreads); 
+    compiler.setFingerprinting(watch); 
     compiler.compileFile(filename, bytecode); 
     printf("past compilation\n");
 
@@ -88,6 +279,27 @@ int main(int argc, char *argv[]){
 
     // Only temporary until symgraph is complete
     modifyTaskDesc(taskDescriptors, compiler.getGlobalContext()); 
+
+    // Reloads only reach the tasks running on the master
+    BlsLang::DistributionPlan plan; 
+    if(distribute && watch){
+        std::cout<<"Task distribution is disabled while watching the source"<<std::endl; 
+    }
+    else if(distribute){
+        plan = BlsLang::distributeTasks(taskDescriptors, compiler.getGlobalContext()); 
+        taskDescriptors = plan.masterTasks; 
+        for(auto& [controller, tasks] : plan.controllerTasks){
+            compiler.compileSlice(tasks, plan.controllerPrograms[controller]); 
+        }
+    }
+
+    // Reloads are applied per source task, which fused tasks no longer map to
+    if(fuse && watch){
+        std::cout<<"Task fusion is disabled while watching the source"<<std::endl; 
+    }
+    else if(fuse){
+        taskDescriptors = BlsLang::fuseTasks(taskDescriptors, compiler.getGlobalContext()); 
+    }
     
 
     // EM and MM
@@ -98,24 +310,39 @@ int main(int argc, char *argv[]){
     TSQ<DMM> NM_MM_queue; 
     TSQ<DMM> MM_NM_queue; 
 
+    // The network still configures the devices and timers of the distributed tasks
+    std::vector<TaskDescriptor> networkTasks = taskDescriptors; 
+    for(auto& [controller, tasks] : plan.controllerTasks){
+        networkTasks.insert(networkTasks.end(), tasks.begin(), tasks.end()); 
+    }
+
     // Make network (runs at start)
-    MasterNM NM(taskDescriptors, MM_NM_queue, NM_MM_queue);
+    MasterNM NM(networkTasks, MM_NM_queue, NM_MM_queue);
+    NM.setControllerPrograms(plan.controllerTasks, plan.controllerPrograms); 
     NM.start(); 
 
 
-    ExecutionManager EM(taskDescriptors, MM_EM_queue, EM_MM_queue, bytecode); 
+    ExecutionManager EM(taskDescriptors, MM_EM_queue, EM_MM_queue, bytecode, executorWorkers, leaseDevices); 
     std::thread t3([&](){EM.running();});
     
     // Make Mailbox (runs with EM and NM)
-    MasterMailbox MM(taskDescriptors, NM_MM_queue, EM_MM_queue, MM_NM_queue, MM_EM_queue); 
+    MasterMailbox MM(taskDescriptors, NM_MM_queue, EM_MM_queue, MM_NM_queue, MM_EM_queue, mailboxShards); 
     std::thread t1([&](){MM.runningEM();}); 
     std::thread t2([&](){MM.runningNM();});   
     
     NM.makeBeginCall(); 
 
+    std::thread watcher; 
+    if(watch){
+        watcher = std::thread(watchSource, filename, taskDescriptors, compiler.getTaskFingerprints(), std::ref(EM), std::ref(MM), std::ref(NM)); 
+    }
+
     t1.join(); 
     t2.join(); 
     t3.join(); 
+    if(watcher.joinable()){
+        watcher.join(); 
+    }
     
     
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 int main(int argc, char** argv) {
     std::stringstream compiledSrc;
     BlsLang::Compiler compiler;
+    compiler.setCacheDirectory(BlsLang::CompileCache::defaultDirectory());
     if (argc < 2) {
         std::string source{(std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>()};
         compiler.compileSource(source, compiledSrc);
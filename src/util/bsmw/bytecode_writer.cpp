@@ -6,6 +6,7 @@
 #include "opcodes.hpp"
 #include "traps.hpp"
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <iostream>
@@ -27,6 +28,15 @@ static std::stringstream& operator>>(std::stringstream& ss, uint8_t& num) {
     return ss;
 }
 
+// Rejects operands that only fit the _W variant of an opcode instead of silently truncating them
+template<typename T>
+static T narrowOperand(auto value, const std::string& opcode) {
+    if (value > std::numeric_limits<T>::max()) {
+        throw std::runtime_error("OPERAND OUT OF RANGE FOR " + opcode + ", USE " + opcode + "_W");
+    }
+    return value;
+}
+
 std::string BytecodeWriter::loadJSON(std::string jsonDelimiter) {
     std::string buf, result;
     while ((std::getline(mnemonicBytecode, buf)) && (buf != jsonDelimiter)) {
@@ -66,20 +76,26 @@ void BytecodeWriter::writeHeader() {
 void BytecodeWriter::writeLiteralPool() {
     auto poolJSON = loadJSON("BYTECODE_BEGIN");
     auto pool = value_to<std::vector<BlsType>>(parse(poolJSON));
-    uint8_t index = 0;
+    uint16_t index = 0;
     for (auto&& literal : pool) {
         literalPool[literal] = index++;
     }
     bs->writeLiteralPool(pool);
 }
 
-void BytecodeWriter::parseCALL(uint16_t& address, uint8_t& argc) {
+void BytecodeWriter::parseCALL(uint32_t& address, uint8_t& argc) {
     std::string functionName;
     mnemonicBytecode >> functionName;
     address = functionSymbols.at(functionName).first;
     parseArgs(argc);
 }
 
+void BytecodeWriter::parseCALL(uint16_t& address, uint8_t& argc) {
+    uint32_t wideAddress;
+    parseCALL(wideAddress, argc);
+    address = narrowOperand<uint16_t>(wideAddress, "CALL");
+}
+
 void BytecodeWriter::parseEMIT(uint8_t& signal) {
     using enum BytecodeProcessor<>::SIGNAL;
     std::string signalString;
@@ -95,14 +111,20 @@ void BytecodeWriter::parseEMIT(uint8_t& signal) {
     }
 }
 
-void BytecodeWriter::parsePUSH(uint8_t& index) {
+void BytecodeWriter::parsePUSH(uint16_t& index) {
     std::string buf;
     std::getline(mnemonicBytecode, buf);
     auto literal = value_to<BlsType>(parse(buf));
     index = literalPool.at(literal);
 }
 
-void BytecodeWriter::parseMKTYPE(uint8_t& index, uint8_t& type) {
+void BytecodeWriter::parsePUSH(uint8_t& index) {
+    uint16_t wideIndex;
+    parsePUSH(wideIndex);
+    index = narrowOperand<uint8_t>(wideIndex, "PUSH");
+}
+
+void BytecodeWriter::parseMKTYPE(uint16_t& index, uint8_t& type) {
     std::string buf;
     mnemonicBytecode >> buf;
     index = currentFunctionSymbols.at(buf);
@@ -110,18 +132,36 @@ void BytecodeWriter::parseMKTYPE(uint8_t& index, uint8_t& type) {
     type = static_cast<uint8_t>(getTypeFromName(buf));
 }
 
-void BytecodeWriter::parseSTORE(uint8_t& index) {
+void BytecodeWriter::parseMKTYPE(uint8_t& index, uint8_t& type) {
+    uint16_t wideIndex;
+    parseMKTYPE(wideIndex, type);
+    index = narrowOperand<uint8_t>(wideIndex, "MKTYPE");
+}
+
+void BytecodeWriter::parseSTORE(uint16_t& index) {
     std::string buf;
     mnemonicBytecode >> buf;
     index = currentFunctionSymbols.at(buf);
 }
 
-void BytecodeWriter::parseLOAD(uint8_t& index) {
+void BytecodeWriter::parseSTORE(uint8_t& index) {
+    uint16_t wideIndex;
+    parseSTORE(wideIndex);
+    index = narrowOperand<uint8_t>(wideIndex, "STORE");
+}
+
+void BytecodeWriter::parseLOAD(uint16_t& index) {
     std::string buf;
     mnemonicBytecode >> buf;
     index = currentFunctionSymbols.at(buf);
 }
 
+void BytecodeWriter::parseLOAD(uint8_t& index) {
+    uint16_t wideIndex;
+    parseLOAD(wideIndex);
+    index = narrowOperand<uint8_t>(wideIndex, "LOAD");
+}
+
 void BytecodeWriter::parseMTRAP(uint16_t& callnum) {
     using namespace BlsTrap;
     std::string buf;
@@ -148,22 +188,22 @@ void BytecodeWriter::writeBody() {
         #define ARGUMENT(arg, type) \
             type& arg = instruction->arg;
         #define OPCODE_END(code, args...) \
-            if constexpr (c == OPCODE::CALL) { \
+            if constexpr (c == OPCODE::CALL || c == OPCODE::CALL_W) { \
                 parseCALL(args); \
             } \
             else if constexpr (c == OPCODE::EMIT) { \
                 parseEMIT(args); \
             } \
-            else if constexpr (c == OPCODE::PUSH) { \
+            else if constexpr (c == OPCODE::PUSH || c == OPCODE::PUSH_W) { \
                 parsePUSH(args); \
             } \
-            else if constexpr (c == OPCODE::MKTYPE) { \
+            else if constexpr (c == OPCODE::MKTYPE || c == OPCODE::MKTYPE_W) { \
                 parseMKTYPE(args); \
             } \
-            else if constexpr (c == OPCODE::STORE) { \
+            else if constexpr (c == OPCODE::STORE || c == OPCODE::STORE_W) { \
                 parseSTORE(args); \
             } \
-            else if constexpr (c == OPCODE::LOAD) { \
+            else if constexpr (c == OPCODE::LOAD || c == OPCODE::LOAD_W) { \
                 parseLOAD(args); \
             } \
             else if constexpr (c == OPCODE::MTRAP) { \
@@ -184,7 +224,7 @@ void BytecodeWriter::writeBody() {
         else if (buf.ends_with(':')) { // task/procedure labels
             buf.pop_back();
             auto& symbolList = functionSymbols.at(buf).second;
-            uint8_t index = 0;
+            uint16_t index = 0;
             for (auto&& symbol : symbolList) {
                 currentFunctionSymbols[symbol] = index++;
             }
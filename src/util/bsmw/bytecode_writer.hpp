@@ -24,11 +24,16 @@ class BytecodeWriter {
         template<typename... Args>
         void parseArgs(Args&... args);
 
+        void parseCALL(uint32_t& address, uint8_t& argc);
         void parseCALL(uint16_t& address, uint8_t& argc);
         void parseEMIT(uint8_t& signal);
+        void parsePUSH(uint16_t& index);
         void parsePUSH(uint8_t& index);
+        void parseMKTYPE(uint16_t& index, uint8_t& type);
         void parseMKTYPE(uint8_t& index, uint8_t& type);
+        void parseSTORE(uint16_t& index);
         void parseSTORE(uint8_t& index);
+        void parseLOAD(uint16_t& index);
         void parseLOAD(uint8_t& index);
         void parseMTRAP(uint16_t& callnum);
         void parseTRAP(uint16_t& callnum, uint8_t& argc);
@@ -44,7 +49,7 @@ class BytecodeWriter {
 
         std::stringstream mnemonicBytecode;
         std::unique_ptr<BytecodeSerializer> bs = nullptr;
-        std::unordered_map<BlsType, uint8_t> literalPool;
-        std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>>> functionSymbols;
-        std::unordered_map<std::string, uint8_t> currentFunctionSymbols;
+        std::unordered_map<BlsType, uint16_t> literalPool;
+        std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>>> functionSymbols;
+        std::unordered_map<std::string, uint16_t> currentFunctionSymbols;
 };
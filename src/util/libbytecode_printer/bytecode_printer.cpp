@@ -199,7 +199,7 @@ void BytecodePrinter::printAll() {
 }
 
 void BytecodePrinter::printMetadata() {
-    std::unordered_map<std::string, std::pair<uint16_t, std::vector<std::string>&>> functionSymbols;
+    std::unordered_map<std::string, std::pair<uint32_t, std::vector<std::string>&>> functionSymbols;
     for (auto&& [address, metadata] : functionMetadata) {
         functionSymbols.emplace(metadata.first, std::make_pair(address, std::ref(metadata.second)));
     }
@@ -222,7 +222,7 @@ void BytecodePrinter::printArgs(Args... args) {
     ((*outputStream << " " << args), ...);
 }
 
-void BytecodePrinter::printCALL(uint16_t address, uint8_t argc) {
+void BytecodePrinter::printCALL(uint32_t address, uint8_t argc) {
     printArgs(functionMetadata.at(address).first, argc);
 }
 
@@ -241,20 +241,20 @@ void BytecodePrinter::printEMIT(uint8_t signal) {
     }
 }
 
-void BytecodePrinter::printPUSH(uint8_t index) {
+void BytecodePrinter::printPUSH(uint16_t index) {
     *outputStream << " ";
     prettyPrintLiteralPool(*outputStream, value_from(literalPool.at(index)));
 }
 
-void BytecodePrinter::printMKTYPE(uint8_t index, uint8_t type) {
+void BytecodePrinter::printMKTYPE(uint16_t index, uint8_t type) {
     printArgs(currentFunctionSymbols->at(index), getTypeName(static_cast<TYPE>(type)));
 }
 
-void BytecodePrinter::printSTORE(uint8_t index) {
+void BytecodePrinter::printSTORE(uint16_t index) {
     printArgs(currentFunctionSymbols->at(index));
 }
 
-void BytecodePrinter::printLOAD(uint8_t index) {
+void BytecodePrinter::printLOAD(uint16_t index) {
     printArgs(currentFunctionSymbols->at(index));
 }
 
@@ -281,22 +281,22 @@ void BytecodePrinter::code(
         *outputStream << functionLabel << ":\n"; \
     } \
     *outputStream << "[" << instruction - 1 << "] " << #code; \
-    if constexpr (OPCODE::code == OPCODE::CALL) { \
+    if constexpr (OPCODE::code == OPCODE::CALL || OPCODE::code == OPCODE::CALL_W) { \
         printCALL(args); \
     } \
     else if constexpr (OPCODE::code == OPCODE::EMIT) { \
         printEMIT(args); \
     } \
-    else if constexpr (OPCODE::code == OPCODE::PUSH) { \
+    else if constexpr (OPCODE::code == OPCODE::PUSH || OPCODE::code == OPCODE::PUSH_W) { \
         printPUSH(args); \
     } \
-    else if constexpr (OPCODE::code == OPCODE::MKTYPE) { \
+    else if constexpr (OPCODE::code == OPCODE::MKTYPE || OPCODE::code == OPCODE::MKTYPE_W) { \
         printMKTYPE(args); \
     } \
-    else if constexpr (OPCODE::code == OPCODE::STORE) { \
+    else if constexpr (OPCODE::code == OPCODE::STORE || OPCODE::code == OPCODE::STORE_W) { \
         printSTORE(args); \
     } \
-    else if constexpr (OPCODE::code == OPCODE::LOAD) { \
+    else if constexpr (OPCODE::code == OPCODE::LOAD || OPCODE::code == OPCODE::LOAD_W) { \
         printLOAD(args); \
     } \
     else if constexpr (OPCODE::code == OPCODE::MTRAP) { \
@@ -34,12 +34,12 @@ class BytecodePrinter : public BytecodeProcessor<BytecodePrinter, false> {
     private:
         template<typename... Args>
         void printArgs(Args... args);
-        void printCALL(uint16_t address, uint8_t argc);
+        void printCALL(uint32_t address, uint8_t argc);
         void printEMIT(uint8_t signal);
-        void printPUSH(uint8_t index);
-        void printMKTYPE(uint8_t index, uint8_t type);
-        void printSTORE(uint8_t index);
-        void printLOAD(uint8_t index);
+        void printPUSH(uint16_t index);
+        void printMKTYPE(uint16_t index, uint8_t type);
+        void printSTORE(uint16_t index);
+        void printLOAD(uint16_t index);
         void printMTRAP(uint16_t callnum);
         void printTRAP(uint16_t callnum, uint8_t argc);
         /* C style overloads of specialized functions to get around xmacro error in if constexpr for uncompiled branches */
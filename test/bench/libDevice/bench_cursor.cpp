@@ -0,0 +1,88 @@
+#include "DeviceUtil.hpp"
+#include "typedefs.hpp"
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Runs concurrent READ queries against a TEXT_FILE cursor from one strand per task,
+    the way the client dispatches cursor state changes, and reports query throughput.
+    Usage: bench_cursor [queries per task] [tasks] [threads]
+*/
+
+namespace {
+    // TEXT_FILE resolves its file under ./samples/client, so the bench runs from a scratch directory
+    std::filesystem::path makeScratchDirectory() {
+        auto dir = std::filesystem::temp_directory_path() / "bench_cursor";
+        std::filesystem::create_directories(dir / "samples" / "client");
+        std::ofstream file(dir / "samples" / "client" / "cursor.txt", std::ios::trunc);
+        file << std::string(4096, 'x');
+        return dir;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t queries = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    size_t tasks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+
+    auto scratchDir = makeScratchDirectory();
+    std::filesystem::current_path(scratchDir);
+
+    std::unordered_map<std::string, std::string> config = {{"file", "cursor.txt"}};
+    DeviceHandle device(TYPE::TEXT_FILE, config, nullptr);
+    DeviceCursor cursor(device, nullptr, 0, 0);
+
+    TypeDef::TEXT_FILE query;
+    query.operation = "READ 16";
+    query.index = 0;
+    DynamicMessage dmsg;
+    dmsg.packStates(query);
+
+    boost::asio::thread_pool pool(threads);
+    std::vector<boost::asio::strand<boost::asio::thread_pool::executor_type>> strands;
+    for (size_t i = 0; i < tasks; i++) {
+        strands.push_back(boost::asio::make_strand(pool.get_executor()));
+    }
+
+    auto cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries; i++) {
+        for (uint16_t task = 0; task < tasks; task++) {
+            boost::asio::post(strands.at(task), [&cursor, &device, &dmsg, task]() {
+                cursor.addQueryHandler(task);
+                device.processStates(dmsg);
+                cursor.completeQuery();
+            });
+        }
+    }
+    pool.join();
+    auto end = std::chrono::steady_clock::now();
+    auto cpuEnd = std::clock();
+
+    for (uint16_t task = 0; task < tasks; task++) {
+        TypeDef::TEXT_FILE view;
+        cursor.getLatestTaskView(task).unpackStates(view);
+        if (view.readResult != std::string(16, 'x')) {
+            std::cerr << "Task " << task << " holds a stale view" << std::endl;
+            return 1;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    double cpuMs = 1000.0 * (cpuEnd - cpuStart) / CLOCKS_PER_SEC;
+    size_t total = queries * tasks;
+    std::cout << total << " queries, " << tasks << " tasks, " << threads << " threads" << std::endl;
+    std::cout << "wall: " << ms << " ms, " << total / (ms / 1000.0) << " queries/s" << std::endl;
+    std::cout << "cpu: " << cpuMs << " ms, " << cpuMs * 1000.0 / total << " us/query" << std::endl;
+
+    std::filesystem::remove_all(scratchDir);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "lexer.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+    Lexes every .blu file under the samples corpus with both lexer modes.
+    Usage: bench_lexer [iterations] [corpus directory]
+*/
+
+using namespace BlsLang;
+
+namespace {
+    std::vector<std::string> loadCorpus(const std::filesystem::path& dir) {
+        std::vector<std::string> sources;
+        for (auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".blu") {
+                std::ifstream file(entry.path());
+                std::stringstream ss;
+                ss << file.rdbuf();
+                sources.push_back(ss.str());
+            }
+        }
+        return sources;
+    }
+
+    template<typename F>
+    double timeMs(size_t iterations, F&& lexAll) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            lexAll();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20;
+    std::filesystem::path corpusDir = argc > 2 ? argv[2] : SAMPLES_DIR;
+
+    auto sources = loadCorpus(corpusDir);
+    size_t bytes = 0, tokenCount = 0;
+    Lexer streamLexer(Lexer::Mode::STREAM);
+    Lexer tableLexer(Lexer::Mode::TABLE);
+    for (auto& source : sources) {
+        bytes += source.size();
+        auto tokens = tableLexer.lex(source);
+        if (tokens != streamLexer.lex(source)) {
+            std::cerr << "Lexer modes disagree on a corpus file" << std::endl;
+            return 1;
+        }
+        tokenCount += tokens.size();
+    }
+    std::cout << sources.size() << " files, " << bytes << " bytes, " << tokenCount << " tokens, "
+              << iterations << " iterations" << std::endl;
+
+    auto report = [&](const char* name, double ms) {
+        double mbPerSec = (bytes * iterations) / (ms * 1000.0);
+        std::cout << name << ": " << ms / iterations << " ms/pass, " << mbPerSec << " MB/s" << std::endl;
+    };
+
+    report("stream (regex)", timeMs(iterations, [&]() {
+        for (auto& source : sources) streamLexer.lex(source);
+    }));
+    report("table", timeMs(iterations, [&]() {
+        for (auto& source : sources) tableLexer.lex(source);
+    }));
+    report("table (views)", timeMs(iterations, [&]() {
+        for (auto& source : sources) tableLexer.lexView(source);
+    }));
+    return 0;
+}
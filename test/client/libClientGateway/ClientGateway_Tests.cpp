@@ -0,0 +1,114 @@
+#include "ClientGateway.hpp"
+#include "DynamicMessage.hpp"
+#include "Protocol.hpp"
+#include "Serialization.hpp"
+#include "TSQ.hpp"
+#include "bls_types.hpp"
+#include "compiler.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+class ClientEMTest : public ::testing::Test
+{
+protected:
+    static constexpr int CTL_CODE = 7;
+    static constexpr task_int TASK_ID = 3;
+
+    TSQ<SentMessage> loopback;
+    TSQ<SentMessage> applied;
+    std::vector<TaskDescriptor> tasks;
+    std::vector<task_int> taskIds = {TASK_ID};
+    std::vector<char> bytecode;
+    std::unordered_map<DeviceID, int> deviceMap = {{"sensor", 0}, {"lamp", 1}};
+
+    void SetUp() override {
+        const std::string source = R"(
+            task echo(TIMER_TEST sensor, TIMER_TEST lamp) : triggerOn(sensor) {
+                lamp.test_val = sensor.test_val;
+            }
+
+            setup() {
+                TIMER_TEST sensor = "CTL::PWR-0";
+                TIMER_TEST lamp = "CTL::PWR-1";
+                echo(sensor, lamp);
+            }
+        )";
+        BlsLang::Compiler compiler;
+        compiler.compileSource(source, bytecode);
+        tasks = compiler.getTaskDescriptors();
+        ASSERT_EQ(tasks.size(), 1);
+        tasks.at(0).inDevices = {tasks.at(0).binded_devices.at(0)};
+        tasks.at(0).outDevices = {tasks.at(0).binded_devices.at(1)};
+    }
+
+    SentMessage makeState(int device, double value) {
+        DynamicMessage dmsg;
+        dmsg.createField("test_val", value);
+        SentMessage sm;
+        sm.header.prot = Protocol::SEND_STATE;
+        sm.header.device_code = device;
+        sm.header.ctl_code = CTL_CODE;
+        sm.body = dmsg.Serialize();
+        sm.header.body_size = sm.body.size();
+        return sm;
+    }
+
+    double readValue(SentMessage& sm) {
+        DynamicMessage dmsg;
+        dmsg.Capture(sm.body);
+        auto tree = dmsg.toTree();
+        return std::get<double>(tree->access(BlsType(std::string("test_val"))));
+    }
+};
+
+TEST_F(ClientEMTest, LocalTaskWritesThroughApplyState_Test)
+{
+    ClientEM clientEM(tasks, taskIds, bytecode, loopback, [this](SentMessage sm){
+        applied.write(sm);
+    }, deviceMap, CTL_CODE);
+    std::jthread runner([&clientEM](std::stop_token stoken){
+        clientEM.run(stoken);
+    });
+
+    // The initial trigger fires once every bound device has reported
+    loopback.write(makeState(1, 0.0));
+    loopback.write(makeState(0, 4.0));
+    auto first = applied.read();
+    EXPECT_EQ(first.header.prot, Protocol::STATE_CHANGE);
+    EXPECT_EQ(first.header.device_code, 1);
+    EXPECT_EQ(first.header.task_id, TASK_ID);
+    EXPECT_EQ(first.header.ctl_code, CTL_CODE);
+    EXPECT_EQ(readValue(first), 4.0);
+
+    // Afterwards only the trigger rule decides
+    loopback.write(makeState(0, 9.0));
+    auto second = applied.read();
+    EXPECT_EQ(readValue(second), 9.0);
+
+    runner.request_stop();
+    runner.join();
+    EXPECT_TRUE(applied.isEmpty());
+}
+
+TEST_F(ClientEMTest, StopsWhileWaiting_Test)
+{
+    ClientEM clientEM(tasks, taskIds, bytecode, loopback, [](SentMessage){}, deviceMap, CTL_CODE);
+    std::jthread runner([&clientEM](std::stop_token stoken){
+        clientEM.run(stoken);
+    });
+    runner.request_stop();
+    runner.join();
+    SUCCEED();
+}
+
+TEST_F(ClientEMTest, RejectsMissingTaskIds_Test)
+{
+    std::vector<task_int> noIds;
+    EXPECT_THROW(ClientEM(tasks, noIds, bytecode, loopback, [](SentMessage){}, deviceMap, CTL_CODE), std::invalid_argument);
+}
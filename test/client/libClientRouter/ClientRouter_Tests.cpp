@@ -0,0 +1,55 @@
+#include "ClientRouter.hpp"
+#include "Protocol.hpp"
+#include "TSQ.hpp"
+#include <gtest/gtest.h>
+
+class ClientRouterTest : public ::testing::Test
+{
+protected:
+    TSQ<SentMessage> loopback;
+    ClientRouter router{loopback};
+
+    SentMessage makeMessage(Protocol prot, dev_int device) {
+        SentMessage sm;
+        sm.header.prot = prot;
+        sm.header.device_code = device;
+        sm.header.body_size = 0;
+        return sm;
+    }
+};
+
+TEST_F(ClientRouterTest, LocalStatesLoopBack_Test)
+{
+    router.addLocalRoute(1);
+    EXPECT_FALSE(router.route(makeMessage(Protocol::SEND_STATE, 1)));
+    ASSERT_EQ(loopback.getSize(), 1);
+    EXPECT_EQ(loopback.read().header.device_code, 1);
+}
+
+TEST_F(ClientRouterTest, MasterStatesAreSent_Test)
+{
+    router.addMasterRoute(2);
+    EXPECT_TRUE(router.route(makeMessage(Protocol::DEVICE_CALLBACK, 2)));
+    EXPECT_TRUE(loopback.isEmpty());
+}
+
+TEST_F(ClientRouterTest, SharedStatesGoBothWays_Test)
+{
+    router.addLocalRoute(3);
+    router.addMasterRoute(3);
+    EXPECT_TRUE(router.route(makeMessage(Protocol::SEND_STATE_INIT, 3)));
+    EXPECT_EQ(loopback.getSize(), 1);
+}
+
+TEST_F(ClientRouterTest, UnroutedStatesAreDropped_Test)
+{
+    EXPECT_FALSE(router.route(makeMessage(Protocol::SEND_STATE, 4)));
+    EXPECT_TRUE(loopback.isEmpty());
+}
+
+TEST_F(ClientRouterTest, OtherMessagesPass_Test)
+{
+    router.addLocalRoute(5);
+    EXPECT_TRUE(router.route(makeMessage(Protocol::CLIENT_ERROR, 5)));
+    EXPECT_TRUE(loopback.isEmpty());
+}
@@ -0,0 +1,126 @@
+#include "ADC.hpp"
+#include "I2CBus.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class ADCTest : public ::testing::Test
+{
+protected:
+    FakeI2CBus* bus;
+    std::unique_ptr<ADS7830> adc;
+
+    void SetUp() override {
+        auto fake = std::make_unique<FakeI2CBus>();
+        bus = fake.get();
+        adc = std::make_unique<ADS7830>(std::move(fake), 10us, 5ms);
+    }
+
+    void waitSweeps(uint64_t count) {
+        auto target = adc->getSweepCount() + count;
+        while (adc->getSweepCount() < target) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+};
+
+TEST_F(ADCTest, ReadsAreCached_Test)
+{
+    bus->setValue(ADS7830::getCommand(2), 100);
+    adc->addChannel(2);
+    waitSweeps(1);
+
+    auto before = bus->getReadCount();
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(adc->readByte(2), 100);
+    }
+    // Only the sweeper touched the bus while the reads were served
+    EXPECT_LT(bus->getReadCount() - before, 1000u);
+}
+
+TEST_F(ADCTest, SweepConvertsAllChannels_Test)
+{
+    for (int channel = 0; channel < ADC_CHANNELS; channel++) {
+        bus->setValue(ADS7830::getCommand(channel), channel * 10);
+        adc->addChannel(channel);
+    }
+    for (int channel = 0; channel < ADC_CHANNELS; channel++) {
+        bus->setValue(ADS7830::getCommand(channel), channel * 10 + 1);
+    }
+    waitSweeps(2);
+
+    for (int channel = 0; channel < ADC_CHANNELS; channel++) {
+        EXPECT_EQ(adc->readByte(channel), channel * 10 + 1);
+    }
+}
+
+TEST_F(ADCTest, FirstReadConverts_Test)
+{
+    bus->setValue(ADS7830::getCommand(5), 42);
+    // Not registered by a driver, the first read still returns a conversion
+    EXPECT_EQ(adc->readByte(5), 42);
+}
+
+TEST_F(ADCTest, ConcurrentReadsDoNotInterleave_Test)
+{
+    std::vector<std::jthread> readers;
+    for (int channel = 0; channel < 4; channel++) {
+        bus->setValue(ADS7830::getCommand(channel), channel + 1);
+        readers.emplace_back([this, channel] {
+            for (int i = 0; i < 200; i++) {
+                EXPECT_EQ(adc->readByte(channel), channel + 1);
+                std::this_thread::sleep_for(100us);
+            }
+        });
+    }
+    readers.clear();
+    EXPECT_EQ(bus->getCollisionCount(), 0u);
+}
+
+TEST_F(ADCTest, SweepFollowsPollingPeriod_Test)
+{
+    adc->addChannel(1);
+    EXPECT_EQ(adc->getSweepPeriod(), 5ms);
+
+    adc->setChannelPeriod(1, 50ms);
+    EXPECT_EQ(adc->getSweepPeriod(), 50ms);
+    // Channels that are not swept do not count
+    adc->setChannelPeriod(3, 20ms);
+    EXPECT_EQ(adc->getSweepPeriod(), 50ms);
+    adc->addChannel(3);
+    EXPECT_EQ(adc->getSweepPeriod(), 20ms);
+
+    adc->setChannelPeriod(1, 0ms);
+    adc->setChannelPeriod(3, 0ms);
+    EXPECT_EQ(adc->getSweepPeriod(), 5ms);
+}
+
+TEST_F(ADCTest, FasterPollingWakesSweeper_Test)
+{
+    adc->setChannelPeriod(0, 10s);
+    adc->addChannel(0);
+    waitSweeps(1);
+
+    auto start = std::chrono::steady_clock::now();
+    adc->setChannelPeriod(0, 5ms);
+    waitSweeps(2);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST_F(ADCTest, InvalidBus_Test)
+{
+    EXPECT_EQ(adc->readByte(-1), 0);
+    EXPECT_EQ(adc->readByte(ADC_CHANNELS), 0);
+
+    adc->close();
+    EXPECT_FALSE(adc->isValid());
+    EXPECT_EQ(adc->readByte(0), 0);
+
+    ADS7830 noBus(nullptr);
+    EXPECT_FALSE(noBus.isValid());
+    EXPECT_EQ(noBus.readByte(0), 0);
+}
@@ -0,0 +1,39 @@
+#include "AttributeVolatility.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+TEST(AttributeVolatilityTest, MatchesPopulationStdWithinWindow_Test)
+{
+    AttributeVolatility volatility(10);
+    std::vector<double> samples = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (auto sample : samples) {
+        volatility.addSample(sample);
+    }
+    EXPECT_EQ(volatility.getSampleCount(), samples.size());
+    EXPECT_NEAR(volatility.getStd(), 2.0, 1e-9);
+}
+
+TEST(AttributeVolatilityTest, ConstantSignal_Test)
+{
+    AttributeVolatility volatility(10);
+    for (int i = 0; i < 1000; i++) {
+        volatility.addSample(21.5);
+    }
+    EXPECT_NEAR(volatility.getStd(), 0.0, 1e-9);
+}
+
+TEST(AttributeVolatilityTest, FollowsRecentBehaviour_Test)
+{
+    AttributeVolatility volatility(10);
+    for (int i = 0; i < 200; i++) {
+        volatility.addSample(i % 2 ? 10 : -10);
+    }
+    EXPECT_GT(volatility.getStd(), 5);
+
+    // once the signal settles the old swings decay away
+    for (int i = 0; i < 200; i++) {
+        volatility.addSample(3);
+    }
+    EXPECT_LT(volatility.getStd(), 0.01);
+}
@@ -0,0 +1,82 @@
+#include "DeviceUtil.hpp"
+#include "DynamicMessage.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <string>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+
+class DeviceCursorTest : public ::testing::Test
+{
+protected:
+    // Seeded, so two handles answer the same sequence of queries with the same samples
+    std::unordered_map<std::string, std::string> config{{"sim", "random"}, {"sim_min", "0"}, {"sim_max", "1000000"}, {"sim_seed", "7"}};
+
+    static DynamicMessage query() {
+        TypeDef::TEXT_FILE states{};
+        states.operation = "READ 16";
+        DynamicMessage dmsg;
+        dmsg.packStates(states);
+        return dmsg;
+    }
+
+    static TypeDef::TEXT_FILE view(DeviceCursor& cursor, uint16_t taskId) {
+        TypeDef::TEXT_FILE states{};
+        cursor.getLatestTaskView(taskId).unpackStates(states);
+        return states;
+    }
+};
+
+// A query finishing after another task's query still gets the result its own driver call wrote
+TEST_F(DeviceCursorTest, OutOfOrderQueriesKeepTheirResults_Test)
+{
+    DeviceHandle reference{TYPE::TEXT_FILE, config, nullptr, true};
+    DeviceCursor referenceCursor(reference, nullptr, 0, 0);
+    for (uint16_t task : {1, 2}) {
+        referenceCursor.addQueryHandler(task);
+        reference.processStates(query());
+        ASSERT_TRUE(referenceCursor.completeQuery());
+    }
+
+    DeviceHandle handle{TYPE::TEXT_FILE, config, nullptr, true};
+    DeviceCursor cursor(handle, nullptr, 0, 0);
+    std::promise<void> firstRan;
+    std::promise<void> secondDone;
+    auto first = std::async(std::launch::async, [&]() {
+        cursor.addQueryHandler(1);
+        handle.processStates(query());
+        firstRan.set_value();
+        secondDone.get_future().wait();
+        return cursor.completeQuery();
+    });
+    ASSERT_EQ(firstRan.get_future().wait_for(1s), std::future_status::ready);
+    auto second = std::async(std::launch::async, [&]() {
+        cursor.addQueryHandler(2);
+        handle.processStates(query());
+        return cursor.completeQuery();
+    });
+    EXPECT_TRUE(second.get());
+    secondDone.set_value();
+    EXPECT_TRUE(first.get());
+
+    EXPECT_EQ(view(cursor, 1).index, view(referenceCursor, 1).index);
+    EXPECT_EQ(view(cursor, 2).index, view(referenceCursor, 2).index);
+    EXPECT_NE(view(cursor, 1).index, view(cursor, 2).index);
+}
+
+// A driver returning without a result is flagged and the task keeps its previous view
+TEST_F(DeviceCursorTest, QueryWithoutResultIsFlagged_Test)
+{
+    DeviceHandle handle{TYPE::TEXT_FILE, config, nullptr, true};
+    DeviceCursor cursor(handle, nullptr, 0, 0);
+    cursor.addQueryHandler(1);
+    handle.processStates(query());
+    ASSERT_TRUE(cursor.completeQuery());
+    auto previous = view(cursor, 1);
+
+    cursor.addQueryHandler(1);
+    EXPECT_FALSE(cursor.completeQuery());
+    EXPECT_EQ(view(cursor, 1).index, previous.index);
+}
@@ -0,0 +1,98 @@
+#include "InterruptReactor.hpp"
+#include <gtest/gtest.h>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+class InterruptReactorTest : public ::testing::Test 
+{
+protected:
+    boost::asio::io_context ctx;
+    InterruptReactor reactor{ctx};
+    std::string filename = (std::filesystem::temp_directory_path() / "bls_interrupt_reactor_test.txt").string();
+    int events = 0;
+
+    void SetUp() override {
+        std::ofstream(filename) << "initial";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(filename);
+    }
+
+    void writeFile(const std::string& contents) {
+        std::ofstream(filename) << contents;
+    }
+
+    // Runs the loop until the expected event count is reached or the wait times out
+    void runUntil(int expectedEvents, std::chrono::milliseconds timeout = std::chrono::milliseconds(500)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (events < expectedEvents && std::chrono::steady_clock::now() < deadline) {
+            ctx.run_for(std::chrono::milliseconds(10));
+        }
+    }
+};
+
+TEST_F(InterruptReactorTest, FileWrite_Test)
+{
+    int id = reactor.addFileWatch(filename, [this](){ events++; });
+    ASSERT_GE(id, 0);
+    writeFile("changed");
+    runUntil(1);
+    EXPECT_EQ(events, 1);
+}
+
+TEST_F(InterruptReactorTest, SharedFile_Test)
+{
+    int otherEvents = 0;
+    reactor.addFileWatch(filename, [this](){ events++; });
+    int other = reactor.addFileWatch(filename, [&otherEvents](){ otherEvents++; });
+    reactor.pauseFileWatch(other);
+    writeFile("changed");
+    runUntil(1);
+    EXPECT_EQ(events, 1);
+    EXPECT_EQ(otherEvents, 0);
+}
+
+TEST_F(InterruptReactorTest, PausedFile_Test)
+{
+    int id = reactor.addFileWatch(filename, [this](){ events++; });
+    reactor.pauseFileWatch(id);
+    writeFile("ignored");
+    runUntil(1, std::chrono::milliseconds(100));
+    EXPECT_EQ(events, 0);
+
+    reactor.resumeFileWatch(id);
+    writeFile("changed");
+    runUntil(1);
+    EXPECT_EQ(events, 1);
+}
+
+TEST_F(InterruptReactorTest, MissingFile_Test)
+{
+    EXPECT_EQ(reactor.addFileWatch(filename + ".missing", [this](){ events++; }), -1);
+}
+
+TEST_F(InterruptReactorTest, SignalFromThread_Test)
+{
+    int id = reactor.addSource([this](){ events++; });
+    std::jthread driver([this, id](){
+        reactor.signal(id);
+        reactor.signal(id);
+    });
+    driver.join();
+    runUntil(2);
+    EXPECT_EQ(events, 2);
+}
+
+TEST_F(InterruptReactorTest, RemovedSource_Test)
+{
+    int id = reactor.addSource([this](){ events++; });
+    reactor.signal(id);
+    reactor.removeSource(id);
+    runUntil(1, std::chrono::milliseconds(100));
+    EXPECT_EQ(events, 0);
+}
@@ -0,0 +1,126 @@
+#include "PollingWheel.hpp"
+#include <gtest/gtest.h>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class PollingWheelTest : public ::testing::Test
+{
+protected:
+    boost::asio::io_context ctx;
+    std::vector<std::vector<SentMessage>> batches;
+    PollingWheel wheel{ctx, [this](std::vector<SentMessage> batch){ batches.push_back(std::move(batch)); }};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Every due timer adds one message carrying its id
+    PollingWheel::Handler makeHandler(std::vector<std::vector<uint16_t>>& fired, std::vector<std::chrono::milliseconds>* times = nullptr) {
+        return [this, &fired, times](const std::vector<uint16_t>& timerIds, std::vector<SentMessage>& batch) {
+            fired.push_back(timerIds);
+            if (times) {
+                times->push_back(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+            }
+            for (auto id : timerIds) {
+                SentMessage sm;
+                sm.header.timer_id = id;
+                batch.push_back(sm);
+            }
+        };
+    }
+};
+
+TEST_F(PollingWheelTest, FiresPeriodically_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    int source = wheel.addSource(makeHandler(fired));
+    wheel.schedule(source, 1, 20ms);
+    ctx.run_for(210ms);
+    EXPECT_GE(fired.size(), 9);
+    EXPECT_LE(fired.size(), 11);
+}
+
+TEST_F(PollingWheelTest, CoincidingTimersShareWakeUp_Test)
+{
+    std::vector<std::vector<uint16_t>> fired, otherFired;
+    int source = wheel.addSource(makeHandler(fired));
+    int other = wheel.addSource(makeHandler(otherFired));
+    wheel.schedule(source, 1, 20ms);
+    wheel.schedule(source, 2, 40ms);
+    wheel.schedule(other, 3, 40ms);
+    ctx.run_for(205ms);
+
+    // every 40ms deadline is also a 20ms deadline, so both periods are served by the same wake-ups
+    ASSERT_FALSE(batches.empty());
+    EXPECT_EQ(fired.size(), batches.size());
+    size_t sharedBatches = 0;
+    for (auto& batch : batches) {
+        if (batch.size() == 3) {
+            sharedBatches++;
+        }
+    }
+    EXPECT_GE(sharedBatches, 4);
+    EXPECT_EQ(otherFired.size(), sharedBatches);
+}
+
+TEST_F(PollingWheelTest, NoDrift_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    std::vector<std::chrono::milliseconds> times;
+    int source = wheel.addSource(makeHandler(fired, &times));
+    wheel.schedule(source, 1, 30ms);
+    ctx.run_for(620ms);
+
+    // deadlines stay on multiples of the period from the first firing, however late each wake-up was
+    ASSERT_GE(times.size(), 10);
+    auto first = times.front();
+    for (size_t i = 1; i < times.size(); i++) {
+        auto expected = first + 30ms * static_cast<int>(i);
+        EXPECT_LT(std::chrono::abs(times.at(i) - expected), 10ms);
+    }
+}
+
+TEST_F(PollingWheelTest, LongPeriodCascades_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    int source = wheel.addSource(makeHandler(fired));
+    wheel.schedule(source, 1, 700ms);
+    ctx.run_for(1450ms);
+    EXPECT_EQ(fired.size(), 2);
+}
+
+TEST_F(PollingWheelTest, ShorterPeriodAppliesImmediately_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    int source = wheel.addSource(makeHandler(fired));
+    wheel.schedule(source, 1, 1000ms);
+    ctx.run_for(50ms);
+    wheel.setPeriod(source, 1, 20ms);
+    ctx.run_for(110ms);
+    EXPECT_GE(fired.size(), 4);
+}
+
+TEST_F(PollingWheelTest, RemovedSource_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    int source = wheel.addSource(makeHandler(fired));
+    wheel.schedule(source, 1, 20ms);
+    ctx.run_for(50ms);
+    auto firedBefore = fired.size();
+    wheel.removeSource(source);
+    ctx.run_for(100ms);
+    EXPECT_EQ(fired.size(), firedBefore);
+}
+
+TEST_F(PollingWheelTest, Signal_Test)
+{
+    std::vector<std::vector<uint16_t>> fired;
+    int source = wheel.addSource(makeHandler(fired));
+    wheel.signal(source, {4, 5});
+    ctx.run_for(20ms);
+    ASSERT_EQ(fired.size(), 1);
+    EXPECT_EQ(fired.front(), (std::vector<uint16_t>{4, 5}));
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches.front().size(), 2);
+}
@@ -0,0 +1,117 @@
+#include "DeviceUtil.hpp"
+#include "DynamicMessage.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class ProcessExclusionTest : public ::testing::Test
+{
+protected:
+    std::unordered_map<std::string, std::string> config;
+    DeviceHandle handle{TYPE::PWM_LED, config, nullptr, true};
+    std::mutex pauseMutex;
+    std::vector<bool> pauses;
+    std::promise<void> paused;
+
+    void SetUp() override {
+        // Stands in for the interruptor, records when message processing pauses the watchers
+        std::unique_lock lk(handle.m);
+        handle.setWatchersPaused = [this](bool pause) {
+            std::scoped_lock plk(pauseMutex);
+            pauses.push_back(pause);
+            if (pauses.size() == 1) {
+                paused.set_value();
+            }
+        };
+        handle.watchersPaused = false;
+    }
+
+    std::future<void> processAsync(int intensity) {
+        TypeDef::PWM_LED states{};
+        states.intensity = intensity;
+        DynamicMessage dmsg;
+        dmsg.packStates(states);
+        return std::async(std::launch::async, [this, dmsg]() { handle.processStates(dmsg); });
+    }
+
+    int transmittedIntensity() {
+        DynamicMessage dmsg;
+        handle.transmitStates(dmsg);
+        TypeDef::PWM_LED states{};
+        dmsg.unpackStates(states);
+        return states.intensity;
+    }
+};
+
+// An interrupt posted before the pause is still transmitting when the message arrives
+TEST_F(ProcessExclusionTest, AllWaitsForPostedInterrupt_Test)
+{
+    handle.exclusion = ProcessExclusion::ALL;
+    std::unique_lock transmitting(handle.transmitMutex);
+    auto processed = processAsync(42);
+
+    ASSERT_EQ(paused.get_future().wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(processed.wait_for(50ms), std::future_status::timeout);
+
+    transmitting.unlock();
+    ASSERT_EQ(processed.wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(transmittedIntensity(), 42);
+    std::scoped_lock plk(pauseMutex);
+    EXPECT_EQ(pauses, (std::vector<bool>{true, false}));
+}
+
+TEST_F(ProcessExclusionTest, TransmitWaitsForTransmit_Test)
+{
+    handle.exclusion = ProcessExclusion::TRANSMIT;
+    std::unique_lock transmitting(handle.transmitMutex);
+    auto processed = processAsync(7);
+    EXPECT_EQ(processed.wait_for(50ms), std::future_status::timeout);
+
+    transmitting.unlock();
+    ASSERT_EQ(processed.wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(transmittedIntensity(), 7);
+    // watchers keep running
+    std::scoped_lock plk(pauseMutex);
+    EXPECT_TRUE(pauses.empty());
+}
+
+TEST_F(ProcessExclusionTest, NoneSkipsExclusion_Test)
+{
+    handle.exclusion = ProcessExclusion::NONE;
+    std::unique_lock transmitting(handle.transmitMutex);
+    auto processed = processAsync(3);
+    ASSERT_EQ(processed.wait_for(1s), std::future_status::ready);
+
+    transmitting.unlock();
+    EXPECT_EQ(transmittedIntensity(), 3);
+    std::scoped_lock plk(pauseMutex);
+    EXPECT_TRUE(pauses.empty());
+}
+
+// Interrupts keep transmitting from another thread while messages are processed
+TEST_F(ProcessExclusionTest, AllExcludesConcurrentInterrupts_Test)
+{
+    handle.exclusion = ProcessExclusion::ALL;
+    processAsync(0).get();
+    std::atomic<bool> done = false;
+    auto interrupts = std::async(std::launch::async, [this, &done]() {
+        while (!done) {
+            int intensity = transmittedIntensity();
+            EXPECT_GE(intensity, 0);
+            EXPECT_LT(intensity, 200);
+        }
+    });
+    for (int i = 1; i < 200; i++) {
+        processAsync(i).get();
+    }
+    done = true;
+    interrupts.get();
+    EXPECT_EQ(transmittedIntensity(), 199);
+}
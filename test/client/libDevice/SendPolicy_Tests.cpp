@@ -0,0 +1,84 @@
+#include "SendPolicy.hpp"
+#include "Connection.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+
+class SendPolicyTest : public ::testing::Test
+{
+protected:
+    SendPolicy::LastSent last;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    DynamicMessage makeStates(double temperature, int64_t count, std::string label = "idle") {
+        DynamicMessage dmsg;
+        dmsg.createField("temperature", temperature);
+        dmsg.createField("count", count);
+        dmsg.createField("label", label);
+        return dmsg;
+    }
+
+    using Config = std::unordered_map<std::string, std::string>;
+
+    bool send(SendPolicy& policy, DynamicMessage states, std::chrono::milliseconds elapsed = 0ms) {
+        return policy.shouldSend(states, last, start + elapsed);
+    }
+};
+
+TEST_F(SendPolicyTest, AlwaysByDefault_Test)
+{
+    SendPolicy policy(Config{});
+    EXPECT_TRUE(send(policy, makeStates(20, 1)));
+    EXPECT_TRUE(send(policy, makeStates(20, 1)));
+}
+
+TEST_F(SendPolicyTest, OnlyOnChange_Test)
+{
+    SendPolicy policy(Config{{"send", "change"}});
+    EXPECT_TRUE(send(policy, makeStates(20, 1)));
+    EXPECT_FALSE(send(policy, makeStates(20, 1)));
+    EXPECT_TRUE(send(policy, makeStates(20.5, 1)));
+    EXPECT_TRUE(send(policy, makeStates(20.5, 2)));
+    EXPECT_TRUE(send(policy, makeStates(20.5, 2, "busy")));
+    EXPECT_FALSE(send(policy, makeStates(20.5, 2, "busy")));
+}
+
+TEST_F(SendPolicyTest, AbsoluteDeadband_Test)
+{
+    SendPolicy policy(Config{{"deadband", "0.5"}});
+    EXPECT_TRUE(send(policy, makeStates(20, 1)));
+    EXPECT_FALSE(send(policy, makeStates(20.3, 1)));
+    // drift is measured from the last value sent
+    EXPECT_TRUE(send(policy, makeStates(20.6, 1)));
+    EXPECT_FALSE(send(policy, makeStates(20.6, 1, "idle")));
+    EXPECT_TRUE(send(policy, makeStates(20.6, 1, "busy")));
+}
+
+TEST_F(SendPolicyTest, AttributeDeadbands_Test)
+{
+    SendPolicy policy(Config{{"deadband", "temperature:10%;count:5"}});
+    EXPECT_TRUE(send(policy, makeStates(20, 10)));
+    EXPECT_FALSE(send(policy, makeStates(21.5, 14)));
+    EXPECT_TRUE(send(policy, makeStates(22.5, 14)));
+    EXPECT_TRUE(send(policy, makeStates(22.5, 20)));
+}
+
+TEST_F(SendPolicyTest, Heartbeat_Test)
+{
+    SendPolicy policy(Config{{"send", "change"}, {"heartbeat", "1000"}});
+    EXPECT_TRUE(send(policy, makeStates(20, 1)));
+    EXPECT_FALSE(send(policy, makeStates(20, 1), 500ms));
+    EXPECT_TRUE(send(policy, makeStates(20, 1), 1000ms));
+    EXPECT_FALSE(send(policy, makeStates(20, 1), 1500ms));
+}
+
+TEST_F(SendPolicyTest, InvalidOptions_Test)
+{
+    EXPECT_THROW(SendPolicy(Config{{"send", "sometimes"}}), BlsExceptionClass);
+    EXPECT_THROW(SendPolicy(Config{{"deadband", "temperature:abc"}}), BlsExceptionClass);
+    EXPECT_THROW(SendPolicy(Config{{"heartbeat", "soon"}}), BlsExceptionClass);
+}
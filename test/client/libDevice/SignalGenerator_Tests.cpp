@@ -0,0 +1,84 @@
+#include "SignalGenerator.hpp"
+#include "Connection.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+
+class SignalGeneratorTest : public ::testing::Test
+{
+protected:
+    using Config = std::unordered_map<std::string, std::string>;
+};
+
+TEST_F(SignalGeneratorTest, StaysInBounds_Test)
+{
+    for (std::string wave : {"sine", "saw", "random", "walk"}) {
+        SignalGenerator generator(Config{{"sim", wave}, {"sim_min", "10"}, {"sim_max", "20"}, {"sim_period", "100"}});
+        for (int i = 0; i < 500; i++) {
+            double value = 0;
+            generator.fill("temperature", value, std::chrono::milliseconds(i * 7));
+            EXPECT_GE(value, 10) << wave;
+            EXPECT_LE(value, 20) << wave;
+        }
+    }
+}
+
+TEST_F(SignalGeneratorTest, SquareWave_Test)
+{
+    SignalGenerator generator(Config{{"sim", "square"}, {"sim_min", "0"}, {"sim_max", "1"}, {"sim_period", "100"}});
+    double first = -1;
+    double second = -1;
+    generator.fill("level", first, 0ms);
+    generator.fill("level", second, 50ms);
+    EXPECT_NE(first, second);
+    double repeat = -1;
+    generator.fill("level", repeat, 100ms);
+    EXPECT_EQ(first, repeat);
+
+    // booleans follow the midpoint of the range
+    bool on = false;
+    bool later = false;
+    generator.fill("level", on, 0ms);
+    generator.fill("level", later, 50ms);
+    EXPECT_EQ(on, first == 1);
+    EXPECT_EQ(later, second == 1);
+}
+
+TEST_F(SignalGeneratorTest, SeedIsReproducible_Test)
+{
+    Config config{{"sim", "random"}, {"sim_seed", "42"}, {"sim_rate", "20"}};
+    SignalGenerator a(config);
+    SignalGenerator b(config);
+    for (int i = 0; i < 20; i++) {
+        int64_t valueA = 0;
+        int64_t valueB = 0;
+        a.fill("count", valueA, 0ms);
+        b.fill("count", valueB, 0ms);
+        EXPECT_EQ(valueA, valueB);
+        EXPECT_EQ(a.nextEvent(), b.nextEvent());
+    }
+}
+
+TEST_F(SignalGeneratorTest, EventRate_Test)
+{
+    SignalGenerator generator(Config{{"sim_rate", "100"}, {"sim_seed", "7"}});
+    std::chrono::milliseconds total = 0ms;
+    for (int i = 0; i < 1000; i++) {
+        total += generator.nextEvent();
+    }
+    // poisson arrivals at 100hz average 10ms apart
+    EXPECT_NEAR(total.count() / 1000.0, 10, 1.5);
+}
+
+TEST_F(SignalGeneratorTest, BadConfig_Test)
+{
+    EXPECT_THROW(SignalGenerator(Config{{"sim", "triangle"}}), BlsExceptionClass);
+    EXPECT_THROW(SignalGenerator(Config{{"sim_period", "fast"}}), BlsExceptionClass);
+    EXPECT_THROW(SignalGenerator(Config{{"sim_min", "10"}, {"sim_max", "5"}}), BlsExceptionClass);
+    EXPECT_THROW(SignalGenerator(Config{{"sim", "trace"}}), BlsExceptionClass);
+    EXPECT_THROW(SignalGenerator(Config{{"sim_trace", "missing_trace.csv"}}), BlsExceptionClass);
+}
@@ -0,0 +1,57 @@
+#include "DeviceUtil.hpp"
+#include "DynamicMessage.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+class SimulatedDeviceTest : public ::testing::Test
+{
+protected:
+    std::unordered_map<std::string, std::string> config{{"sim", "random"}, {"sim_min", "0"}, {"sim_max", "100"}};
+    DeviceHandle handle{TYPE::MOUSE, config, nullptr, true};
+
+    TypeDef::MOUSE transmitted() {
+        DynamicMessage dmsg;
+        handle.transmitStates(dmsg);
+        TypeDef::MOUSE states{};
+        dmsg.unpackStates(states);
+        return states;
+    }
+};
+
+// The interrupt watcher samples on the client context while states are sent and written elsewhere
+TEST_F(SimulatedDeviceTest, InterruptSamplesWhileTransmitting_Test)
+{
+    auto& idescList = handle.getIdescList();
+    ASSERT_EQ(idescList.size(), 1);
+    auto* interruptor = std::get_if<SimulatedInterruptor>(&idescList.front());
+    ASSERT_NE(interruptor, nullptr);
+
+    std::atomic<bool> done = false;
+    auto interrupts = std::async(std::launch::async, [interruptor, &done]() {
+        while (!done) {
+            interruptor->interruptCallback();
+        }
+    });
+    auto writes = std::async(std::launch::async, [this, &done]() {
+        TypeDef::MOUSE states{};
+        states.x = 50;
+        states.y = 50;
+        while (!done) {
+            DynamicMessage dmsg;
+            dmsg.packStates(states);
+            handle.processStates(dmsg);
+        }
+    });
+    for (int i = 0; i < 500; i++) {
+        auto states = transmitted();
+        EXPECT_GE(states.x, 0);
+        EXPECT_LE(states.x, 100);
+    }
+    done = true;
+    interrupts.get();
+    writes.get();
+}
@@ -0,0 +1,141 @@
+#include "Executor.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <thread>
+#include <vector>
+
+// Test that every submitted job runs before the pool is destroyed
+TEST(ExecutorTest, RunsAllJobs)
+{
+    std::atomic<int> counter = 0;
+    {
+        WorkStealingPool pool(4);
+        for (int i = 0; i < 1000; i++) {
+            pool.submit([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(counter, 1000);
+}
+
+// Test that jobs submitted from a worker are still executed
+TEST(ExecutorTest, NestedSubmit)
+{
+    std::atomic<int> counter = 0;
+    std::latch done(100);
+    WorkStealingPool pool(2);
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&]() {
+            for (int j = 0; j < 10; j++) {
+                pool.submit([&]() { counter++; done.count_down(); });
+            }
+        });
+    }
+    done.wait();
+    EXPECT_EQ(counter, 100);
+}
+
+// Test that idle workers steal from a worker blocked on a long job
+TEST(ExecutorTest, IdleWorkersSteal)
+{
+    WorkStealingPool pool(2);
+    std::latch release(1);
+    std::latch stolen(1);
+    std::atomic<std::thread::id> blockedId;
+    std::atomic<std::thread::id> thiefId;
+
+    pool.submit([&]() {
+        blockedId = std::this_thread::get_id();
+        // Queue behind this job on the same worker and wait for someone else to run it
+        pool.submit([&]() { thiefId = std::this_thread::get_id(); stolen.count_down(); });
+        stolen.wait();
+        release.count_down();
+    });
+
+    release.wait();
+    EXPECT_NE(blockedId.load(), thiefId.load());
+}
+
+// Test that a pool constructed with zero threads still makes progress
+TEST(ExecutorTest, ZeroThreadsClampsToOne)
+{
+    WorkStealingPool pool(0);
+    EXPECT_EQ(pool.size(), 1);
+    std::latch done(1);
+    pool.submit([&]() { done.count_down(); });
+    done.wait();
+}
+
+// Test that a job blocked on a later job does not stall a single worker pool
+TEST(ExecutorTest, BlockedWorkerIsReplaced)
+{
+    WorkStealingPool pool(1);
+    std::latch produced(1);
+    std::latch done(1);
+
+    size_t blockedCount = 0;
+
+    pool.submit([&]() {
+        pool.submit([&]() { produced.count_down(); });
+        WorkStealingPool::blockOn([&]() {
+            produced.wait();
+            blockedCount = pool.threadCount();
+        });
+        done.count_down();
+    });
+
+    done.wait();
+    EXPECT_EQ(blockedCount, 2);
+}
+
+// Test that the spare retires once the blocked worker resumes
+TEST(ExecutorTest, SparesRetireAfterBlocking)
+{
+    WorkStealingPool pool(1);
+    std::latch done(1);
+    pool.submit([&]() {
+        WorkStealingPool::blockOn([]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+        done.count_down();
+    });
+    done.wait();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (pool.threadCount() > 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(pool.threadCount(), 1);
+
+    // A retired spare is replaced on the next blocking wait
+    std::latch produced(1);
+    std::latch again(1);
+    pool.submit([&]() {
+        pool.submit([&]() { produced.count_down(); });
+        WorkStealingPool::blockOn([&]() { produced.wait(); });
+        again.count_down();
+    });
+    again.wait();
+}
+
+// Test that spares are reused instead of started for every blocking wait
+TEST(ExecutorTest, SparesAreReused)
+{
+    WorkStealingPool pool(2);
+    for (int round = 0; round < 20; round++) {
+        std::latch done(1);
+        pool.submit([&]() {
+            WorkStealingPool::blockOn([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+            done.count_down();
+        });
+        done.wait();
+    }
+    EXPECT_LE(pool.threadCount(), 3);
+}
+
+// Test that blockOn outside a pool only runs the wait
+TEST(ExecutorTest, BlockOnOutsidePool)
+{
+    bool ran = false;
+    WorkStealingPool::blockOn([&]() { ran = true; });
+    EXPECT_TRUE(ran);
+}
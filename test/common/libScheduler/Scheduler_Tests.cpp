@@ -0,0 +1,138 @@
+#include "Scheduler.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class SchedulerTest : public ::testing::Test
+{
+protected:
+    std::mutex sentMutex;
+    std::vector<HeapMasterMessage> sent;
+    std::vector<TaskDescriptor> tasks;
+
+    void SetUp() override {
+        // "led" has a single writer, "motor" is written by two tasks
+        tasks.push_back(task("blink", {"led"}));
+        tasks.push_back(task("forward", {"motor"}));
+        tasks.push_back(task("reverse", {"motor"}));
+    }
+
+    static TaskDescriptor task(const std::string& name, const std::vector<std::string>& outDevices) {
+        TaskDescriptor desc;
+        desc.name = name;
+        for (auto& device : outDevices) {
+            DeviceDescriptor dev;
+            dev.device_name = device;
+            dev.controller = "CTL";
+            desc.outDevices.push_back(dev);
+        }
+        return desc;
+    }
+
+    DeviceScheduler makeScheduler(bool leases) {
+        return DeviceScheduler(tasks, [this](HeapMasterMessage hmm) {
+            std::scoped_lock lk(sentMutex);
+            sent.push_back(hmm);
+        }, leases);
+    }
+
+    std::vector<PROTOCOLS> takeProtocols() {
+        std::scoped_lock lk(sentMutex);
+        std::vector<PROTOCOLS> protocols;
+        for (auto& hmm : sent) {
+            protocols.push_back(hmm.protocol);
+        }
+        sent.clear();
+        return protocols;
+    }
+
+    // Waits until the scheduler sent count messages
+    void waitSent(size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + 1s;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::scoped_lock lk(sentMutex);
+                if (sent.size() >= count) return;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    static HeapMasterMessage reply(const std::string& task, const std::string& device, PROTOCOLS protocol) {
+        HeapMasterMessage hmm;
+        hmm.info.task = task;
+        hmm.info.device = device;
+        hmm.protocol = protocol;
+        return hmm;
+    }
+};
+
+// Without leases even a sole writer runs the ownership protocol
+TEST_F(SchedulerTest, LeasesOffByDefault_Test)
+{
+    auto scheduler = makeScheduler(false);
+    scheduler.grantLeases();
+    EXPECT_TRUE(takeProtocols().empty());
+
+    TaskID blink = "blink";
+    auto requested = std::async(std::launch::async, [&]() { scheduler.request(blink, 0); });
+    waitSent(2);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_CANDIDATE_REQUEST, PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE}));
+
+    auto grant = reply("blink", "led", PROTOCOLS::OWNER_GRANT);
+    scheduler.receive(grant);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_CONFIRM}));
+    auto confirmed = reply("blink", "led", PROTOCOLS::OWNER_CONFIRM_OK);
+    scheduler.receive(confirmed);
+    ASSERT_EQ(requested.wait_for(1s), std::future_status::ready);
+
+    scheduler.release(blink);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_RELEASE}));
+}
+
+TEST_F(SchedulerTest, SoleWriterIsLeased_Test)
+{
+    auto scheduler = makeScheduler(true);
+    scheduler.grantLeases();
+    {
+        std::scoped_lock lk(sentMutex);
+        ASSERT_EQ(sent.size(), 1u);
+        EXPECT_EQ(sent[0].protocol, PROTOCOLS::OWNER_LEASE);
+        EXPECT_EQ(sent[0].info.task, "blink");
+        EXPECT_EQ(sent[0].info.device, "led");
+        EXPECT_EQ(sent[0].info.controller, "CTL");
+        sent.clear();
+    }
+
+    // The leased device is no longer requested or released per execution
+    TaskID blink = "blink";
+    scheduler.request(blink, 0);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE}));
+    scheduler.release(blink);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_RELEASE_NULL}));
+}
+
+TEST_F(SchedulerTest, SharedDeviceIsNotLeased_Test)
+{
+    auto scheduler = makeScheduler(true);
+    TaskID forward = "forward";
+    auto requested = std::async(std::launch::async, [&]() { scheduler.request(forward, 0); });
+    waitSent(2);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_CANDIDATE_REQUEST, PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE}));
+
+    auto grant = reply("forward", "motor", PROTOCOLS::OWNER_GRANT);
+    scheduler.receive(grant);
+    auto confirmed = reply("forward", "motor", PROTOCOLS::OWNER_CONFIRM_OK);
+    scheduler.receive(confirmed);
+    ASSERT_EQ(requested.wait_for(1s), std::future_status::ready);
+    takeProtocols();
+
+    scheduler.release(forward);
+    EXPECT_EQ(takeProtocols(), (std::vector<PROTOCOLS>{PROTOCOLS::OWNER_RELEASE}));
+}
@@ -0,0 +1,85 @@
+#include "LatencyTrace.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+class LatencyTraceTest : public ::testing::Test
+{
+protected:
+    LatencyTracer& tracer = LatencyTracer::instance();
+
+    void SetUp() override {
+        tracer.enable();
+        tracer.reset();
+    }
+};
+
+TEST_F(LatencyTraceTest, HistogramQuantiles_Test)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.getQuantileUs(0.5), 0);
+    for (int i = 0; i < 90; i++) {
+        histogram.add(10'000); // 10us
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.add(5'000'000); // 5ms
+    }
+    EXPECT_EQ(histogram.getCount(), 100);
+    EXPECT_NEAR(histogram.getMeanUs(), 509, 1);
+    EXPECT_EQ(histogram.getMaxUs(), 5000);
+    // quantiles report the upper bound of their power of two bucket
+    EXPECT_EQ(histogram.getQuantileUs(0.5), 15);
+    EXPECT_EQ(histogram.getQuantileUs(0.9), 15);
+    EXPECT_EQ(histogram.getQuantileUs(0.99), 5000);
+}
+
+TEST_F(LatencyTraceTest, InactiveTraceIsIgnored_Test)
+{
+    TraceContext trace;
+    tracer.record(trace, TraceStage::VM_EXEC);
+    tracer.finish(trace, TraceStage::CLIENT_WRITE);
+    EXPECT_EQ(tracer.getHistogram(TraceStage::VM_EXEC).getCount(), 0);
+    EXPECT_EQ(tracer.getHistogram(TraceStage::END_TO_END).getCount(), 0);
+}
+
+TEST_F(LatencyTraceTest, StagesAddUpToEndToEnd_Test)
+{
+    auto trace = tracer.begin();
+    ASSERT_TRUE(trace.active());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    tracer.record(trace, TraceStage::CLIENT_READ);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    tracer.finish(trace, TraceStage::CLIENT_WRITE);
+
+    auto& read = tracer.getHistogram(TraceStage::CLIENT_READ);
+    auto& write = tracer.getHistogram(TraceStage::CLIENT_WRITE);
+    auto& total = tracer.getHistogram(TraceStage::END_TO_END);
+    ASSERT_EQ(total.getCount(), 1);
+    EXPECT_GE(read.getMaxUs(), 2000);
+    EXPECT_GE(write.getMaxUs(), 3000);
+    EXPECT_EQ(total.getMaxUs(), (trace.stamp - trace.origin) / 1000);
+    EXPECT_NEAR(total.getMaxUs(), read.getMaxUs() + write.getMaxUs(), 2);
+
+    std::stringstream out;
+    tracer.dump(out, "test");
+    EXPECT_NE(out.str().find("end to end"), std::string::npos);
+    EXPECT_EQ(out.str().find("vm execution"), std::string::npos);
+}
+
+TEST_F(LatencyTraceTest, ConcurrentRecording_Test)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([this]() {
+            for (int i = 0; i < 1000; i++) {
+                auto trace = tracer.begin();
+                tracer.record(trace, TraceStage::SCHEDULER);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(tracer.getHistogram(TraceStage::SCHEDULER).getCount(), 4000);
+}
@@ -0,0 +1,110 @@
+#include "Connection.hpp"
+#include "Protocol.hpp"
+#include "TSQ.hpp"
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ConnectionTest : public ::testing::Test
+{
+protected:
+    boost::asio::io_context ctx;
+    TSQ<OwnedSentMessage> in_queue;
+    tcp::socket reader{ctx};
+    std::shared_ptr<Connection> connection;
+
+    void SetUp() override {
+        tcp::acceptor acceptor(ctx, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        tcp::socket accepted(ctx);
+        reader.connect(acceptor.local_endpoint());
+        acceptor.accept(accepted);
+        std::string ip = "127.0.0.1";
+        connection = std::make_shared<Connection>(ctx, std::move(accepted), Owner::MASTER, in_queue, ip);
+    }
+
+    // Every byte of the body identifies the message so interleaved writes show up as mixed bodies
+    static SentMessage makeMessage(uint8_t id, size_t size) {
+        SentMessage sm;
+        sm.header.device_code = id;
+        sm.body.assign(size, static_cast<char>(id));
+        sm.header.body_size = sm.body.size();
+        return sm;
+    }
+
+    SentMessage readMessage() {
+        SentMessage sm;
+        boost::asio::read(reader, boost::asio::buffer(&sm.header, sizeof(SentHeader)));
+        sm.body.resize(sm.header.body_size);
+        boost::asio::read(reader, boost::asio::buffer(sm.body.data(), sm.body.size()));
+        return sm;
+    }
+};
+
+TEST_F(ConnectionTest, SendsAndBatchesNeverInterleave)
+{
+    constexpr int SENDERS = 4;
+    constexpr int ROUNDS = 50;
+    constexpr size_t BODY_SIZE = 64 * 1024;
+    auto guard = boost::asio::make_work_guard(ctx);
+    std::vector<std::thread> runners;
+    for (int i = 0; i < 2; i++) {
+        runners.emplace_back([this]() { ctx.run(); });
+    }
+
+    std::vector<std::thread> senders;
+    for (int s = 0; s < SENDERS; s++) {
+        senders.emplace_back([this, s]() {
+            for (int r = 0; r < ROUNDS; r++) {
+                if (s % 2 == 0) {
+                    connection->send(makeMessage(s, BODY_SIZE));
+                }
+                else {
+                    connection->sendBatch({makeMessage(s, BODY_SIZE), makeMessage(s, BODY_SIZE / 2)});
+                }
+            }
+        });
+    }
+
+    size_t expected = (SENDERS / 2) * ROUNDS + (SENDERS / 2) * ROUNDS * 2;
+    for (size_t i = 0; i < expected; i++) {
+        auto sm = readMessage();
+        ASSERT_FALSE(sm.body.empty());
+        auto id = static_cast<char>(sm.header.device_code);
+        EXPECT_EQ(std::count(sm.body.begin(), sm.body.end(), id), sm.body.size());
+    }
+
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    guard.reset();
+    ctx.stop();
+    for (auto& runner : runners) {
+        runner.join();
+    }
+}
+
+TEST_F(ConnectionTest, BatchKeepsOrder)
+{
+    connection->sendBatch({makeMessage(1, 16), makeMessage(2, 16), makeMessage(3, 16)});
+    connection->send(makeMessage(4, 16));
+    ctx.run();
+    for (uint8_t id = 1; id <= 4; id++) {
+        EXPECT_EQ(readMessage().header.device_code, id);
+    }
+}
+
+TEST_F(ConnectionTest, FilteredMessagesAreNotSent)
+{
+    connection->setOutboundFilter([](const SentMessage& sm) { return sm.header.device_code != 2; });
+    connection->sendBatch({makeMessage(1, 16), makeMessage(2, 16)});
+    connection->send(makeMessage(2, 16));
+    connection->send(makeMessage(3, 16));
+    ctx.run();
+    EXPECT_EQ(readMessage().header.device_code, 1);
+    EXPECT_EQ(readMessage().header.device_code, 3);
+}
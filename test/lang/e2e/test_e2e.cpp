@@ -2,10 +2,19 @@
 #include "fixtures/e2e_test.hpp"
 #include "typedefs.hpp"
 #include "test_macros.hpp"
+#include "program_diff.hpp"
+#include "compile_cache.hpp"
+#include "task_fusion.hpp"
+#include "task_distribution.hpp"
+#include "bytecode_interpreter.hpp"
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace BlsLang {
@@ -120,4 +129,499 @@ namespace BlsLang {
         TEST_E2E_TASK("testShortCircuit", {T1}, {T1}, expectedStdout);
     }
 
+    GROUP_TEST_F(E2ETest, ExecutionTests, WideOperands) {
+        // over 256 locals and literals, and a branch body long enough to push targets past 16 bit addresses
+        std::string source = "int pad(int value) {\n";
+        for (int i = 0; i < 300; i++) {
+            source += "int v" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+        }
+        source += "if (value > 0) {\n";
+        for (int i = 0; i < 17000; i++) {
+            source += "value = value + 1;\n";
+        }
+        source += "} else {\nvalue = value - 1;\n}\nreturn value + v299;\n}\n";
+        // linked after pad, so calling it needs a wide call
+        source += R"(
+            int far(int value) {
+                return value * 2;
+            }
+
+            task wide(int result) {
+                result = far(pad(result));
+            }
+
+            setup() {
+                virtual int result = 0;
+                wide(result);
+            }
+        )";
+        TEST_E2E_SOURCE(source);
+        TEST_E2E_TASK("wide", {0}, {(-1 + 299) * 2}, "");
+        TEST_E2E_TASK("wide", {1}, {(1 + 17000 + 299) * 2}, "");
+    }
+
+    GROUP_TEST_F(E2ETest, ReloadTests, OnlyEditedTasksChange) {
+        const std::string original = R"(
+            task increment(int value) {
+                value = value + 1;
+            }
+
+            task decrement(int value) {
+                value = value - 1;
+            }
+
+            setup() {
+                virtual int value = 0;
+                increment(value);
+                decrement(value);
+            }
+        )";
+        const std::string edited = R"(
+            task increment(int value) {
+                value = value + 2;
+            }
+
+            // reformatting alone is not an edit
+            task decrement(int value) { value = value - 1; }
+
+            setup() {
+                virtual int value = 0;
+                increment(value);
+                decrement(value);
+            }
+        )";
+        Compiler originalCompiler, editedCompiler;
+        originalCompiler.setFingerprinting(true);
+        editedCompiler.setFingerprinting(true);
+        std::vector<char> originalBytecode, editedBytecode;
+        originalCompiler.compileSource(original, originalBytecode);
+        editedCompiler.compileSource(edited, editedBytecode);
+
+        auto changes = diffPrograms(originalCompiler.getTaskDescriptors(), originalCompiler.getTaskFingerprints()
+                                  , editedCompiler.getTaskDescriptors(), editedCompiler.getTaskFingerprints());
+        ASSERT_EQ(changes.size(), 1);
+        EXPECT_EQ(changes.at(0).task, "increment");
+        EXPECT_TRUE(changes.at(0).codeChanged);
+        EXPECT_FALSE(changes.at(0).triggersChanged);
+        EXPECT_FALSE(changes.at(0).requiresRestart);
+
+        TEST_E2E_SOURCE(edited);
+        TEST_E2E_TASK("increment", {0}, {2}, "");
+        TEST_E2E_TASK("decrement", {0}, {-1}, "");
+    }
+
+    GROUP_TEST_F(E2ETest, ReloadTests, PolicyEditsAreReloaded) {
+        const std::string source = R"(
+            task increment(int value) {
+                value = value + 1;
+            }
+
+            setup() {
+                virtual int value = 0;
+                increment(value);
+            }
+        )";
+        Compiler compiler;
+        compiler.setFingerprinting(true);
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+
+        // The master derives both fields from the dependency graph, so an edit can change them alone
+        auto deferred = compiler.getTaskDescriptors();
+        deferred.at(0).deferOwnership = !deferred.at(0).deferOwnership;
+        auto changes = diffPrograms(compiler.getTaskDescriptors(), compiler.getTaskFingerprints()
+                                  , deferred, compiler.getTaskFingerprints());
+        ASSERT_EQ(changes.size(), 1);
+        EXPECT_TRUE(changes.at(0).policyChanged);
+        EXPECT_FALSE(changes.at(0).codeChanged);
+        EXPECT_FALSE(changes.at(0).requiresRestart);
+
+        auto polled = compiler.getTaskDescriptors();
+        polled.at(0).pollConditions.push_back({"value", "value", 3});
+        changes = diffPrograms(compiler.getTaskDescriptors(), compiler.getTaskFingerprints()
+                             , polled, compiler.getTaskFingerprints());
+        ASSERT_EQ(changes.size(), 1);
+        EXPECT_TRUE(changes.at(0).policyChanged);
+    }
+
+    GROUP_TEST_F(E2ETest, ReloadTests, ProcedureEditsChangeEveryTask) {
+        const std::string original = R"(
+            task increment(int value) {
+                value = step(value);
+            }
+
+            // declared between the tasks, so the token slices interleave
+            int step(int value) {
+                return value + 1;
+            }
+
+            task decrement(int value) {
+                value = value - 1;
+            }
+
+            setup() {
+                virtual int value = 0;
+                increment(value);
+                decrement(value);
+            }
+        )";
+        std::string edited = original;
+        edited.replace(edited.find("value + 1"), 9, "value + 2");
+
+        Compiler plainCompiler, originalCompiler, editedCompiler;
+        originalCompiler.setFingerprinting(true);
+        editedCompiler.setFingerprinting(true);
+        std::vector<char> plainBytecode, originalBytecode, editedBytecode;
+        plainCompiler.compileSource(original, plainBytecode);
+        originalCompiler.compileSource(original, originalBytecode);
+        editedCompiler.compileSource(edited, editedBytecode);
+
+        // Fingerprints are only computed for compiles that diff reloads
+        EXPECT_TRUE(plainCompiler.getTaskFingerprints().empty());
+        auto& originalFingerprints = originalCompiler.getTaskFingerprints();
+        auto& editedFingerprints = editedCompiler.getTaskFingerprints();
+        ASSERT_EQ(originalFingerprints.size(), 2);
+        EXPECT_NE(originalFingerprints.at("increment"), originalFingerprints.at("decrement"));
+        EXPECT_NE(originalFingerprints.at("increment"), editedFingerprints.at("increment"));
+        EXPECT_NE(originalFingerprints.at("decrement"), editedFingerprints.at("decrement"));
+    }
+
+    GROUP_TEST_F(E2ETest, ReloadTests, RebindingRequiresRestart) {
+        const std::string original = R"(
+            task increment(int value) {
+                value = value + 1;
+            }
+
+            setup() {
+                virtual int value = 0;
+                increment(value);
+            }
+        )";
+        const std::string edited = R"(
+            task increment(int value) {
+                value = value + 1;
+            }
+
+            task decrement(int value) {
+                value = value - 1;
+            }
+
+            setup() {
+                virtual int value = 0;
+                virtual int other = 0;
+                increment(other);
+                decrement(value);
+            }
+        )";
+        Compiler originalCompiler, editedCompiler;
+        originalCompiler.setFingerprinting(true);
+        editedCompiler.setFingerprinting(true);
+        std::vector<char> originalBytecode, editedBytecode;
+        originalCompiler.compileSource(original, originalBytecode);
+        editedCompiler.compileSource(edited, editedBytecode);
+
+        auto changes = diffPrograms(originalCompiler.getTaskDescriptors(), originalCompiler.getTaskFingerprints()
+                                  , editedCompiler.getTaskDescriptors(), editedCompiler.getTaskFingerprints());
+        // the rebound task reads as removed and added alongside the new task
+        ASSERT_EQ(changes.size(), 3);
+        for (auto& change : changes) {
+            EXPECT_TRUE(change.requiresRestart) << change.task;
+        }
+    }
+
+    GROUP_TEST_F(E2ETest, CacheTests, UnchangedSourceLoadsFromCache) {
+        const std::string source = {
+            #embed "procedure_calls.blu"
+        };
+        // unique per run, so concurrent test runs never share entries
+        auto cacheDirectory = std::filesystem::temp_directory_path() / ("bls_cache_test_" + std::to_string(std::random_device{}()));
+        std::filesystem::remove_all(cacheDirectory);
+
+        Compiler coldCompiler, warmCompiler;
+        coldCompiler.setCacheDirectory(cacheDirectory);
+        warmCompiler.setCacheDirectory(cacheDirectory);
+        coldCompiler.setFingerprinting(true);
+        warmCompiler.setFingerprinting(true);
+        std::vector<char> coldBytecode, warmBytecode;
+        coldCompiler.compileSource(source, coldBytecode);
+        warmCompiler.compileSource(source, warmBytecode);
+
+        EXPECT_FALSE(coldCompiler.loadedFromCache());
+        EXPECT_TRUE(warmCompiler.loadedFromCache());
+        EXPECT_EQ(coldBytecode, warmBytecode);
+        EXPECT_EQ(coldCompiler.getTaskDescriptors().size(), warmCompiler.getTaskDescriptors().size());
+        EXPECT_EQ(coldCompiler.getTaskFingerprints(), warmCompiler.getTaskFingerprints());
+        EXPECT_NO_THROW(coldCompiler.getAst());
+        EXPECT_THROW(warmCompiler.getAst(), std::runtime_error);
+        EXPECT_THROW(warmCompiler.getTaskContexts(), std::runtime_error);
+        EXPECT_EQ(warmCompiler.getTaskDescriptorMap().at("simpleCall").at(0).get().bytecode_offset
+                , coldCompiler.getTaskDescriptorMap().at("simpleCall").at(0).get().bytecode_offset);
+
+        Compiler editedCompiler;
+        editedCompiler.setCacheDirectory(cacheDirectory);
+        std::vector<char> editedBytecode;
+        editedCompiler.compileSource(source + "\n", editedBytecode);
+        EXPECT_FALSE(editedCompiler.loadedFromCache());
+
+        std::filesystem::remove_all(cacheDirectory);
+    }
+
+    GROUP_TEST_F(E2ETest, ParallelCompileTests, MatchesSequentialBytecode) {
+        const std::vector<std::string> sources = {
+            {
+                #embed "procedure_calls.blu"
+            },
+            {
+                #embed "branches_and_loops.blu"
+            },
+            {
+                #embed "short_circuit.blu"
+            }
+        };
+        for (auto&& source : sources) {
+            Compiler sequentialCompiler, parallelCompiler;
+            parallelCompiler.setCompileThreads(4);
+            std::vector<char> sequentialBytecode, parallelBytecode;
+            sequentialCompiler.compileSource(source, sequentialBytecode);
+            parallelCompiler.compileSource(source, parallelBytecode);
+            EXPECT_EQ(sequentialBytecode, parallelBytecode);
+            EXPECT_EQ(sequentialCompiler.getGlobalContext().taskConnections.size()
+                    , parallelCompiler.getGlobalContext().taskConnections.size());
+        }
+    }
+
+    GROUP_TEST_F(E2ETest, FusionTests, SameTriggerTasksFuse) {
+        const std::string source = R"(
+            task twice(int value, int doubled) : triggerOn(value) {
+                doubled = value * 2;
+            }
+
+            task square(int value, int squared) : triggerOn(value) {
+                squared = value * value;
+            }
+
+            // writes a device the other tasks bind, so it must run on its own
+            task feedback(int value, int doubled) : triggerOn(value) {
+                value = doubled;
+            }
+
+            setup() {
+                virtual int value = 1;
+                virtual int doubled = 0;
+                virtual int squared = 0;
+                twice(value, doubled);
+                square(value, squared);
+                feedback(value, doubled);
+            }
+        )";
+        Compiler compiler;
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+        auto tasks = fuseTasks(compiler.getTaskDescriptors(), compiler.getGlobalContext());
+
+        ASSERT_EQ(tasks.size(), 2);
+        auto& fused = tasks.at(0);
+        EXPECT_EQ(fused.name, "twice+square");
+        ASSERT_EQ(fused.binded_devices.size(), 3);
+        EXPECT_EQ(fused.binded_devices.at(2).device_name, "squared");
+        ASSERT_EQ(fused.fusedTasks.size(), 2);
+        EXPECT_EQ(fused.fusedTasks.at(0).devicePositions, std::vector<uint16_t>({0, 1}));
+        EXPECT_EQ(fused.fusedTasks.at(1).devicePositions, std::vector<uint16_t>({0, 2}));
+        EXPECT_EQ(fused.fusedTasks.at(1).bytecode_offset, compiler.getTaskDescriptorMap().at("square").at(0).get().bytecode_offset);
+        EXPECT_EQ(tasks.at(1).name, "feedback");
+        EXPECT_TRUE(tasks.at(1).fusedTasks.empty());
+    }
+
+    // The analyzer hosts these tasks on CTL, but without distribution they run on the master
+    GROUP_TEST_F(E2ETest, FusionTests, SingleControllerTasksFuse) {
+        const std::string source = R"(
+            task copy(TIMER_TEST sensor, TIMER_TEST lamp) : triggerOn(sensor) {
+                lamp.test_val = sensor.test_val;
+            }
+
+            task negate(TIMER_TEST sensor, TIMER_TEST light) : triggerOn(sensor) {
+                light.test_val = -sensor.test_val;
+            }
+
+            setup() {
+                TIMER_TEST sensor = "CTL::PWR-0";
+                TIMER_TEST lamp = "CTL::PWR-1";
+                TIMER_TEST light = "CTL::PWR-2";
+                copy(sensor, lamp);
+                negate(sensor, light);
+            }
+        )";
+        Compiler compiler;
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+        auto& descriptors = compiler.getTaskDescriptors();
+        ASSERT_EQ(descriptors.size(), 2);
+        EXPECT_EQ(descriptors.at(0).hostController, "CTL");
+        auto tasks = fuseTasks(descriptors, compiler.getGlobalContext());
+
+        ASSERT_EQ(tasks.size(), 1);
+        EXPECT_EQ(tasks.at(0).name, "copy+negate");
+        EXPECT_EQ(tasks.at(0).hostController, "MASTER");
+        EXPECT_EQ(tasks.at(0).fusedTasks.size(), 2);
+    }
+
+    GROUP_TEST_F(E2ETest, DependencyTests, ConditionalWritesDeferOwnership) {
+        const std::string source = R"(
+            task threshold(TIMER_TEST sensor, TIMER_TEST alarm) : triggerOn(sensor) {
+                if (sensor.test_val > 10) {
+                    alarm.test_val = sensor.test_val;
+                }
+            }
+
+            task mirror(TIMER_TEST sensor, TIMER_TEST alarm) : triggerOn(sensor) {
+                alarm.test_val += sensor.test_val;
+            }
+
+            task report(TIMER_TEST sensor, TIMER_TEST alarm) : triggerOn(sensor) {
+                if (sensor.test_val > 10) {
+                    alarm.test_val = 0;
+                    print(sensor.test_val);
+                }
+            }
+
+            setup() {
+                TIMER_TEST sensor = "CTL::PWR-0";
+                TIMER_TEST alarm = "CTL::PWR-1";
+                threshold(sensor, alarm);
+                mirror(sensor, alarm);
+                report(sensor, alarm);
+            }
+        )";
+        Compiler compiler;
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+        auto context = compiler.getGlobalContext();
+        auto& connections = context.taskConnections;
+
+        auto& threshold = connections.at("threshold");
+        EXPECT_EQ(threshold.outDeviceList, std::unordered_set<DeviceID>({"alarm"}));
+        EXPECT_TRUE(threshold.unconditionalOutDevices.empty());
+        EXPECT_FALSE(threshold.hasSideEffects);
+        EXPECT_EQ(threshold.readAttributes.at("sensor"), std::unordered_set<std::string>({"test_val"}));
+        EXPECT_EQ(threshold.writtenAttributes.at("alarm"), std::unordered_set<std::string>({"test_val"}));
+        EXPECT_FALSE(threshold.writtenAttributes.contains("sensor"));
+
+        auto& mirror = connections.at("mirror");
+        EXPECT_EQ(mirror.unconditionalOutDevices, std::unordered_set<DeviceID>({"alarm"}));
+        EXPECT_TRUE(mirror.readAttributes.at("alarm").contains("test_val"));
+        EXPECT_TRUE(mirror.writtenAttributes.at("alarm").contains("test_val"));
+
+        auto& report = connections.at("report");
+        EXPECT_TRUE(report.unconditionalOutDevices.empty());
+        EXPECT_TRUE(report.hasSideEffects);
+    }
+
+    GROUP_TEST_F(E2ETest, DistributionTests, SingleControllerTasksDistribute) {
+        const std::string source = R"(
+            task echo(TIMER_TEST sensor, TIMER_TEST lamp) : triggerOn(sensor) {
+                lamp.test_val = sensor.test_val;
+            }
+
+            // reads a virtual device the master holds
+            task shadow(TIMER_TEST sensor, int copy) : triggerOn(sensor) {
+                copy = sensor.test_val;
+            }
+
+            // shares its written device with a task that has to stay on the master
+            task mirror(TIMER_TEST sensor, TIMER_TEST light) : triggerOn(sensor) {
+                light.test_val = sensor.test_val;
+            }
+
+            task announce(TIMER_TEST sensor, TIMER_TEST light) : triggerOn(sensor) {
+                light.test_val = 0;
+                print(sensor.test_val);
+            }
+
+            setup() {
+                TIMER_TEST sensor = "CTL::PWR-0";
+                TIMER_TEST lamp = "CTL::PWR-1";
+                TIMER_TEST light = "CTL::PWR-2";
+                virtual int copy = 0;
+                echo(sensor, lamp);
+                shadow(sensor, copy);
+                mirror(sensor, light);
+                announce(sensor, light);
+            }
+        )";
+        Compiler compiler;
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+        auto plan = distributeTasks(compiler.getTaskDescriptors(), compiler.getGlobalContext());
+
+        ASSERT_EQ(plan.controllerTasks.size(), 1);
+        auto& localTasks = plan.controllerTasks.at("CTL");
+        ASSERT_EQ(localTasks.size(), 1);
+        EXPECT_EQ(localTasks.at(0).name, "echo");
+
+        std::unordered_set<std::string> masterTasks;
+        for (auto&& task : plan.masterTasks) {
+            masterTasks.insert(task.name);
+        }
+        EXPECT_EQ(masterTasks, std::unordered_set<std::string>({"shadow", "mirror", "announce"}));
+
+        // The controller program only holds its own task, at the offset the plan now points to
+        std::vector<char> slice;
+        compiler.compileSlice(localTasks, slice);
+        EXPECT_LT(slice.size(), bytecode.size());
+        VirtualMachine vm;
+        vm.loadBytecode(slice);
+        vm.setTaskOffset(localTasks.at(0).bytecode_offset);
+        auto sensor = createBlsType(TypeDef::TIMER_TEST());
+        std::get<std::shared_ptr<HeapDescriptor>>(sensor)->access(BlsType("test_val")) = 4.0;
+        auto lamp = createBlsType(TypeDef::TIMER_TEST());
+        auto states = vm.transform({sensor, lamp});
+        EXPECT_EQ(std::get<std::shared_ptr<HeapDescriptor>>(states.at(1))->access(BlsType("test_val")), BlsType(4.0));
+    }
+
+    GROUP_TEST_F(E2ETest, DistributionTests, SharedLocalWritersStayOnMaster) {
+        const std::string source = R"(
+            task raise(TIMER_TEST sensor, TIMER_TEST lamp) : triggerOn(sensor) {
+                lamp.test_val = sensor.test_val;
+            }
+
+            task lower(TIMER_TEST sensor, TIMER_TEST lamp) : triggerOn(sensor) {
+                lamp.test_val = -sensor.test_val;
+            }
+
+            task echo(TIMER_TEST sensor, TIMER_TEST light) : triggerOn(sensor) {
+                light.test_val = sensor.test_val;
+            }
+
+            setup() {
+                TIMER_TEST sensor = "CTL::PWR-0";
+                TIMER_TEST lamp = "CTL::PWR-1";
+                TIMER_TEST light = "CTL::PWR-2";
+                raise(sensor, lamp);
+                lower(sensor, lamp);
+                echo(sensor, light);
+            }
+        )";
+        Compiler compiler;
+        std::vector<char> bytecode;
+        compiler.compileSource(source, bytecode);
+        auto plan = distributeTasks(compiler.getTaskDescriptors(), compiler.getGlobalContext());
+
+        ASSERT_EQ(plan.controllerTasks.at("CTL").size(), 1);
+        EXPECT_EQ(plan.controllerTasks.at("CTL").at(0).name, "echo");
+        ASSERT_EQ(plan.masterTasks.size(), 2);
+        EXPECT_EQ(plan.masterTasks.at(0).name, "raise");
+        EXPECT_EQ(plan.masterTasks.at(1).name, "lower");
+    }
+
+    GROUP_TEST_F(E2ETest, InterpreterTests, RunsBoundTasksOnTheVm) {
+        const std::string source = {
+            #embed "procedure_calls.blu"
+        };
+        BytecodeInterpreter interpreter;
+        interpreter.interpretSource(source);
+        auto& tasks = interpreter.getTasks();
+        ASSERT_EQ(tasks.size(), 2);
+        EXPECT_EQ(tasks.at("simpleCall")({0}), std::vector<BlsType>({8}));
+        EXPECT_EQ(tasks.at("compoundCall")({0}), std::vector<BlsType>({64}));
+    }
 }
\ No newline at end of file
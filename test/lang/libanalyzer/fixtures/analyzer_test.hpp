@@ -19,7 +19,7 @@ namespace BlsLang {
                 Metadata() { }
                 std::unordered_map<std::string, DeviceDescriptor> deviceDescriptors;
                 std::vector<TaskDescriptor> boundTasks;
-                std::unordered_map<BlsType, uint8_t> literalPool;
+                std::unordered_map<BlsType, uint16_t> literalPool;
             };
 
             void TEST_ANALYZE(std::unique_ptr<AstNode>& ast, std::unique_ptr<AstNode>& decoratedAst = defaultAst, Metadata metadata = Metadata(), CallStack<std::string> cs = CallStack<std::string>(CallStack<std::string>::Frame::Context::FUNCTION)) {
@@ -61,6 +61,8 @@ namespace BlsLang {
                     }
                     EXPECT_EQ(desc.hostController, expectedDesc.hostController);
                     EXPECT_EQ(desc.triggers, expectedDesc.triggers);
+                    EXPECT_EQ(desc.coalescePolicy, expectedDesc.coalescePolicy);
+                    EXPECT_EQ(desc.coalesceDepth, expectedDesc.coalesceDepth);
                 };
 
                 auto& deviceDescriptors = analyzer.deviceDescriptors;
@@ -85,6 +87,13 @@ namespace BlsLang {
                 }
             }
 
+            // Simulates earlier code having used count distinct integer literals
+            void fillLiteralPool(size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    analyzer.addToPool(int64_t(i));
+                }
+            }
+
         private:
             Analyzer analyzer;
             Tester tester;
@@ -1677,6 +1677,105 @@ namespace BlsLang {
         TEST_ANALYZE(ast, decoratedAst, expectedMetadata);
     }
 
+    GROUP_TEST_F(AnalyzerTest, ConfigTests, CoalescePolicy) {
+        auto ast = std::unique_ptr<AstNode>(new AstNode::Source(
+            {},
+            {
+                new AstNode::Function::Task(
+                    "foo",
+                    {
+                        new AstNode::Specifier::Type(
+                            DEVTYPE_LINE_WRITER,
+                            {}
+                        )
+                    },
+                    {
+                        "L1"
+                    },
+                    {
+                        new AstNode::Initializer::Task(
+                            "coalescePolicy",
+                            {
+                                new AstNode::Expression::Literal(
+                                    std::string("dropOldest")
+                                ),
+                                new AstNode::Expression::Literal(
+                                    int64_t(4)
+                                )
+                            }
+                        )
+                    },
+                    {}
+                )
+            },
+            new AstNode::Setup(
+                {
+                    new AstNode::Statement::Declaration(
+                        "writer_1",
+                        {},
+                        new AstNode::Specifier::Type(
+                            DEVTYPE_LINE_WRITER,
+                            {}
+                        ),
+                        new AstNode::Expression::Literal(
+                            std::string("host-1::file-f1.txt")
+                        )
+                    ),
+                    new AstNode::Statement::Expression(
+                        new AstNode::Expression::Function(
+                            new AstNode::Expression::Access("foo"),
+                            {
+                                new AstNode::Expression::Access(
+                                    "writer_1"
+                                )
+                            }
+                        )
+                    )
+                }
+            )
+        ));
+        
+        auto decoratedAst = ast.get()->clone();
+
+        Metadata expectedMetadata;
+
+        expectedMetadata.deviceDescriptors = {
+            {"writer_1", DeviceDescriptor{
+                .device_name = "writer_1",
+                .type = TYPE::LINE_WRITER,
+                .controller = "host-1",
+                .port_maps = {
+                    {"file", "f1.txt"}
+                },
+                .initialValue = createBlsType(TypeDef::LINE_WRITER()),
+                .deviceKind = DeviceKind::INTERRUPT
+            }}
+        };
+
+        expectedMetadata.boundTasks = {
+            TaskDescriptor{
+                .name = "foo",
+                .binded_devices = {
+                    DeviceDescriptor{
+                        .device_name = "writer_1",
+                        .type = TYPE::LINE_WRITER,
+                        .controller = "host-1",
+                        .port_maps = {
+                            {"file", "f1.txt"}
+                        },
+                        .initialValue = createBlsType(TypeDef::LINE_WRITER()),
+                        .deviceKind = DeviceKind::INTERRUPT
+                    }
+                },
+                .hostController = "host-1",
+                .coalescePolicy = COALESCE_POLICY::DROP_OLDEST,
+                .coalesceDepth = 4
+            }
+        };
+
+        TEST_ANALYZE(ast, decoratedAst, expectedMetadata);
+    }
+
     GROUP_TEST_F(AnalyzerTest, ConfigTests, InvalidTaskOption) {
         auto ast = std::unique_ptr<AstNode>(new AstNode::Function::Task(
             "foo",
@@ -1789,6 +1888,38 @@ namespace BlsLang {
         EXPECT_THROW(TEST_ANALYZE(ast, decoratedAst, expectedMetadata), SemanticError);
     }
 
+    GROUP_TEST_F(AnalyzerTest, ConfigTests, InvalidCoalescePolicyDepth) {
+        auto ast = std::unique_ptr<AstNode>(new AstNode::Function::Task(
+            "foo",
+            {
+                new AstNode::Specifier::Type(
+                    DEVTYPE_LINE_WRITER,
+                    {}
+                )
+            },
+            {
+                "L1"
+            },
+            {
+                new AstNode::Initializer::Task(
+                    "coalescePolicy",
+                    {
+                        new AstNode::Expression::Literal(
+                            std::string("fifo")
+                        )
+                    }
+                )
+            },
+            {}
+        ));
+    
+        std::unique_ptr<AstNode> decoratedAst = nullptr;
+
+        Metadata expectedMetadata;
+
+        EXPECT_THROW(TEST_ANALYZE(ast, decoratedAst, expectedMetadata), SemanticError);
+    }
+
     GROUP_TEST_F(AnalyzerTest, ConfigTests, DuplicateBinding) {
         auto ast = std::unique_ptr<AstNode>(new AstNode::Source(
             {},
@@ -2061,4 +2192,37 @@ namespace BlsLang {
         TEST_ANALYZE(ast, decoratedAst, expectedMetadata);
     }
 
+    GROUP_TEST_F(AnalyzerTest, LimitTests, TooManyLocals) {
+        auto ast = std::unique_ptr<AstNode>(new AstNode::Statement::Declaration(
+            "x",
+            {},
+            new AstNode::Specifier::Type(
+                PRIMITIVE_INT,
+                {}
+            ),
+            {}
+        ));
+        CallStack<std::string> cs(CallStack<std::string>::Frame::Context::FUNCTION);
+        for (size_t i = 0; i <= UINT16_MAX; i++) {
+            cs.addLocal("local" + std::to_string(i), int64_t(0));
+        }
+        EXPECT_THROW(TEST_ANALYZE(ast, ast, Metadata(), cs), SemanticError);
+    }
+
+    GROUP_TEST_F(AnalyzerTest, LimitTests, TooManyLiterals) {
+        auto ast = std::unique_ptr<AstNode>(new AstNode::Statement::Declaration(
+            "x",
+            {},
+            new AstNode::Specifier::Type(
+                PRIMITIVE_INT,
+                {}
+            ),
+            new AstNode::Expression::Literal(
+                int64_t(UINT16_MAX + 1)
+            )
+        ));
+        fillLiteralPool(UINT16_MAX + 1);
+        EXPECT_THROW(TEST_ANALYZE(ast), SemanticError);
+    }
+
 }
\ No newline at end of file
@@ -18,7 +18,7 @@
 namespace BlsLang {
     class GeneratorTest : public testing::Test {
         public:
-            void INIT(std::vector<TaskDescriptor>& boundTasks, std::unordered_map<BlsType, uint8_t>& literalPool) {
+            void INIT(std::vector<TaskDescriptor>& boundTasks, std::unordered_map<BlsType, uint16_t>& literalPool) {
                 for (auto&& task : boundTasks) {
                     boundTaskMap[task.name].push_back(task);
                 }
@@ -29,8 +29,46 @@ namespace BlsLang {
             void TEST_GENERATE(std::unique_ptr<AstNode>& ast, std::vector<std::unique_ptr<INSTRUCTION>>& expectedInstructions) {
                 ASSERT_TRUE(INIT_FLAG);
                 ast->accept(*generator);
-                ASSERT_EQ(generator->instructions.size(), expectedInstructions.size());
-                for (auto&& [instruction, expectedInstruction] : boost::combine(generator->instructions, expectedInstructions)) {
+                TEST_INSTRUCTIONS(generator->instructions, expectedInstructions);
+            }
+
+            // Appends an instruction as if it was generated
+            void APPEND(std::unique_ptr<INSTRUCTION>&& instruction) {
+                ASSERT_TRUE(INIT_FLAG);
+                generator->instructions.push_back(std::move(instruction));
+            }
+
+            // Pads the program so later addresses are past the narrow range
+            void FILL(size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    APPEND(createRETURN());
+                }
+            }
+
+            void PATCH(size_t position, size_t address) {
+                generator->patchAddress(position, address);
+            }
+
+            // Links a body with relative jump targets after the current instructions
+            void LINK(std::vector<std::unique_ptr<INSTRUCTION>>&& body, std::vector<std::pair<size_t, std::string>>&& callFixups, std::unordered_map<std::string, uint32_t>&& procedureAddresses) {
+                generator->procedureAddresses = std::move(procedureAddresses);
+                Generator::FunctionCode code{std::move(body), std::move(callFixups)};
+                generator->linkFunction(code, generator->instructions.size());
+            }
+
+            // Compares the instructions from position onwards
+            void TEST_TAIL(size_t position, std::vector<std::unique_ptr<INSTRUCTION>>& expectedInstructions) {
+                ASSERT_LE(position, generator->instructions.size());
+                std::vector<std::unique_ptr<INSTRUCTION>> tail;
+                for (size_t i = position; i < generator->instructions.size(); i++) {
+                    tail.push_back(std::move(generator->instructions.at(i)));
+                }
+                TEST_INSTRUCTIONS(tail, expectedInstructions);
+            }
+
+            static void TEST_INSTRUCTIONS(std::vector<std::unique_ptr<INSTRUCTION>>& instructions, std::vector<std::unique_ptr<INSTRUCTION>>& expectedInstructions) {
+                ASSERT_EQ(instructions.size(), expectedInstructions.size());
+                for (auto&& [instruction, expectedInstruction] : boost::combine(instructions, expectedInstructions)) {
                     ASSERT_EQ(instruction->opcode, expectedInstruction->opcode);
                     switch (instruction->opcode) {
                         #define OPCODE_BEGIN(code) \
@@ -26,7 +26,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool;
+        std::unordered_map<BlsType, uint16_t> literalPool;
         
         INIT(taskDescriptors, literalPool);
 
@@ -44,7 +44,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool;
+        std::unordered_map<BlsType, uint16_t> literalPool;
         
         INIT(taskDescriptors, literalPool);
 
@@ -64,7 +64,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"member", 0}
         };
         
@@ -91,7 +91,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {20, 0},
             {30, 1}
         };
@@ -107,6 +107,31 @@ namespace BlsLang {
         TEST_GENERATE(ast, expectedInstructions);
     }
 
+    GROUP_TEST_F(GeneratorTest, ExpressionTests, WideOperands) {
+        auto ast = std::unique_ptr<AstNode>(new AstNode::Expression::Binary(
+            "+",
+            new AstNode::Expression::Access("x", uint16_t(400)),
+            new AstNode::Expression::Literal(
+                int64_t(30)
+            )
+        ));
+
+        std::vector<TaskDescriptor> taskDescriptors;
+        std::unordered_map<BlsType, uint16_t> literalPool = {
+            {30, 300}
+        };
+
+        INIT(taskDescriptors, literalPool);
+
+        std::vector<std::unique_ptr<INSTRUCTION>> expectedInstructions = makeInstructions(
+            createLOAD_W(400),
+            createPUSH_W(300),
+            createADD()
+        );
+
+        TEST_GENERATE(ast, expectedInstructions);
+    }
+
     GROUP_TEST_F(GeneratorTest, ExpressionTests, BinaryLogicalShortCircuit) {
         auto ast = std::unique_ptr<AstNode>(new AstNode::Expression::Binary(
             "||",
@@ -119,7 +144,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0},
             {false, 1}
         };
@@ -160,7 +185,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0},
             {1, 1},
             {2, 2}
@@ -203,7 +228,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {20, 0},
             {30, 1},
             {10, 2}
@@ -235,7 +260,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {30, 0}
         };
         
@@ -263,7 +288,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {30, 0}
         };
         
@@ -300,7 +325,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {30, 0}
         };
         
@@ -337,7 +362,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {30, 0}
         };
         
@@ -382,7 +407,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {0, 0},
             {30, 1},
         };
@@ -432,7 +457,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {false, 0}
         };
         
@@ -458,7 +483,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {false, 0}
         };
         
@@ -483,7 +508,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {1, 0}
         };
         
@@ -511,7 +536,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {1, 0}
         };
         
@@ -534,7 +559,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"string", 0}
         };
         
@@ -566,7 +591,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {2, 0},
             {50, 1},
             {999, 2},
@@ -602,7 +627,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {0, 0},
             {50, 1},
             {999, 2},
@@ -651,7 +676,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"k1", 0},
             {12, 1},
             {"k2", 2},
@@ -698,7 +723,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"k1", 0},
             {12, 1},
             {"k2", 2},
@@ -747,7 +772,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"k1", 0},
             {12, 1},
             {14, 2},
@@ -797,7 +822,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"k1", 0},
             {12, 1},
             {mapLiteral, 2}
@@ -829,7 +854,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool;
+        std::unordered_map<BlsType, uint16_t> literalPool;
         
         INIT(taskDescriptors, literalPool);
 
@@ -855,7 +880,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {int64_t(2), 0}
         };
         
@@ -892,7 +917,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0}
         };
         
@@ -950,7 +975,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0},
             {false, 1}
         };
@@ -1024,7 +1049,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0},
             {false, 1}
         };
@@ -1066,7 +1091,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0}
         };
         
@@ -1103,7 +1128,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0}
         };
         
@@ -1141,7 +1166,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {true, 0}
         };
         
@@ -1178,7 +1203,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool;
+        std::unordered_map<BlsType, uint16_t> literalPool;
         
         INIT(taskDescriptors, literalPool);
 
@@ -1236,7 +1261,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {0, 0},
             {7, 1},
             {1, 2}
@@ -1285,7 +1310,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {std::monostate(), 0}
         };
         
@@ -1339,7 +1364,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {1, 0},
             {"arg2", 1},
             {std::monostate(), 2}
@@ -1406,7 +1431,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {std::monostate(), 0}
         };
         
@@ -1478,7 +1503,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors = {TaskDescriptor("h")};
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {std::monostate(), 0}
         };
         
@@ -1514,7 +1539,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"arg1", 0},
             {100, 1}
         };
@@ -1550,7 +1575,7 @@ namespace BlsLang {
         ));
 
         std::vector<TaskDescriptor> taskDescriptors;
-        std::unordered_map<BlsType, uint8_t> literalPool = {
+        std::unordered_map<BlsType, uint16_t> literalPool = {
             {"key", 0}
         };
         
@@ -1566,4 +1591,50 @@ namespace BlsLang {
         TEST_GENERATE(ast, expectedInstructions);
     }
 
+    GROUP_TEST_F(GeneratorTest, LinkingTests, PatchedJumpsWiden) {
+        std::vector<TaskDescriptor> taskDescriptors;
+        std::unordered_map<BlsType, uint16_t> literalPool;
+        INIT(taskDescriptors, literalPool);
+
+        APPEND(createBRANCH(0));
+        APPEND(createJMPSC_OR(0));
+        APPEND(createJMP(0));
+        PATCH(0, UINT16_MAX + 1);
+        PATCH(1, UINT16_MAX);
+        PATCH(2, 70000);
+        // widened jumps are patched in place
+        PATCH(2, 80000);
+
+        std::vector<std::unique_ptr<INSTRUCTION>> expectedInstructions = makeInstructions(
+            createBRANCH_W(UINT16_MAX + 1),
+            createJMPSC_OR(UINT16_MAX),
+            createJMP_W(80000)
+        );
+
+        TEST_TAIL(0, expectedInstructions);
+    }
+
+    GROUP_TEST_F(GeneratorTest, LinkingTests, LinkedBodiesWidenJumpsAndCalls) {
+        std::vector<TaskDescriptor> taskDescriptors;
+        std::unordered_map<BlsType, uint16_t> literalPool;
+        INIT(taskDescriptors, literalPool);
+
+        // the body is linked close enough to the narrow limit that only some targets cross it
+        FILL(UINT16_MAX - 3);
+        LINK(makeInstructions(
+            createJMPSC_AND(1),
+            createBRANCH(10),
+            createCALL(0, 2),
+            createCALL(0, 1)
+        ), {{2, "far"}, {3, "near"}}, {{"far", 70000}, {"near", 12}});
+
+        std::vector<std::unique_ptr<INSTRUCTION>> expectedInstructions = makeInstructions(
+            createJMPSC_AND(UINT16_MAX - 2),
+            createBRANCH_W(UINT16_MAX + 7),
+            createCALL_W(70000, 2),
+            createCALL(12, 1)
+        );
+
+        TEST_TAIL(UINT16_MAX - 3, expectedInstructions);
+    }
 }
\ No newline at end of file
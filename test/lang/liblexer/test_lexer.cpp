@@ -702,4 +702,28 @@ namespace BlsLang {
         TEST_LEX(test_str, exp_tokens);
     }
 
+    // Mode Tests
+    GROUP_TEST_F(LexerTest, ModeTests, TableMatchesStream) {
+        std::string test_str = "task foo(a, b) {\n"
+                               "    // comment\n"
+                               "    a = 0x1F + 0b101 + 017 + 1.5e;\n"
+                               "    /* multi\n line */ b += \"str\\n\\\"\";\n"
+                               "    if (a <= b && !b || a-- != ++b) {}\n"
+                               "}\n";
+        Lexer streamLexer(Lexer::Mode::STREAM);
+        Lexer tableLexer(Lexer::Mode::TABLE);
+        EXPECT_EQ(tableLexer.lex(test_str), streamLexer.lex(test_str));
+    }
+
+    GROUP_TEST_F(LexerTest, ModeTests, ViewReferencesSource) {
+        std::string test_str = R"(someText = "value";)";
+        Lexer lexer;
+        auto tokens = lexer.lexView(test_str);
+        ASSERT_EQ(tokens.size(), 4);
+        EXPECT_EQ(tokens[0].getLiteral(), "someText");
+        EXPECT_EQ(tokens[0].getLiteral().data(), test_str.data());
+        EXPECT_EQ(tokens[2], TokenView(Token::Type::STRING, std::string_view(test_str).substr(11, 7), 11, 1, 12, 1, 19));
+        EXPECT_EQ(tokens[2].toToken(), Token(Token::Type::STRING, R"("value")", 11, 1, 12, 1, 19));
+    }
+
 }
\ No newline at end of file
@@ -1,3 +1,172 @@
+#include "EM.hpp"
+#include "Executor.hpp"
+#include "Scheduler.hpp"
+#include "Serialization.hpp"
+#include "TSQ.hpp"
+#include "bls_types.hpp"
+#include "compiler.hpp"
+#include "task_fusion.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace {
+    BlsType& attribute(BlsType& state, const std::string& name) {
+        return std::get<std::shared_ptr<HeapDescriptor>>(state)->access(BlsType(name));
+    }
+}
+
+// Runs a fused unit and checks each member wrote (and pushed) its own out device
+TEST(ExecutionUnitTest, FusedUnitRunsEveryMember) {
+    const std::string source = R"(
+        task twice(TIMER_TEST value, TIMER_TEST doubled) : triggerOn(value) {
+            doubled.test_val = value.test_val * 2;
+            push(doubled);
+        }
+
+        task square(TIMER_TEST value, TIMER_TEST squared) : triggerOn(value) {
+            squared.test_val = value.test_val * value.test_val;
+            push(squared);
+        }
+
+        setup() {
+            TIMER_TEST value = "CTL::PWR-0";
+            TIMER_TEST doubled = "CTL::PWR-1";
+            TIMER_TEST squared = "CTL::PWR-2";
+            twice(value, doubled);
+            square(value, squared);
+        }
+    )";
+    BlsLang::Compiler compiler;
+    std::vector<char> bytecode;
+    compiler.compileSource(source, bytecode);
+    auto tasks = BlsLang::fuseTasks(compiler.getTaskDescriptors(), compiler.getGlobalContext());
+    ASSERT_EQ(tasks.size(), 1);
+    auto& fused = tasks.at(0);
+    ASSERT_EQ(fused.fusedTasks.size(), 2);
+
+    std::vector<std::string> devices;
+    std::vector<bool> isVtype;
+    std::vector<std::string> controllers;
+    for (auto& device : fused.binded_devices) {
+        devices.push_back(device.device_name);
+        isVtype.push_back(device.isVtype);
+        controllers.push_back(device.controller);
+    }
+    ASSERT_EQ(devices, std::vector<std::string>({"value", "doubled", "squared"}));
+
+    TSQ<HeapMasterMessage> sendMM;
+    DeviceScheduler scheduler(tasks, [](HeapMasterMessage) {});
+    asio::io_context ctx;
+    // Pool mode so the unit does not start its own execution thread
+    WorkStealingPool executor(1);
+    ExecutionUnit unit(fused, devices, isVtype, controllers, sendMM, fused.bytecode_offset, bytecode, scheduler, ctx, &executor);
+
+    std::unordered_map<DeviceID, HeapMasterMessage> received;
+    auto states = unit.loadStates(received);
+    attribute(states.at(0), "test_val") = 3.0;
+    unit.runTask(states);
+
+    EXPECT_EQ(attribute(states.at(1), "test_val"), BlsType(6.0));
+    EXPECT_EQ(attribute(states.at(2), "test_val"), BlsType(9.0));
+
+    // Pushes resolve the member's parameter index to the fused device position
+    ASSERT_EQ(sendMM.getSize(), 2);
+    auto first = sendMM.read();
+    auto second = sendMM.read();
+    EXPECT_EQ(first.info.device, "doubled");
+    EXPECT_EQ(second.info.device, "squared");
+    EXPECT_EQ(attribute(second.heapTree, "test_val"), BlsType(9.0));
+}
+
+// A deferred task skips ownership when its first run writes nothing and otherwise reruns under ownership
+TEST(ExecutionUnitTest, DeferredOwnershipSkipsRunsWithoutWrites) {
+    const std::string source = R"(
+        task threshold(TIMER_TEST sensor, TIMER_TEST alarm) : triggerOn(sensor) {
+            if (sensor.test_val > 10) {
+                alarm.test_val = sensor.test_val;
+            }
+        }
+
+        setup() {
+            TIMER_TEST sensor = "CTL::PWR-0";
+            TIMER_TEST alarm = "CTL::PWR-1";
+            threshold(sensor, alarm);
+        }
+    )";
+    BlsLang::Compiler compiler;
+    std::vector<char> bytecode;
+    compiler.compileSource(source, bytecode);
+    auto tasks = compiler.getTaskDescriptors();
+    ASSERT_EQ(tasks.size(), 1);
+    auto& task = tasks.at(0);
+    task.inDevices = {task.binded_devices.at(0)};
+    task.outDevices = {task.binded_devices.at(1)};
+    task.deferOwnership = true;
+
+    TSQ<HeapMasterMessage> sendMM;
+    // alarm is leased to its sole writer, so requests conclude without waiting for a grant
+    DeviceScheduler scheduler(tasks, [&sendMM](HeapMasterMessage hmm) { sendMM.write(hmm); }, true);
+    asio::io_context ctx;
+    WorkStealingPool executor(1);
+    ExecutionUnit unit(task, {"sensor", "alarm"}, {true, true}, {"MASTER", "MASTER"}, sendMM, task.bytecode_offset, bytecode, scheduler, ctx, &executor);
+
+    auto activate = [&](double value) {
+        HeapMasterMessage sensor;
+        sensor.info.device = "sensor";
+        sensor.info.task = task.name;
+        sensor.protocol = PROTOCOLS::SENDSTATES;
+        sensor.heapTree = std::get<std::shared_ptr<HeapDescriptor>>(task.binded_devices.at(0).initialValue)->clone();
+        attribute(sensor.heapTree, "test_val") = value;
+        EMStateMessage ems;
+        ems.dmm_list = {sensor};
+        ems.priority = 1;
+        ems.protocol = PROTOCOLS::SENDSTATES;
+        ems.taskName = task.name;
+        unit.execute(ems);
+
+        std::vector<HeapMasterMessage> sent;
+        while (!sendMM.isEmpty()) {
+            sent.push_back(sendMM.read());
+        }
+        return sent;
+    };
+    auto protocols = [](const std::vector<HeapMasterMessage>& sent) {
+        std::vector<PROTOCOLS> result;
+        for (auto& hmm : sent) {
+            result.push_back(hmm.protocol);
+        }
+        return result;
+    };
+
+    auto skipped = activate(5.0);
+    EXPECT_EQ(protocols(skipped), std::vector<PROTOCOLS>({
+        PROTOCOLS::PROCESS_EXEC, PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE, PROTOCOLS::OWNER_RELEASE_NULL
+    }));
+
+    // The box is not released between the first run and the request, so no state can trigger the task in between
+    auto written = activate(20.0);
+    EXPECT_EQ(protocols(written), std::vector<PROTOCOLS>({
+        PROTOCOLS::PROCESS_EXEC, PROTOCOLS::OWNER_CANDIDATE_REQUEST_CONCLUDE,
+        PROTOCOLS::PROCESS_EXEC, PROTOCOLS::OWNER_RELEASE_NULL, PROTOCOLS::SENDSTATES
+    }));
+    ASSERT_EQ(written.back().info.device, "alarm");
+    EXPECT_EQ(attribute(written.back().heapTree, "test_val"), BlsType(20.0));
+
+    // A state forwarded while ownership is acquired makes the run repeat with it
+    HeapMasterMessage fresh;
+    fresh.info.device = "sensor";
+    fresh.heapTree = std::get<std::shared_ptr<HeapDescriptor>>(task.binded_devices.at(0).initialValue)->clone();
+    attribute(fresh.heapTree, "test_val") = 30.0;
+    unit.replacementCache.insert("sensor", fresh);
+    auto rerun = activate(20.0);
+    ASSERT_EQ(rerun.back().info.device, "alarm");
+    EXPECT_EQ(attribute(rerun.back().heapTree, "test_val"), BlsType(30.0));
+}
+
 // #include "EM.hpp"
 // #include "DynamicMessage.hpp"
 //#include "HeapDescriptors.hpp"
@@ -237,4 +237,307 @@
 //     }
     
 //     EXPECT_TRUE(readNM.isEmpty());
-// }
\ No newline at end of file
+// }
+
+#include "MM.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <set>
+#include <sstream>
+
+namespace {
+    TaskDescriptor makeTriggerTask(int deviceCount, std::vector<TriggerData> triggers = {}){
+        TaskDescriptor desc; 
+        desc.name = "trigger_task"; 
+        for(int i = 0; i < deviceCount; i++){
+            DeviceDescriptor dev; 
+            dev.device_name = "dev" + std::to_string(i); 
+            desc.binded_devices.push_back(dev); 
+        }
+        desc.triggers = triggers; 
+        return desc; 
+    }
+
+    void fillInitial(TriggerManager& manager, int deviceCount){
+        int id = -2; 
+        for(int i = 0; i < deviceCount; i++){
+            std::string dev = "dev" + std::to_string(i); 
+            manager.processDevice(dev, id); 
+        }
+        ASSERT_EQ(id, -1); 
+    }
+}
+
+TEST(TriggerManagerTest, InitialTriggerAfterAllDevices)
+{
+    auto desc = makeTriggerTask(3); 
+    TriggerManager manager(desc); 
+    int id = -2; 
+    std::string d0 = "dev0", d1 = "dev1", d2 = "dev2"; 
+    EXPECT_FALSE(manager.processDevice(d0, id)); 
+    EXPECT_FALSE(manager.processDevice(d0, id)); 
+    EXPECT_FALSE(manager.processDevice(d1, id)); 
+    EXPECT_TRUE(manager.processDevice(d2, id)); 
+    EXPECT_EQ(id, -1); 
+}
+
+TEST(TriggerManagerTest, HighestPriorityRuleWins)
+{
+    auto desc = makeTriggerTask(3, {{{"dev0"}, "low", 1}, {{"dev0", "dev1"}, "high", 5}}); 
+    TriggerManager manager(desc); 
+    fillInitial(manager, 3); 
+
+    int id = -2; 
+    std::string d0 = "dev0", d1 = "dev1", d2 = "dev2"; 
+    EXPECT_FALSE(manager.processDevice(d1, id)); 
+    EXPECT_TRUE(manager.processDevice(d0, id)); 
+    EXPECT_EQ(id, 1); 
+
+    // Arrivals of devices outside every rule only fire the default rule
+    id = -2; 
+    EXPECT_FALSE(manager.processDevice(d2, id)); 
+    EXPECT_EQ(id, -2); 
+}
+
+TEST(TriggerManagerTest, DisabledTriggerIsSkipped)
+{
+    auto desc = makeTriggerTask(2, {{{"dev0"}, "first", 1}, {{"dev1"}, "second", 1}}); 
+    TriggerManager manager(desc); 
+    fillInitial(manager, 2); 
+
+    std::string first = "first"; 
+    std::string d0 = "dev0", d1 = "dev1"; 
+    manager.disableTrigger(first); 
+    int id = -2; 
+    EXPECT_FALSE(manager.processDevice(d0, id)); 
+    EXPECT_TRUE(manager.processDevice(d1, id)); 
+    EXPECT_EQ(id, 1); 
+
+    manager.enableTrigger(first); 
+    id = -2; 
+    EXPECT_TRUE(manager.processDevice(d0, id)); 
+    EXPECT_EQ(id, 0); 
+}
+
+TEST(TriggerManagerTest, SupportsMoreThan32Devices)
+{
+    auto desc = makeTriggerTask(70, {{{"dev3", "dev68"}, "wide", 2}}); 
+    TriggerManager manager(desc); 
+    fillInitial(manager, 70); 
+
+    int id = -2; 
+    std::string d3 = "dev3", d68 = "dev68"; 
+    EXPECT_FALSE(manager.processDevice(d68, id)); 
+    EXPECT_TRUE(manager.processDevice(d3, id)); 
+    EXPECT_EQ(id, 0); 
+}
+
+namespace {
+    // Builds a single device reader box where every state arrival triggers the task
+    std::unique_ptr<ReaderBox> makeCoalescingBox(TaskDescriptor& desc, TriggerGroup& group, TSQ<EMStateMessage>& sendEM){
+        auto box = std::make_unique<ReaderBox>(desc.name, desc, group, sendEM); 
+        auto& db = box->waitingQs["dev0"]; 
+        db.stateQueues = std::make_shared<TSQ<HeapMasterMessage>>(); 
+        db.deviceName = "dev0"; 
+        box->pending_requests = true; 
+        return box; 
+    }
+
+    void insertValue(ReaderBox& box, int64_t value){
+        HeapMasterMessage hmm; 
+        hmm.info.device = "dev0"; 
+        hmm.heapTree = value; 
+        box.insertState(hmm); 
+    }
+
+    std::vector<int64_t> drainValues(ReaderBox& box, TSQ<EMStateMessage>& sendEM){
+        box.handleRequest(); 
+        std::vector<int64_t> values; 
+        while(auto ems = sendEM.pop()){
+            values.push_back(std::get<int64_t>(ems->dmm_list.at(0).heapTree)); 
+        }
+        return values; 
+    }
+}
+
+TEST(ReaderBoxTest, LatestWinsCoalesces)
+{
+    auto desc = makeTriggerTask(1); 
+    desc.coalescePolicy = COALESCE_POLICY::LATEST; 
+    TriggerGroup group; 
+    TSQ<EMStateMessage> sendEM; 
+    auto box = makeCoalescingBox(desc, group, sendEM); 
+
+    for(int64_t i = 0; i < 5; i++){
+        insertValue(*box, i); 
+    }
+
+    EXPECT_EQ(drainValues(*box, sendEM), std::vector<int64_t>({4})); 
+    EXPECT_EQ(box->coalescedEvents, 4); 
+    EXPECT_EQ(box->droppedEvents, 0); 
+}
+
+TEST(ReaderBoxTest, BoundedFifoRejectsNewest)
+{
+    auto desc = makeTriggerTask(1); 
+    desc.coalescePolicy = COALESCE_POLICY::FIFO; 
+    desc.coalesceDepth = 3; 
+    TriggerGroup group; 
+    TSQ<EMStateMessage> sendEM; 
+    auto box = makeCoalescingBox(desc, group, sendEM); 
+
+    for(int64_t i = 0; i < 5; i++){
+        insertValue(*box, i); 
+    }
+
+    EXPECT_EQ(drainValues(*box, sendEM), std::vector<int64_t>({0, 1, 2})); 
+    EXPECT_EQ(box->droppedEvents, 2); 
+}
+
+TEST(ReaderBoxTest, DropOldestKeepsNewest)
+{
+    auto desc = makeTriggerTask(1); 
+    desc.coalescePolicy = COALESCE_POLICY::DROP_OLDEST; 
+    desc.coalesceDepth = 3; 
+    TriggerGroup group; 
+    TSQ<EMStateMessage> sendEM; 
+    auto box = makeCoalescingBox(desc, group, sendEM); 
+
+    for(int64_t i = 0; i < 5; i++){
+        insertValue(*box, i); 
+    }
+
+    EXPECT_EQ(drainValues(*box, sendEM), std::vector<int64_t>({2, 3, 4})); 
+    EXPECT_EQ(box->droppedEvents, 2); 
+}
+
+TEST(ReaderBoxTest, CountsDroppedEvents)
+{
+    auto desc = makeTriggerTask(1); 
+    desc.coalescePolicy = COALESCE_POLICY::FIFO; 
+    desc.coalesceDepth = 1; 
+    TriggerGroup group; 
+    TSQ<EMStateMessage> sendEM; 
+    auto box = makeCoalescingBox(desc, group, sendEM); 
+
+    auto& tracer = LatencyTracer::instance(); 
+    uint64_t droppedBefore = tracer.getCounter(TraceCounter::DROPPED_EVENTS); 
+    testing::internal::CaptureStdout(); 
+    for(int64_t i = 0; i < 6; i++){
+        insertValue(*box, i); 
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), ""); 
+
+    // The counters are reported with the --trace histograms
+    EXPECT_EQ(box->droppedEvents, 5); 
+    EXPECT_EQ(tracer.getCounter(TraceCounter::DROPPED_EVENTS) - droppedBefore, 5); 
+    std::ostringstream report; 
+    tracer.dump(report, "master"); 
+    EXPECT_NE(report.str().find("dropped events"), std::string::npos); 
+}
+
+TEST(ReaderBoxTest, DroppedEventDoesNotScheduleTask)
+{
+    auto desc = makeTriggerTask(1); 
+    desc.coalescePolicy = COALESCE_POLICY::FIFO; 
+    desc.coalesceDepth = 1; 
+    TriggerGroup group; 
+    TSQ<EMStateMessage> sendEM; 
+    auto box = makeCoalescingBox(desc, group, sendEM); 
+
+    insertValue(*box, 0); 
+    EXPECT_TRUE(group.conclude(desc.name)); 
+
+    // The cache is full, so the event is dropped and the task stays out of the trigger group
+    group.insert("other"); 
+    insertValue(*box, 1); 
+    EXPECT_EQ(box->droppedEvents, 1); 
+    EXPECT_TRUE(group.conclude("other")); 
+}
+
+namespace {
+    // Tasks that each read the same device
+    std::vector<TaskDescriptor> makeSharedTasks(const std::vector<std::string>& names){
+        std::vector<TaskDescriptor> tasks; 
+        for(auto& name : names){
+            auto desc = makeTriggerTask(1); 
+            desc.name = name; 
+            desc.binded_devices.front().device_name = "shared"; 
+            tasks.push_back(desc); 
+        }
+        return tasks; 
+    }
+
+    HeapMasterMessage sharedState(const std::string& task, int64_t value){
+        HeapMasterMessage hmm; 
+        hmm.info.device = "shared"; 
+        hmm.info.task = task; 
+        hmm.heapTree = value; 
+        return hmm; 
+    }
+}
+
+TEST(ShardedMailboxTest, KeepsTaskOrder)
+{
+    TSQ<DynamicMasterMessage> readNM, sendNM; 
+    TSQ<HeapMasterMessage> readEM; 
+    TSQ<EMStateMessage> sendEM; 
+    MasterMailbox mailbox(makeSharedTasks({"reader"}), readNM, readEM, sendNM, sendEM, 4); 
+    mailbox.taskReadMap.at("reader")->pending_requests = true; 
+
+    for(int64_t i = 0; i < 50; i++){
+        std::vector<std::pair<TaskID, HeapMasterMessage>> states{{"reader", sharedState("reader", i)}}; 
+        mailbox.dispatchStates(states); 
+    }
+    mailbox.shardPool->join(); 
+
+    std::vector<int64_t> values; 
+    while(auto ems = sendEM.pop()){
+        values.push_back(std::get<int64_t>(ems->dmm_list.at(0).heapTree)); 
+    }
+    ASSERT_EQ(values.size(), 50); 
+    for(int64_t i = 0; i < 50; i++){
+        EXPECT_EQ(values[i], i); 
+    }
+}
+
+TEST(ShardedMailboxTest, FanOutDoesNotWaitForBusyShard)
+{
+    TSQ<DynamicMasterMessage> readNM, sendNM; 
+    TSQ<HeapMasterMessage> readEM; 
+    TSQ<EMStateMessage> sendEM; 
+    std::vector<std::string> names{"first", "second", "third"}; 
+    MasterMailbox mailbox(makeSharedTasks(names), readNM, readEM, sendNM, sendEM, 2); 
+    for(auto& name : names){
+        mailbox.taskReadMap.at(name)->pending_requests = true; 
+    }
+
+    // Keeps the strand of the first task busy while the interrupt fans out
+    std::promise<void> release; 
+    boost::asio::post(mailbox.taskStrands.at("first"), [busy = release.get_future().share()](){
+        busy.wait(); 
+    }); 
+
+    std::vector<std::pair<TaskID, HeapMasterMessage>> states; 
+    for(auto& name : names){
+        states.emplace_back(name, sharedState(name, 7)); 
+    }
+    auto dispatched = std::async(std::launch::async, [&](){
+        mailbox.dispatchStates(states); 
+    }); 
+    EXPECT_EQ(dispatched.wait_for(std::chrono::seconds(1)), std::future_status::ready); 
+
+    // No task requests the event before every task joined the trigger group
+    EXPECT_TRUE(sendEM.isEmpty()); 
+    release.set_value(); 
+    dispatched.get(); 
+    mailbox.shardPool->join(); 
+
+    std::set<std::string> received; 
+    while(auto ems = sendEM.pop()){
+        EXPECT_EQ(std::get<int64_t>(ems->dmm_list.at(0).heapTree), 7); 
+        received.insert(ems->taskName); 
+    }
+    EXPECT_EQ(received, std::set<std::string>(names.begin(), names.end())); 
+}
@@ -0,0 +1,155 @@
+#include "Ticker.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TickerTest : public ::testing::Test
+{
+protected:
+    std::string ctl = "ctl";
+    std::unordered_map<std::string, uint16_t> devNames = {{"sensor", 1}, {"button", 2}, {"fixed", 3}, {"probe", 4}};
+
+    DeviceDescriptor makeDevice(std::string name, DeviceKind kind = DeviceKind::POLLING) {
+        DeviceDescriptor dev;
+        dev.device_name = name;
+        dev.controller = ctl;
+        dev.deviceKind = kind;
+        return dev;
+    }
+
+    std::vector<TaskDescriptor> makeTasks() {
+        TaskDescriptor task;
+        task.name = "task";
+        auto fixed = makeDevice("fixed");
+        fixed.polling_period = 250;
+        fixed.isConst = true;
+        task.binded_devices = {makeDevice("sensor"), makeDevice("button", DeviceKind::INTERRUPT), fixed};
+        task.pollConditions = {{"sensor", "temperature", 30}, {"fixed", "temperature", 30}};
+        return {task};
+    }
+
+    void report(MTicker& ticker, double temperature, float volatility) {
+        std::string device = "sensor";
+        std::unordered_map<AttrAlias, float> vol = {{"temperature", volatility}};
+        std::unordered_map<AttrAlias, double> values = {{"temperature", temperature}};
+        ticker.updateVolH(device, vol);
+        ticker.updateConditions(device, values);
+    }
+
+    std::vector<Timer> update(MTicker& ticker) {
+        std::vector<Timer> timers;
+        ticker.sendTicker(timers, ctl, devNames);
+        return timers;
+    }
+};
+
+TEST_F(TickerTest, InitialTimers_Test)
+{
+    auto tasks = makeTasks();
+    MTicker ticker(tasks);
+    std::vector<Timer> timers;
+    ticker.sendInitial(timers, ctl, devNames);
+
+    // interrupt devices are not given a dynamic timer
+    ASSERT_EQ(timers.size(), 2);
+    for (auto& timer : timers) {
+        if (timer.device_num == 1) {
+            EXPECT_FALSE(timer.const_poll);
+            EXPECT_EQ(timer.period, 500);
+        }
+        else {
+            EXPECT_EQ(timer.device_num, 3);
+            EXPECT_TRUE(timer.const_poll);
+            EXPECT_EQ(timer.period, 250);
+        }
+    }
+    EXPECT_TRUE(update(ticker).empty());
+}
+
+TEST_F(TickerTest, PeriodFollowsConditionDistance_Test)
+{
+    auto tasks = makeTasks();
+    MTicker ticker(tasks);
+
+    // three deviations away the condition is unlikely to flip
+    report(ticker, 27, 1);
+    auto timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].device_num, 1);
+    EXPECT_EQ(timers[0].period, 1000);
+
+    // on the threshold the device is polled at the maximum rate
+    report(ticker, 30, 1);
+    timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].period, 10);
+
+    // one deviation away flips about a third of the time
+    report(ticker, 31, 1);
+    timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].period, 30);
+}
+
+TEST_F(TickerTest, UpdatesOnlyChangedPeriods_Test)
+{
+    auto tasks = makeTasks();
+    MTicker ticker(tasks);
+
+    report(ticker, 30, 1);
+    EXPECT_EQ(update(ticker).size(), 1);
+    EXPECT_TRUE(update(ticker).empty());
+
+    // the same state does not resend the period
+    report(ticker, 30, 1);
+    EXPECT_TRUE(update(ticker).empty());
+}
+
+TEST_F(TickerTest, FlatAttribute_Test)
+{
+    auto tasks = makeTasks();
+    MTicker ticker(tasks);
+
+    report(ticker, 20, 0);
+    auto timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].period, 1000);
+
+    report(ticker, 30, 0);
+    timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].period, 10);
+}
+
+// A reload gives newly polled devices a timer and reuses the timers of the others
+TEST_F(TickerTest, ReloadAddsMissingTimers_Test)
+{
+    auto tasks = makeTasks();
+    MTicker ticker(tasks);
+    std::vector<Timer> initial;
+    ticker.sendInitial(initial, ctl, devNames);
+
+    TaskDescriptor other;
+    other.name = "other";
+    auto fixed = makeDevice("fixed");
+    fixed.polling_period = 250;
+    fixed.isConst = true;
+    other.binded_devices = {makeDevice("probe"), makeDevice("sensor"), fixed};
+    tasks.push_back(other);
+    ticker.setConditions(tasks);
+
+    auto timers = update(ticker);
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_EQ(timers[0].device_num, 4);
+    EXPECT_FALSE(timers[0].const_poll);
+    EXPECT_EQ(timers[0].period, 500);
+    for (auto& timer : initial) {
+        EXPECT_NE(timer.id, timers[0].id);
+        auto timerTasks = ticker.getTasks(timer.id);
+        EXPECT_EQ(timerTasks, (std::vector<TaskAlias>{"task", "other"}));
+    }
+
+    ticker.setConditions(tasks);
+    EXPECT_TRUE(update(ticker).empty());
+}